@@ -3,21 +3,21 @@ LOCAL_PATH:= $(call my-dir)
 ifneq ($(filter jet,$(TARGET_DEVICE)),)
 
 include $(CLEAR_VARS)
-LOCAL_SRC_FILES:= aplay.c alsa_pcm.c alsa_mixer.c
+LOCAL_SRC_FILES:= aplay.c alsa_pcm.c alsa_mixer.c alsa_backend.c alsa_sim.c
 LOCAL_MODULE:= aplay
 LOCAL_SHARED_LIBRARIES:= libc libcutils
 LOCAL_MODULE_TAGS:= debug
 include $(BUILD_EXECUTABLE)
 
 include $(CLEAR_VARS)
-LOCAL_SRC_FILES:= arec.c alsa_pcm.c
+LOCAL_SRC_FILES:= arec.c alsa_pcm.c alsa_backend.c alsa_sim.c
 LOCAL_MODULE:= arec
 LOCAL_SHARED_LIBRARIES:= libc libcutils
 LOCAL_MODULE_TAGS:= debug
 include $(BUILD_EXECUTABLE)
 
 include $(CLEAR_VARS)
-LOCAL_SRC_FILES:= amix.c alsa_mixer.c
+LOCAL_SRC_FILES:= amix.c alsa_mixer.c alsa_backend.c alsa_sim.c
 LOCAL_MODULE:= amix
 LOCAL_SHARED_LIBRARIES := libc libcutils
 LOCAL_MODULE_TAGS:= debug
@@ -25,7 +25,7 @@ include $(BUILD_EXECUTABLE)
 
 include $(CLEAR_VARS)
 LOCAL_ARM_MODE:= arm
-LOCAL_SRC_FILES:= AudioHardware.cpp alsa_mixer.c alsa_pcm.c
+LOCAL_SRC_FILES:= AudioHardware.cpp AudioDsp.cpp alsa_mixer.c alsa_pcm.c alsa_backend.c alsa_sim.c
 LOCAL_MODULE:= libaudio
 LOCAL_STATIC_LIBRARIES:= libaudiointerface
 LOCAL_SHARED_LIBRARIES:= libc libcutils libutils libmedia libhardware_legacy
@@ -33,8 +33,14 @@ ifeq ($(BOARD_HAVE_BLUETOOTH),true)
   LOCAL_SHARED_LIBRARIES += liba2dp
 endif
 
+ifeq ($(TARGET_ARCH_VARIANT),armv6-vfp)
+  LOCAL_CFLAGS += -DAUDIO_ARMV6_DSP=1
+endif
+
 ifeq ($(TARGET_SIMULATOR),true)
  LOCAL_LDLIBS += -ldl
+ # no sound card on the host: run on the simulated one
+ LOCAL_CFLAGS += -DALSA_DEFAULT_BACKEND_SIM
 else
  LOCAL_SHARED_LIBRARIES += libdl
 endif
@@ -51,4 +57,6 @@ ifeq ($(BOARD_HAVE_BLUETOOTH),true)
 endif
 include $(BUILD_SHARED_LIBRARY)
 
+include $(call all-makefiles-under,$(LOCAL_PATH))
+
 endif
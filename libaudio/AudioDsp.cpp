@@ -0,0 +1,840 @@
+/*
+** Copyright 2010, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#include <math.h>
+#include <string.h>
+
+//#define LOG_NDEBUG 0
+
+#define LOG_TAG "AudioHardware"
+
+#include <utils/Log.h>
+#include <utils/String8.h>
+
+#include "AudioHardware.h"
+#include "AudioDsp.h"
+
+namespace android {
+
+//------------------------------------------------------------------------------
+//  DownSampler
+//------------------------------------------------------------------------------
+
+/*
+ * Convolution of signals A and reverse(B). (In our case, the filter response
+ * is symmetric, so the reversing doesn't matter.)
+ * A is taken to be in 0.16 fixed-point, and B is taken to be in 2.14 fixed-point.
+ * The answer will be in 16.16 fixed-point, unclipped.
+ *
+ * This is the portable reference implementation; fir_convolve() resolves to
+ * it unless an optimized version is selected at build time, and any optimized
+ * version must produce bit-identical results.
+ */
+int32_t fir_convolve_c(const int16_t* a, const int16_t* b, int num_samples)
+{
+        int32_t sum = 1 << 13;
+        for (int i = 0; i < num_samples; ++i) {
+                sum += a[i] * b[i];
+        }
+        return sum >> 14;
+}
+
+/*
+ * Stereo version of fir_convolve_c(): A holds num_frames interleaved stereo
+ * frames and both channels are convolved with the same coefficients B in a
+ * single pass. Results are returned in left and right.
+ */
+void fir_convolve_stereo_c(const int16_t* a, const int16_t* b, int num_frames,
+                           int32_t* left, int32_t* right)
+{
+        int32_t suml = 1 << 13;
+        int32_t sumr = 1 << 13;
+        for (int i = 0; i < num_frames; ++i) {
+                suml += a[i * 2] * b[i];
+                sumr += a[i * 2 + 1] * b[i];
+        }
+        *left = suml >> 14;
+        *right = sumr >> 14;
+}
+
+#ifdef AUDIO_ARMV6_DSP
+typedef int32_t __attribute__((__may_alias__)) int16x2_t;
+
+/*
+ * ARMv6 instructions used by the _armv6 kernels. Off ARM they are emulated
+ * in C, so that the kernels can be checked against the portable versions by
+ * the host tests; only the ARM build selects them.
+ */
+#ifdef __arm__
+static inline int32_t smlad(int32_t a, int32_t b, int32_t acc)
+{
+    int32_t out;
+    asm ("smlad %0, %1, %2, %3" : "=r" (out) : "r" (a), "r" (b), "r" (acc));
+    return out;
+}
+
+#define SMLAXY(xy) \
+static inline int32_t smla##xy(int32_t a, int32_t b, int32_t acc) \
+{ \
+    int32_t out; \
+    asm ("smla" #xy " %0, %1, %2, %3" : "=r" (out) : "r" (a), "r" (b), "r" (acc)); \
+    return out; \
+}
+SMLAXY(bb)
+SMLAXY(bt)
+SMLAXY(tb)
+SMLAXY(tt)
+
+static inline int32_t ssat16(int32_t x)
+{
+    int32_t out;
+    asm ("ssat %0, #16, %1" : "=r" (out) : "r" (x));
+    return out;
+}
+
+static inline int32_t ssat16_asr14(int32_t x)
+{
+    int32_t out;
+    asm ("ssat %0, #16, %1, asr #14" : "=r" (out) : "r" (x));
+    return out;
+}
+
+static inline int32_t qadd16(int32_t a, int32_t b)
+{
+    int32_t out;
+    asm ("qadd16 %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
+    return out;
+}
+#else
+#define BOTTOM(x) ((int32_t)(int16_t)(x))
+#define TOP(x) ((x) >> 16)
+
+// the accumulations wrap around like the instructions do
+static inline int32_t smlad(int32_t a, int32_t b, int32_t acc)
+{
+    return (int32_t)((uint32_t)acc + (uint32_t)(BOTTOM(a) * BOTTOM(b)) +
+                     (uint32_t)(TOP(a) * TOP(b)));
+}
+
+#define SMLAXY(xy, x, y) \
+static inline int32_t smla##xy(int32_t a, int32_t b, int32_t acc) \
+{ \
+    return (int32_t)((uint32_t)acc + (uint32_t)(x(a) * y(b))); \
+}
+SMLAXY(bb, BOTTOM, BOTTOM)
+SMLAXY(bt, BOTTOM, TOP)
+SMLAXY(tb, TOP, BOTTOM)
+SMLAXY(tt, TOP, TOP)
+
+static inline int32_t ssat16(int32_t x)
+{
+    return clip(x);
+}
+
+static inline int32_t ssat16_asr14(int32_t x)
+{
+    return clip(x >> 14);
+}
+
+static inline int32_t qadd16(int32_t a, int32_t b)
+{
+    int32_t l = clip(BOTTOM(a) + BOTTOM(b));
+    int32_t r = clip(TOP(a) + TOP(b));
+    return (l & 0xffff) | ((uint32_t)r << 16);
+}
+#endif
+
+/*
+ * ARMv6 version of fir_convolve_c() using the SMLAD dual 16-bit
+ * multiply-accumulate. A and B must be 32-bit aligned and num_samples must
+ * be even.
+ */
+int32_t fir_convolve_armv6(const int16_t* a, const int16_t* b, int num_samples)
+{
+    const int16x2_t *a2 = (const int16x2_t *)a;
+    const int16x2_t *b2 = (const int16x2_t *)b;
+    int32_t sum0 = 1 << 13;
+    int32_t sum1 = 0;
+    int i;
+
+    for (i = 0; i + 4 <= num_samples; i += 4, a2 += 2, b2 += 2) {
+        sum0 = smlad(a2[0], b2[0], sum0);
+        sum1 = smlad(a2[1], b2[1], sum1);
+    }
+    if (i < num_samples) {
+        sum0 = smlad(a2[0], b2[0], sum0);
+    }
+    return (sum0 + sum1) >> 14;
+}
+
+/*
+ * ARMv6 version of fir_convolve_stereo_c(). Each 32-bit load fetches a full
+ * stereo frame or a pair of coefficients, and every coefficient pair is
+ * applied to both channels of two frames. A and B must be 32-bit aligned and
+ * num_frames must be even.
+ */
+void fir_convolve_stereo_armv6(const int16_t* a, const int16_t* b, int num_frames,
+                               int32_t* left, int32_t* right)
+{
+    const int16x2_t *a2 = (const int16x2_t *)a;
+    const int16x2_t *b2 = (const int16x2_t *)b;
+    int32_t suml = 1 << 13;
+    int32_t sumr = 1 << 13;
+
+    for (int i = 0; i < num_frames; i += 2, a2 += 2, b2++) {
+        int32_t c = b2[0];
+        suml = smlabb(a2[0], c, suml);
+        sumr = smlatb(a2[0], c, sumr);
+        suml = smlabt(a2[1], c, suml);
+        sumr = smlatt(a2[1], c, sumr);
+    }
+    *left = suml >> 14;
+    *right = sumr >> 14;
+}
+
+#endif
+
+/* Clip from 16.16 fixed-point to 0.16 fixed-point. */
+int16_t clip(int32_t x)
+{
+    if (x < -32768) {
+        return -32768;
+    } else if (x > 32767) {
+        return 32767;
+    } else {
+        return x;
+    }
+}
+
+/*
+ * Polyphase filter banks for conversion from 44100 to each supported input
+ * sampling rate in a single step.
+ *
+ * The output rate is AUDIO_HW_IN_SAMPLERATE * up / down. The prototype
+ * low-pass filter runs at up * 44100 Hz and has up * taps coefficients;
+ * it is split into up phases of taps coefficients each, and every output
+ * sample is computed by one phase from the last taps input samples.
+ *
+ * Kaiser window (beta 6), cutoff at the output Nyquist frequency, stopband
+ * below -60 dB, passband ripple < 0.1 dB:
+ *
+ *  22050: -1 dB at 9.2 kHz, -60 dB from 14.7 kHz
+ *  16000: -1 dB at 7.1 kHz, -60 dB from 9.8 kHz
+ *  11025: -1 dB at 4.8 kHz, -60 dB from 6.9 kHz
+ *   8000: -1 dB at 3.5 kHz, -60 dB from 4.9 kHz
+ */
+struct PolyphaseConfig {
+    uint32_t rate;
+    uint32_t up;
+    uint32_t down;
+    uint32_t taps;
+};
+
+static const PolyphaseConfig polyphaseConfigs[] = {
+    { 22050,   1,   2, 24 },
+    { 16000, 160, 441, 48 },
+    { 11025,   1,   4, 64 },
+    {  8000,  80, 441, 96 },
+};
+#define NUM_POLYPHASE_CONFIGS (sizeof(polyphaseConfigs) / sizeof(polyphaseConfigs[0]))
+#define POLYPHASE_KAISER_BETA 6.0
+
+/* Zeroth order modified Bessel function of the first kind. */
+static double bessel_i0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double halfx = x / 2.0;
+
+    for (int k = 1; k < 50; ++k) {
+        term *= (halfx / k) * (halfx / k);
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+/*
+ * Compute the phase tables of a polyphase filter bank in 2.14 fixed-point.
+ *
+ * Each phase is normalized to unity DC gain and stored twice, stride
+ * coefficients apart, so that fir_convolve() always works on 32-bit aligned
+ * coefficient pairs and an even number of taps:
+ * - the first copy is used when the oldest input sample of the filter window
+ *   is 32-bit aligned and holds the taps coefficients, oldest sample first,
+ *   zero padded up to an even count.
+ * - the second copy is used when a mono window starts at an odd sample. It
+ *   is shifted by one coefficient and preceded by a zero so that the
+ *   convolution can start one (ignored) sample earlier on an aligned address.
+ *   Stereo frames are always aligned and only use the first copy.
+ */
+static void polyphase_design(const PolyphaseConfig *config, int16_t *coeffs, int stride)
+{
+    const int up = config->up;
+    const int taps = config->taps;
+    const int length = up * taps;
+    const double cutoff = (double)config->rate / (2.0 * up * AUDIO_HW_IN_SAMPLERATE);
+    const double norm = bessel_i0(POLYPHASE_KAISER_BETA);
+    double *proto = new double[length];
+
+    for (int n = 0; n < length; ++n) {
+        double x = n - (length - 1) / 2.0;
+        double r = 2.0 * n / (length - 1) - 1.0;
+        double sinc = (x == 0.0) ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+        proto[n] = sinc * bessel_i0(POLYPHASE_KAISER_BETA * sqrt(1.0 - r * r)) / norm;
+    }
+
+    memset(coeffs, 0, up * 2 * stride * sizeof(*coeffs));
+    for (int p = 0; p < up; ++p) {
+        int16_t *even = coeffs + p * 2 * stride;
+        int16_t *odd = even + stride;
+        double sum = 0.0;
+        for (int k = 0; k < taps; ++k) {
+            sum += proto[p + k * up];
+        }
+        for (int j = 0; j < taps; ++j) {
+            double c = proto[p + (taps - 1 - j) * up] / sum;
+            even[j] = (int16_t)(((int32_t)floor(c * (1 << 30) + 0.5)) >> 16);
+            odd[j + 1] = even[j];
+        }
+    }
+
+    delete[] proto;
+}
+
+AudioHardware::DownSampler::DownSampler(uint32_t outSampleRate,
+                                    uint32_t channelCount,
+                                    uint32_t frameCount,
+                                    AudioHardware::BufferProvider* provider,
+                                    AudioHardware::ChannelMixer* mixer)
+    :  mStatus(NO_INIT), mProvider(provider), mMixer(mixer), mSampleRate(outSampleRate),
+       mChannelCount(channelCount), mFrameCount(frameCount),
+       mIn(NULL), mCoeffs(NULL), mUp(1), mDown(1),
+       mNumTaps(0), mStride(0), mRingSize(0), mMirrorSize(0),
+       mInInBuf(0), mInPos(0), mPhase(0), mProcessTime(0), mFramesOut(0)
+
+{
+    const PolyphaseConfig *config = NULL;
+
+    LOGD("AudioHardware::DownSampler() cstor %p SR %d channels %d frames %d",
+         this, mSampleRate, mChannelCount, mFrameCount);
+
+    for (size_t i = 0; i < NUM_POLYPHASE_CONFIGS; i++) {
+        if (polyphaseConfigs[i].rate == mSampleRate) {
+            config = &polyphaseConfigs[i];
+            break;
+        }
+    }
+    if (config == NULL) {
+        LOGW("AudioHardware::DownSampler cstor: bad sampling rate: %d", mSampleRate);
+        return;
+    }
+
+    mUp = config->up;
+    mDown = config->down;
+    mNumTaps = config->taps;
+
+    mStride = (mNumTaps + 2) & ~1;
+    mCoeffs = new int16_t[mUp * 2 * mStride];
+    polyphase_design(config, mCoeffs, mStride);
+
+    // The filter history is a ring buffer whose first mMirrorSize frames are
+    // duplicated past its end, so that any filter window is contiguous in
+    // memory. fir_convolve() may read one frame before and one frame past
+    // the window.
+    mRingSize = 1;
+    while (mRingSize < mFrameCount + mNumTaps) {
+        mRingSize <<= 1;
+    }
+    mMirrorSize = mNumTaps + 2;
+    mIn = new int16_t[(mRingSize + mMirrorSize) * mChannelCount];
+
+    reset();
+
+    mStatus = NO_ERROR;
+}
+
+AudioHardware::DownSampler::~DownSampler()
+{
+    if (mIn) delete[] mIn;
+    if (mCoeffs) delete[] mCoeffs;
+}
+
+void AudioHardware::DownSampler::reset()
+{
+    mInInBuf = 0;
+    mInPos = mNumTaps - 1;
+    mPhase = 0;
+}
+
+/*
+ * Append frames to the filter history. mInInBuf and mInPos are free running
+ * frame counters; positions in the ring are taken modulo mRingSize.
+ */
+void AudioHardware::DownSampler::writeHistory(const int16_t* in, uint32_t frames)
+{
+    const size_t frameSize = mChannelCount * sizeof(*mIn);
+    const uint32_t inChannelCount = mMixer ? mMixer->channelCount() : mChannelCount;
+    uint32_t pos = mInInBuf & (mRingSize - 1);
+
+    mInInBuf += frames;
+    while (frames) {
+        uint32_t count = mRingSize - pos;
+        if (count > frames) {
+            count = frames;
+        }
+        // the channel conversion is done on the way into the ring so that
+        // the captured frames are only gone through once
+        int16_t *ring = mIn + pos * mChannelCount;
+        if (mMixer) {
+            mMixer->process(in, ring, count);
+        } else {
+            memcpy(ring, in, count * frameSize);
+        }
+        if (pos < mMirrorSize) {
+            uint32_t mirror = mMirrorSize - pos;
+            if (mirror > count) {
+                mirror = count;
+            }
+            memcpy(mIn + (mRingSize + pos) * mChannelCount, ring, mirror * frameSize);
+        }
+        in += count * inChannelCount;
+        frames -= count;
+        pos = 0;
+    }
+}
+
+int AudioHardware::DownSampler::resample(int16_t* out, size_t *outFrameCount)
+{
+    if (mStatus != NO_ERROR) {
+        return mStatus;
+    }
+
+    if (out == NULL || outFrameCount == NULL) {
+        return BAD_VALUE;
+    }
+
+    size_t outFrames = 0;
+    nsecs_t start = systemTime();
+
+    while (outFrames < *outFrameCount) {
+        if ((int32_t)(mInPos - mInInBuf) >= 0) {
+            mProcessTime += systemTime() - start;
+
+            // room left in the ring after the frames still needed by the filter
+            int32_t used = (int32_t)(mInInBuf - (mInPos - (mNumTaps - 1)));
+            if (used < 0) {
+                used = 0;
+            }
+
+            AudioHardware::BufferProvider::Buffer buf;
+            buf.frameCount = mRingSize - used;
+            int ret = mProvider->getNextBuffer(&buf);
+            if (buf.raw == NULL) {
+                *outFrameCount = outFrames;
+                mFramesOut += outFrames;
+                return ret;
+            }
+
+            start = systemTime();
+            writeHistory(buf.i16, buf.frameCount);
+            mProvider->releaseBuffer(&buf);
+            continue;
+        }
+
+        const int16_t *coeffs = mCoeffs + mPhase * 2 * mStride;
+        uint32_t first = (mInPos - (mNumTaps - 1)) & (mRingSize - 1);
+        int taps = (mNumTaps + 1) & ~1;
+
+        if (mChannelCount == 2) {
+            int32_t left, right;
+            fir_convolve_stereo(mIn + first * 2, coeffs, taps, &left, &right);
+            out[outFrames * 2] = clip(left);
+            out[outFrames * 2 + 1] = clip(right);
+        } else {
+            if (first & 1) {
+                // use the shifted copy of the phase starting on an aligned sample
+                coeffs += mStride;
+                first--;
+                taps = mStride;
+            }
+            out[outFrames] = clip(fir_convolve(mIn + first, coeffs, taps));
+        }
+        outFrames++;
+
+        mPhase += mDown;
+        mInPos += mPhase / mUp;
+        mPhase %= mUp;
+    }
+
+    mProcessTime += systemTime() - start;
+    mFramesOut += outFrames;
+    return 0;
+}
+
+void AudioHardware::DownSampler::dump(String8& result)
+{
+    const size_t SIZE = 256;
+    char buffer[SIZE];
+
+    // the cost includes the channel conversion when a mixer is given
+    snprintf(buffer, SIZE, "\t\tDownSampler: %d Hz, %d => %d channels, %d/%d x %d taps: "
+             "%llu frames, %lld ns/frame\n",
+             mSampleRate, mMixer ? mMixer->channelCount() : mChannelCount,
+             mChannelCount, mUp, mDown, mNumTaps, mFramesOut,
+             mFramesOut ? mProcessTime / (nsecs_t)mFramesOut : 0);
+    result.append(buffer);
+}
+
+//------------------------------------------------------------------------------
+//  Channel mixer
+//------------------------------------------------------------------------------
+
+AudioHardware::ChannelMixer::ChannelMixer(uint32_t outChannelCount,
+                                    uint32_t channelCount,
+                                    uint32_t frameCount,
+                                    AudioHardware::BufferProvider* provider)
+    :  mStatus(NO_INIT), mProvider(provider), mOutChannelCount(outChannelCount),
+       mChannelCount(channelCount), mKernel(KERNEL_MATRIX), mBuffer(NULL),
+       mFrameCount(frameCount), mProviderData(NULL), mProcessTime(0), mFramesOut(0)
+{
+    LOGV("AudioHardware::ChannelMixer() cstor %p channels %d => %d frames %d",
+         this, mChannelCount, mOutChannelCount, frameCount);
+
+    if (outChannelCount == 0 || outChannelCount > MAX_CHANNELS ||
+        channelCount == 0 || channelCount > MAX_CHANNELS || frameCount == 0) {
+        LOGE("AudioHardware::ChannelMixer cstor: bad conversion: %d => %d",
+                                                mChannelCount, outChannelCount);
+        return;
+    }
+
+    int16_t gains[MAX_CHANNELS * MAX_CHANNELS];
+    for (uint32_t o = 0; o < outChannelCount; o++) {
+        for (uint32_t i = 0; i < channelCount; i++) {
+            int16_t gain;
+            if (outChannelCount == 1) {
+                gain = (UNITY_GAIN + channelCount / 2) / channelCount;
+            } else if (channelCount == 1) {
+                gain = UNITY_GAIN;
+            } else {
+                gain = (i == o) ? UNITY_GAIN : 0;
+            }
+            gains[o * channelCount + i] = gain;
+        }
+    }
+
+    mStatus = setMatrix(gains);
+}
+
+AudioHardware::ChannelMixer::~ChannelMixer()
+{
+    delete[] mBuffer;
+}
+
+status_t AudioHardware::ChannelMixer::setMatrix(const int16_t *gains)
+{
+    if (gains == NULL) {
+        return BAD_VALUE;
+    }
+    memcpy(mMatrix, gains, mOutChannelCount * mChannelCount * sizeof(*gains));
+
+    if (mChannelCount == 2 && mOutChannelCount == 1) {
+        mKernel = KERNEL_STEREO_TO_MONO;
+    } else if (mChannelCount == 1 && mOutChannelCount == 2) {
+        mKernel = KERNEL_MONO_TO_STEREO;
+    } else {
+        mKernel = KERNEL_MATRIX;
+    }
+    return NO_ERROR;
+}
+
+/*
+ * Channel mixing kernels. Samples are in 0.16 fixed-point and gains in 2.14
+ * fixed-point; every output sample is the rounded sum of its products,
+ * saturated to 16 bits. The ARMv6 versions use the dual 16-bit multiplies
+ * and SSAT and give the same results as the portable ones.
+ */
+void channel_mix_c(const int16_t* in, int16_t* out, size_t frames,
+                   const int16_t* matrix, int inChannels, int outChannels)
+{
+    while (frames--) {
+        const int16_t *gains = matrix;
+        for (int o = 0; o < outChannels; o++, gains += inChannels) {
+            int32_t sum = 1 << 13;
+            for (int i = 0; i < inChannels; i++) {
+                sum += in[i] * gains[i];
+            }
+            *out++ = clip(sum >> 14);
+        }
+        in += inChannels;
+    }
+}
+
+void stereo_to_mono_c(const int16_t* in, int16_t* out, size_t frames,
+                      const int16_t* gains)
+{
+    const int32_t gl = gains[0];
+    const int32_t gr = gains[1];
+    while (frames--) {
+        *out++ = clip((in[0] * gl + in[1] * gr + (1 << 13)) >> 14);
+        in += 2;
+    }
+}
+
+void mono_to_stereo_c(const int16_t* in, int16_t* out, size_t frames,
+                      const int16_t* gains)
+{
+    const int32_t gl = gains[0];
+    const int32_t gr = gains[1];
+    while (frames--) {
+        int32_t s = *in++;
+        out[0] = clip((s * gl + (1 << 13)) >> 14);
+        out[1] = clip((s * gr + (1 << 13)) >> 14);
+        out += 2;
+    }
+}
+
+#ifdef AUDIO_ARMV6_DSP
+/*
+ * ARMv6 version of stereo_to_mono_c(): one SMLAD per frame, with both gains
+ * packed in a register. in must be 32-bit aligned.
+ */
+void stereo_to_mono_armv6(const int16_t* in, int16_t* out, size_t frames,
+                          const int16_t* gains)
+{
+    const int16x2_t *in2 = (const int16x2_t *)in;
+    const int32_t g = (gains[0] & 0xffff) | ((uint32_t)gains[1] << 16);
+    while (frames--) {
+        *out++ = ssat16(smlad(*in2++, g, 1 << 13) >> 14);
+    }
+}
+
+/*
+ * ARMv6 version of mono_to_stereo_c(). Both channels of a frame are built in
+ * a register and written with one store. out must be 32-bit aligned.
+ */
+void mono_to_stereo_armv6(const int16_t* in, int16_t* out, size_t frames,
+                          const int16_t* gains)
+{
+    int16x2_t *out2 = (int16x2_t *)out;
+    const int32_t g = (gains[0] & 0xffff) | ((uint32_t)gains[1] << 16);
+    while (frames--) {
+        int32_t s = *in++;
+        int32_t l = ssat16(smlabb(s, g, 1 << 13) >> 14);
+        int32_t r = ssat16(smlabt(s, g, 1 << 13) >> 14);
+        *out2++ = (l & 0xffff) | ((uint32_t)r << 16);
+    }
+}
+
+#endif
+
+void AudioHardware::ChannelMixer::process(const int16_t* in, int16_t* out,
+                                          size_t frameCount)
+{
+    switch (mKernel) {
+    case KERNEL_STEREO_TO_MONO:
+        stereo_to_mono(in, out, frameCount, mMatrix);
+        break;
+    case KERNEL_MONO_TO_STEREO:
+        mono_to_stereo(in, out, frameCount, mMatrix);
+        break;
+    default:
+        channel_mix_c(in, out, frameCount, mMatrix, mChannelCount, mOutChannelCount);
+        break;
+    }
+}
+
+status_t AudioHardware::ChannelMixer::getNextBuffer(AudioHardware::BufferProvider::Buffer* buffer)
+{
+    status_t ret;
+
+    if (!mProvider || mStatus != NO_ERROR)
+        return NO_INIT;
+
+    if (buffer->frameCount > mFrameCount)
+        buffer->frameCount = mFrameCount;
+    ret = mProvider->getNextBuffer(buffer);
+    if (ret != 0) {
+        LOGE("%s: mProvider->getNextBuffer() failed (%d)", __func__, ret);
+        return ret;
+    }
+    if (!buffer->raw)
+        return NO_ERROR;
+    if (mBuffer == NULL)
+        mBuffer = new int16_t[mFrameCount * mOutChannelCount];
+
+    // the provider's frames are left untouched: it gets its own pointer back
+    // in releaseBuffer()
+    nsecs_t start = systemTime();
+    process(buffer->i16, mBuffer, buffer->frameCount);
+    mProcessTime += systemTime() - start;
+    mFramesOut += buffer->frameCount;
+
+    mProviderData = buffer->raw;
+    buffer->i16 = mBuffer;
+
+    return NO_ERROR;
+}
+
+void AudioHardware::ChannelMixer::releaseBuffer(Buffer* buffer)
+{
+    if (mProvider) {
+        buffer->raw = mProviderData;
+        mProvider->releaseBuffer(buffer);
+    }
+}
+
+int AudioHardware::ChannelMixer::mix(int16_t* out, size_t *outFrameCount)
+{
+    if (mStatus != NO_ERROR || !mProvider) {
+        return NO_INIT;
+    }
+
+    if (out == NULL || outFrameCount == NULL) {
+        return BAD_VALUE;
+    }
+
+    int remaingFrames = *outFrameCount;
+    while (remaingFrames) {
+        AudioHardware::BufferProvider::Buffer buf;
+        buf.frameCount = remaingFrames;
+
+        int ret = mProvider->getNextBuffer(&buf);
+        if (ret || buf.raw == NULL) {
+            *outFrameCount -= remaingFrames;
+            return ret;
+        }
+
+        remaingFrames -= buf.frameCount;
+
+        // straight to the caller's buffer
+        nsecs_t start = systemTime();
+        process(buf.i16, out, buf.frameCount);
+        out += buf.frameCount * mOutChannelCount;
+        mProcessTime += systemTime() - start;
+        mFramesOut += buf.frameCount;
+
+        mProvider->releaseBuffer(&buf);
+    }
+
+    return 0;
+}
+
+void AudioHardware::ChannelMixer::dump(String8& result)
+{
+    const size_t SIZE = 256;
+    char buffer[SIZE];
+
+    snprintf(buffer, SIZE, "\t\tChannelMixer: %d => %d channels: "
+             "%llu frames, %lld ns/frame\n",
+             mChannelCount, mOutChannelCount, mFramesOut,
+             mFramesOut ? mProcessTime / (nsecs_t)mFramesOut : 0);
+    result.append(buffer);
+}
+
+//------------------------------------------------------------------------------
+//  Software gain
+//------------------------------------------------------------------------------
+
+/*
+ * Gain kernels for stereo frames in 0.16 fixed-point. The gain is in 2.14
+ * fixed-point; the ramping versions take it in 2.30 fixed-point with a per
+ * frame step and use its 14 upper fraction bits for each frame. Results are
+ * rounded and saturated. in and out may be the same buffer.
+ */
+void gain_stereo_c(const int16_t* in, int16_t* out, size_t frames,
+                   int32_t gain)
+{
+    for (frames *= 2; frames--; ) {
+        *out++ = clip((*in++ * gain + (1 << 13)) >> 14);
+    }
+}
+
+void gain_ramp_stereo_c(const int16_t* in, int16_t* out, size_t frames,
+                        int32_t gain, int32_t step)
+{
+    while (frames--) {
+        int32_t g = gain >> 16;
+        out[0] = clip((in[0] * g + (1 << 13)) >> 14);
+        out[1] = clip((in[1] * g + (1 << 13)) >> 14);
+        in += 2;
+        out += 2;
+        gain += step;
+    }
+}
+
+#ifdef AUDIO_ARMV6_DSP
+/*
+ * ARMv6 versions: each frame is loaded and stored with one access and both
+ * samples are scaled by SMLAxB and SSAT. in and out must be 32-bit aligned.
+ */
+void gain_stereo_armv6(const int16_t* in, int16_t* out, size_t frames,
+                       int32_t gain)
+{
+    const int16x2_t *in2 = (const int16x2_t *)in;
+    int16x2_t *out2 = (int16x2_t *)out;
+    while (frames--) {
+        int32_t f = *in2++;
+        int32_t l = ssat16_asr14(smlabb(f, gain, 1 << 13));
+        int32_t r = ssat16_asr14(smlatb(f, gain, 1 << 13));
+        *out2++ = (l & 0xffff) | ((uint32_t)r << 16);
+    }
+}
+
+void gain_ramp_stereo_armv6(const int16_t* in, int16_t* out, size_t frames,
+                            int32_t gain, int32_t step)
+{
+    const int16x2_t *in2 = (const int16x2_t *)in;
+    int16x2_t *out2 = (int16x2_t *)out;
+    while (frames--) {
+        int32_t f = *in2++;
+        int32_t g = gain >> 16;
+        int32_t l = ssat16_asr14(smlabb(f, g, 1 << 13));
+        int32_t r = ssat16_asr14(smlatb(f, g, 1 << 13));
+        *out2++ = (l & 0xffff) | ((uint32_t)r << 16);
+        gain += step;
+    }
+}
+
+#endif
+
+/*
+ * Add the stereo frames of in to out, saturating. The ARMv6 version adds
+ * both samples of a frame with one QADD16; buffers must be 32-bit aligned.
+ */
+void mix_stereo_c(int16_t* out, const int16_t* in, size_t frames)
+{
+    for (frames *= 2; frames--; out++) {
+        *out = clip(*out + *in++);
+    }
+}
+
+#ifdef AUDIO_ARMV6_DSP
+void mix_stereo_armv6(int16_t* out, const int16_t* in, size_t frames)
+{
+    const int16x2_t *in2 = (const int16x2_t *)in;
+    int16x2_t *out2 = (int16x2_t *)out;
+    while (frames--) {
+        *out2 = qadd16(*out2, *in2++);
+        out2++;
+    }
+}
+
+#endif
+
+}; // namespace android
@@ -0,0 +1,90 @@
+/*
+** Copyright 2010, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_DSP_H
+#define ANDROID_AUDIO_DSP_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace android {
+
+// Fixed-point kernels of the capture and playback paths, implemented in
+// AudioDsp.cpp. Samples are in 0.16 fixed-point, gains and filter
+// coefficients in 2.14 fixed-point. Every kernel has a portable reference
+// version (_c); the ARMv6 versions (_armv6) must give bit-identical results.
+// The ARMv6 versions are built with AUDIO_ARMV6_DSP, off ARM too for the
+// host tests, and the plain names resolve to them on ARM.
+
+// Clip from 16.16 fixed-point to 0.16 fixed-point
+int16_t clip(int32_t x);
+
+// FIR filter of the DownSampler polyphase filter bank
+int32_t fir_convolve_c(const int16_t* a, const int16_t* b, int num_samples);
+void fir_convolve_stereo_c(const int16_t* a, const int16_t* b, int num_frames,
+                           int32_t* left, int32_t* right);
+
+// ChannelMixer gain matrix
+void channel_mix_c(const int16_t* in, int16_t* out, size_t frames,
+                   const int16_t* matrix, int inChannels, int outChannels);
+void stereo_to_mono_c(const int16_t* in, int16_t* out, size_t frames,
+                      const int16_t* gains);
+void mono_to_stereo_c(const int16_t* in, int16_t* out, size_t frames,
+                      const int16_t* gains);
+
+// Output software gain and mixing of stereo frames
+void gain_stereo_c(const int16_t* in, int16_t* out, size_t frames,
+                   int32_t gain);
+void gain_ramp_stereo_c(const int16_t* in, int16_t* out, size_t frames,
+                        int32_t gain, int32_t step);
+void mix_stereo_c(int16_t* out, const int16_t* in, size_t frames);
+
+#ifdef AUDIO_ARMV6_DSP
+int32_t fir_convolve_armv6(const int16_t* a, const int16_t* b, int num_samples);
+void fir_convolve_stereo_armv6(const int16_t* a, const int16_t* b, int num_frames,
+                               int32_t* left, int32_t* right);
+void stereo_to_mono_armv6(const int16_t* in, int16_t* out, size_t frames,
+                          const int16_t* gains);
+void mono_to_stereo_armv6(const int16_t* in, int16_t* out, size_t frames,
+                          const int16_t* gains);
+void gain_stereo_armv6(const int16_t* in, int16_t* out, size_t frames,
+                       int32_t gain);
+void gain_ramp_stereo_armv6(const int16_t* in, int16_t* out, size_t frames,
+                            int32_t gain, int32_t step);
+void mix_stereo_armv6(int16_t* out, const int16_t* in, size_t frames);
+#endif
+
+#if defined(AUDIO_ARMV6_DSP) && defined(__arm__)
+#define fir_convolve fir_convolve_armv6
+#define fir_convolve_stereo fir_convolve_stereo_armv6
+#define stereo_to_mono stereo_to_mono_armv6
+#define mono_to_stereo mono_to_stereo_armv6
+#define gain_stereo gain_stereo_armv6
+#define gain_ramp_stereo gain_ramp_stereo_armv6
+#define mix_stereo mix_stereo_armv6
+#else
+#define fir_convolve fir_convolve_c
+#define fir_convolve_stereo fir_convolve_stereo_c
+#define stereo_to_mono stereo_to_mono_c
+#define mono_to_stereo mono_to_stereo_c
+#define gain_stereo gain_stereo_c
+#define gain_ramp_stereo gain_ramp_stereo_c
+#define mix_stereo mix_stereo_c
+#endif
+
+}; // namespace android
+
+#endif // ANDROID_AUDIO_DSP_H
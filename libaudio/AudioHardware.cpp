@@ -24,15 +24,21 @@
 #include <utils/String8.h>
 
 #include <stdio.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/resource.h>
+#include <sched.h>
 #include <dlfcn.h>
 #include <fcntl.h>
 
+#include <cutils/atomic.h>
+#include <cutils/properties.h>
+
 #include "AudioHardware.h"
+#include "AudioDsp.h"
 #include <media/AudioRecord.h>
 #include <hardware_legacy/power.h>
 
@@ -52,6 +58,22 @@ const uint32_t AudioHardware::inputSamplingRates[] = {
         8000, 11025, 16000, 22050, 44100
 };
 
+// Stream rates the pcm driver interface can be asked for
+const uint32_t AudioHardware::pcmSamplingRates[] = {
+        8000, 11025, 16000, 22050, 44100, 48000
+};
+#define NUM_PCM_SAMPLING_RATES \
+        (sizeof(AudioHardware::pcmSamplingRates) / sizeof(uint32_t))
+
+const AudioHardware::OutputProfileConfig
+        AudioHardware::outputProfiles[OUTPUT_PROFILE_COUNT] = {
+    { "normal", AUDIO_HW_OUT_PERIOD_MULT, AUDIO_HW_OUT_PERIOD_CNT },
+    { "low_latency", AUDIO_HW_OUT_LOW_LATENCY_PERIOD_MULT,
+      AUDIO_HW_OUT_LOW_LATENCY_PERIOD_CNT },
+    { "deep_buffer", AUDIO_HW_OUT_DEEP_BUFFER_PERIOD_MULT,
+      AUDIO_HW_OUT_DEEP_BUFFER_PERIOD_CNT },
+};
+
 //  trace driver operations for dump
 //
 #define DRIVER_TRACE
@@ -65,15 +87,46 @@ enum {
     DRV_MIXER_OPEN,
     DRV_MIXER_CLOSE,
     DRV_MIXER_GET,
-    DRV_MIXER_SEL
+    DRV_MIXER_SEL,
+    DRV_PCM_STATUS,
+    DRV_PCM_STOP,
+    DRV_PCM_PREPARE,
+    DRV_PCM_PROBE,
+    DRV_MIXER_SET,
+    DRV_PCM_MMAP_BEGIN,
+    DRV_PCM_MMAP_COMMIT,
+    DRV_COUNT
+};
+
+static const char *const driverOpNames[DRV_COUNT] = {
+    "none",
+    "pcm_open",
+    "pcm_close",
+    "pcm_write",
+    "pcm_read",
+    "mixer_open",
+    "mixer_close",
+    "mixer_get",
+    "mixer_select",
+    "pcm_status",
+    "pcm_stop",
+    "pcm_prepare",
+    "pcm_probe",
+    "mixer_set",
+    "pcm_mmap_begin",
+    "pcm_mmap_commit",
 };
 
 #ifdef DRIVER_TRACE
-#define TRACE_DRIVER_IN(op) mDriverOp = op;
-#define TRACE_DRIVER_OUT mDriverOp = DRV_NONE;
+// result is the driver call return value, or 0/-1 for calls returning a
+// handle
+#define TRACE_DRIVER_IN(op) mDriverOp = op; mDriverOpStart = systemTime();
+#define TRACE_DRIVER_OUT(result) \
+    AudioHardware::sDriverTrace.record(mDriverOp, this, mDriverOpStart, (result)); \
+    mDriverOp = DRV_NONE;
 #else
 #define TRACE_DRIVER_IN(op)
-#define TRACE_DRIVER_OUT
+#define TRACE_DRIVER_OUT(result)
 #endif
 
 // ----------------------------------------------------------------------------
@@ -249,77 +302,184 @@ const AudioHardware::AudioRouteConfig *AudioHardware::routeTables[] = {
     voiceOutRouteConfigs
 };
 
+// Look up the mixer control of every route pin once, so that route changes
+// do not search the mixer controls by name
+void AudioHardware::resolveRoutes_l()
+{
+    for (int type = 0; type < ROUTE_COUNT; type++) {
+        const AudioRouteConfig *route;
+        size_t routes = 0;
+
+        for (route = routeTables[type]; route->route; ++route)
+            routes++;
+
+        ResolvedRoute *resolved = new ResolvedRoute[routes + 1];
+        for (route = routeTables[type]; route->route; ++route, ++resolved) {
+            const AudioPinConfig *pin;
+            size_t pins = 0;
+
+            for (pin = route->config; pin->type; ++pin)
+                pins++;
+
+            resolved->route = route->route;
+            resolved->pins = new RoutePin[pins];
+            resolved->count = 0;
+            for (pin = route->config; pin->type; ++pin) {
+                TRACE_DRIVER_IN(DRV_MIXER_GET)
+                struct mixer_ctl *ctl = mixer_get_control(mMixer, pin->ctl, 0);
+                TRACE_DRIVER_OUT(ctl != NULL ? 0 : -1)
+                if (!ctl) {
+                    LOGW("resolveRoutes_l() no mixer control %s", pin->ctl);
+                    continue;
+                }
+                resolved->pins[resolved->count].config = pin;
+                resolved->pins[resolved->count].ctl = ctl;
+                resolved->count++;
+            }
+        }
+        resolved->route = 0;
+        resolved->pins = NULL;
+        resolved->count = 0;
+        mResolvedRoutes[type] = resolved - routes;
+    }
+}
+
+void AudioHardware::releaseRoutes_l()
+{
+    for (int type = 0; type < ROUTE_COUNT; type++) {
+        ResolvedRoute *resolved = mResolvedRoutes[type];
+        if (resolved == NULL)
+            continue;
+        for (ResolvedRoute *route = resolved; route->route; ++route)
+            delete[] route->pins;
+        delete[] resolved;
+        mResolvedRoutes[type] = NULL;
+    }
+}
+
+const AudioHardware::ResolvedRoute *AudioHardware::findRoute_l(RouteType type,
+                                                               uint32_t route)
+{
+    const ResolvedRoute *resolved = mResolvedRoutes[type];
+
+    if (resolved == NULL || route == 0)
+        return NULL;
+
+    for (; resolved->route; ++resolved)
+        if (resolved->route == route)
+            return resolved;
+
+    return NULL;
+}
+
+// Returns the pin of route driving ctl, if any
+const AudioHardware::RoutePin *AudioHardware::findRoutePin(
+        const ResolvedRoute *route, struct mixer_ctl *ctl)
+{
+    if (route == NULL)
+        return NULL;
+    for (size_t i = 0; i < route->count; i++)
+        if (route->pins[i].ctl == ctl)
+            return &route->pins[i];
+    return NULL;
+}
+
 void AudioHardware::setAudioRoute(enum RouteType type, uint32_t newRoute)
 {
-    const AudioRouteConfig *route;
-    const AudioPinConfig *pin;
-    struct mixer_ctl *ctl;
+    const ResolvedRoute *oldRoute;
+    const ResolvedRoute *route;
+    int ret;
 
     LOGV("setAudioRoute, mRoute[type] = %d RouteType = %d newRoute = %d", mRoute[type], type, newRoute);
 
     if (mRoute[type] == newRoute)
         return;
 
-    for (route = routeTables[type]; route->route; ++route)
-        if (route->route == mRoute[type])
-            break;
+    nsecs_t start = systemTime();
+
+    oldRoute = findRoute_l(type, mRoute[type]);
+    route = findRoute_l(type, newRoute);
 
-    if (route->route) {
-        /* Disable current route */
-        for (pin = route->config; pin->type; ++pin) {
-            if (pin->type != TYPE_BOOL)
+    if (oldRoute) {
+        /* Disable the switches of the current route that the new route
+         * does not drive: shared controls are not toggled off and back on */
+        for (size_t i = 0; i < oldRoute->count; i++) {
+            const RoutePin *pin = &oldRoute->pins[i];
+            if (pin->config->type != TYPE_BOOL)
                 continue;
-    
-            TRACE_DRIVER_IN(DRV_MIXER_GET)
-            ctl = mixer_get_control(mMixer, pin->ctl, 0);
-            TRACE_DRIVER_OUT
-            if (!ctl)
+            if (findRoutePin(route, pin->ctl))
                 continue;
-    
+
             TRACE_DRIVER_IN(DRV_MIXER_SEL)
-            mixer_ctl_set(ctl, !pin->intValue);
-            TRACE_DRIVER_OUT
+            ret = mixer_ctl_update(pin->ctl, !pin->config->intValue);
+            TRACE_DRIVER_OUT(ret)
+            if (ret > 0)
+                mRouteWrites++;
+            else if (ret == 0)
+                mRouteSkips++;
         }
     }
 
-    for (route = routeTables[type]; route->route; ++route)
-        if (route->route == newRoute)
-            break;
+    /* The level of an output route is the ceiling of the master volume,
+     * written once below with the master volume applied */
+    struct mixer_ctl *masterCtl = NULL;
+    if (type == ROUTE_OUTPUT && mMode != AudioSystem::MODE_IN_CALL)
+        masterCtl = mixer_get_control(mMixer, "Master Playback Volume", 0);
 
-    if (route->route) {
-        /* Configure new route */
-        for (pin = route->config; pin->type; ++pin) {
-            TRACE_DRIVER_IN(DRV_MIXER_GET)
-            ctl = mixer_get_control(mMixer, pin->ctl, 0);
-            TRACE_DRIVER_OUT
-            if (!ctl)
-                continue;
+    if (route) {
+        /* Configure new route, leaving alone controls that already hold
+         * the right value */
+        for (size_t i = 0; i < route->count; i++) {
+            const RoutePin *pin = &route->pins[i];
 
-            if (pin->type == TYPE_MUX) {
-                TRACE_DRIVER_IN(DRV_MIXER_SEL)
-                mixer_ctl_select(ctl, pin->strValue);
-                TRACE_DRIVER_OUT
+            if (pin->ctl == masterCtl)
                 continue;
-            }
 
             TRACE_DRIVER_IN(DRV_MIXER_SEL)
-            mixer_ctl_set(ctl, pin->intValue);
-            TRACE_DRIVER_OUT
+            if (pin->config->type == TYPE_MUX)
+                ret = mixer_ctl_update_select(pin->ctl, pin->config->strValue);
+            else
+                ret = mixer_ctl_update(pin->ctl, pin->config->intValue);
+            TRACE_DRIVER_OUT(ret)
+            if (ret > 0)
+                mRouteWrites++;
+            else if (ret == 0)
+                mRouteSkips++;
         }
     }
 
     mRoute[type] = newRoute;
+
+    mRouteTime.add(systemTime() - start);
+
+    if (type == ROUTE_OUTPUT) {
+        applyMasterVolume_l();
+    }
 }
 
 AudioHardware::AudioHardware() :
     mInit(false),
     mMicMute(false),
+    mCapture(new CaptureSource()),
     mPcm(NULL),
     mMixer(NULL),
+    mMixerHandle(NULL),
     mPcmOpenCnt(0),
+    mPcmWriter(NULL),
+    mPcmWriterBusy(false),
+    mPcmWriterTime(0),
+    mPcmWriterIdle(0),
+    mOutputProfile(OUTPUT_PROFILE_NORMAL),
+    mOutputSampleRate(AUDIO_HW_OUT_SAMPLERATE),
+    mNativeInRates(0),
+    mNativeOutRates(0),
+    mNativeMonoInRates(0),
     mMixerOpenCnt(0),
+    mMixerOpenTime(0),
+    mMixerReuseCnt(0),
     mInCallAudioMode(false),
     mVoiceVol(1.0f),
+    mMasterVol(1.0f),
     mInputSource(AUDIO_SOURCE_DEFAULT),
     mBluetoothNrec(true),
 #ifdef HAVE_FM_RADIO
@@ -327,11 +487,18 @@ AudioHardware::AudioHardware() :
     mFmVolume(1),
     mFmResumeAfterCall(false),
 #endif
-    mDriverOp(DRV_NONE)
+    mDriverOp(DRV_NONE),
+    mDriverOpStart(0)
 {
     struct mixer_ctl *ctl;
     struct mixer *mixer;
     const struct AudioPinConfig *pin;
+    int ret;
+
+    memset(mRoute, 0, sizeof(mRoute));
+    memset(mResolvedRoutes, 0, sizeof(mResolvedRoutes));
+    mRouteWrites = 0;
+    mRouteSkips = 0;
 
     mixer = openMixer_l();
     if (mixer == NULL) {
@@ -342,23 +509,49 @@ AudioHardware::AudioHardware() :
     for (pin = initialPinConfig; pin->type != TYPE_NONE; ++pin) {
         TRACE_DRIVER_IN(DRV_MIXER_GET)
         ctl = mixer_get_control(mixer, pin->ctl, 0);
-        TRACE_DRIVER_OUT
+        TRACE_DRIVER_OUT(ctl != NULL ? 0 : -1)
         if (!ctl)
             continue;
 
         if (pin->type == TYPE_MUX) {
             TRACE_DRIVER_IN(DRV_MIXER_SEL)
-            mixer_ctl_select(ctl, pin->strValue);
-            TRACE_DRIVER_OUT
+            ret = mixer_ctl_select(ctl, pin->strValue);
+            TRACE_DRIVER_OUT(ret)
             continue;
         }
-        TRACE_DRIVER_IN(DRV_MIXER_SEL)
-        mixer_ctl_set(ctl, pin->intValue);
-        TRACE_DRIVER_OUT
+        TRACE_DRIVER_IN(DRV_MIXER_SET)
+        ret = mixer_ctl_set(ctl, pin->intValue);
+        TRACE_DRIVER_OUT(ret)
     }
 
     closeMixer_l();
 
+    // find out which stream rates the codec can run at without resampling
+    for (size_t i = 0; i < NUM_PCM_SAMPLING_RATES; i++) {
+        unsigned flags;
+        getPcmRateFlags(pcmSamplingRates[i], &flags);
+        TRACE_DRIVER_IN(DRV_PCM_PROBE)
+        ret = pcm_rate_supported(PCM_OUT | flags);
+        TRACE_DRIVER_OUT(ret)
+        if (ret) {
+            mNativeOutRates |= 1 << i;
+        }
+        TRACE_DRIVER_IN(DRV_PCM_PROBE)
+        ret = pcm_rate_supported(PCM_IN | flags);
+        TRACE_DRIVER_OUT(ret)
+        if (ret) {
+            mNativeInRates |= 1 << i;
+            TRACE_DRIVER_IN(DRV_PCM_PROBE)
+            ret = pcm_rate_supported(PCM_IN | PCM_MONO | flags);
+            TRACE_DRIVER_OUT(ret)
+            if (ret) {
+                mNativeMonoInRates |= 1 << i;
+            }
+        }
+    }
+    LOGI("native rates: out 0x%02x in 0x%02x (mono 0x%02x)", mNativeOutRates,
+         mNativeInRates, mNativeMonoInRates);
+
     mInit = true;
 }
 
@@ -368,17 +561,22 @@ AudioHardware::~AudioHardware()
         closeInputStream(mInputs[index].get());
     }
     mInputs.clear();
+    if (mDeepOutput != 0) {
+        closeOutputStream((AudioStreamOut*)mDeepOutput.get());
+    }
     closeOutputStream((AudioStreamOut*)mOutput.get());
+    delete mCapture;
 
-    if (mMixer) {
+    if (mMixerHandle) {
+        releaseRoutes_l();
         TRACE_DRIVER_IN(DRV_MIXER_CLOSE)
-        mixer_close(mMixer);
-        TRACE_DRIVER_OUT
+        mixer_close(mMixerHandle);
+        TRACE_DRIVER_OUT(0)
     }
     if (mPcm) {
         TRACE_DRIVER_IN(DRV_PCM_CLOSE)
         pcm_close(mPcm);
-        TRACE_DRIVER_OUT
+        TRACE_DRIVER_OUT(0)
     }
 
     mInit = false;
@@ -401,19 +599,34 @@ AudioStreamOut* AudioHardware::openOutputStream(
     { // scope for the lock
         Mutex::Autolock lock(mLock);
 
-        // only one output stream allowed
+        // only one output stream allowed, plus the deep buffer one
+        bool deep = false;
         if (mOutput != 0) {
-            if (status) {
-                *status = INVALID_OPERATION;
+            char value[PROPERTY_VALUE_MAX];
+            property_get(AUDIO_HW_OUT_DEEP_BUFFER_PROPERTY, value, "1");
+            if (mDeepOutput != 0 || !strcmp(value, "0") || !strcasecmp(value, "false")) {
+                if (status) {
+                    *status = INVALID_OPERATION;
+                }
+                return NULL;
             }
-            return NULL;
+            deep = true;
         }
 
         out = new AudioStreamOutALSA();
 
-        rc = out->set(this, devices, format, channels, sampleRate);
+        OutputProfile profile = deep ? OUTPUT_PROFILE_DEEP_BUFFER : getOutputProfile();
+        rc = out->set(this, devices, format, channels, sampleRate, profile, deep);
         if (rc == NO_ERROR) {
-            mOutput = out;
+            out->setGain(masterGain_l());
+            AutoMutex mixLock(mMixLock);
+            if (deep) {
+                mDeepOutput = out;
+            } else {
+                mOutput = out;
+                mOutputProfile = profile;
+                mOutputSampleRate = out->sampleRate();
+            }
         }
     }
 
@@ -435,12 +648,17 @@ void AudioHardware::closeOutputStream(AudioStreamOut* out) {
     	LOGV("AudioHardware::closeOutputStream");
 
         Mutex::Autolock lock(mLock);
-        if (mOutput == 0 || mOutput.get() != out) {
+        AutoMutex mixLock(mMixLock);
+        if (mOutput != 0 && mOutput.get() == out) {
+            spOut = mOutput;
+            mOutput.clear();
+        } else if (mDeepOutput != 0 && mDeepOutput.get() == out) {
+            spOut = mDeepOutput;
+            mDeepOutput.clear();
+        } else {
             LOGW("Attempt to close invalid output stream");
             return;
         }
-        spOut = mOutput;
-        mOutput.clear();
     }
     spOut.clear();
 }
@@ -509,6 +727,7 @@ void AudioHardware::closeInputStream(AudioStreamIn* in) {
 status_t AudioHardware::setMode(int mode)
 {
     sp<AudioStreamOutALSA> spOut;
+    sp<AudioStreamOutALSA> spDeepOut;
     sp<AudioStreamInALSA> spIn;
     status_t status;
 
@@ -516,28 +735,12 @@ status_t AudioHardware::setMode(int mode)
     int  priority = getpriority(PRIO_PROCESS, 0);
     setpriority(PRIO_PROCESS, 0, ANDROID_PRIORITY_URGENT_AUDIO);
 
-    // Mutex acquisition order is always out -> in -> hw
+    // Mutex acquisition order is always out -> in -> hw, the main output
+    // before the deep buffer one
     AutoMutex lock(mLock);
 
-    spOut = mOutput;
-    while (spOut != 0) {
-        if (!spOut->checkStandby()) {
-            int cnt = spOut->prepareLock();
-            mLock.unlock();
-            spOut->lock();
-            mLock.lock();
-            // make sure that another thread did not change output state while the
-            // mutex is released
-            if ((spOut == mOutput) && (cnt == spOut->standbyCnt())) {
-                break;
-            }
-            spOut->unlock();
-            spOut = mOutput;
-        } else {
-            spOut.clear();
-        }
-    }
-    // spOut is not 0 here only if the output is active
+    spOut = lockActiveOutput_l(false);
+    spDeepOut = lockActiveOutput_l(true);
 
     setpriority(PRIO_PROCESS, 0, priority);
 
@@ -562,15 +765,20 @@ status_t AudioHardware::setMode(int mode)
     LOGV("setMode() : new %d, old %d", mMode, prevMode);
     if (status == NO_ERROR) {
         if (mMode == AudioSystem::MODE_IN_CALL && !mInCallAudioMode) {
-            struct mixer_ctl *ctl;
             if (spOut != 0) {
                 LOGV("setMode() in call force output standby");
                 spOut->doStandby_l();
             }
+            if (spDeepOut != 0) {
+                LOGV("setMode() in call force deep buffer output standby");
+                spDeepOut->doStandby_l();
+            }
             if (spIn != 0) {
                 LOGV("setMode() in call force input standby");
                 spIn->doStandby_l();
             }
+            // other inputs sharing the capture reopen it on their next read
+            mCapture->suspend_l();
 
             LOGV("setMode() openPcmOut_l()");
             openPcmOut_l();
@@ -580,29 +788,20 @@ status_t AudioHardware::setMode(int mode)
                 setAudioRoute(ROUTE_VOICE_IN, VOICE_IN_MIC_MAIN);
                 setAudioRoute(ROUTE_VOICE_OUT, VOICE_OUT_RCV);
                 setVoiceVolume_l(mVoiceVol);
-                ctl = mixer_get_control(mMixer, "GSM Send Switch", 0);
-                if (ctl)
-                    mixer_ctl_set(ctl, 1);
-                ctl = mixer_get_control(mMixer, "GSM Receive Switch", 0);
-                if (ctl)
-                    mixer_ctl_set(ctl, 1);
+                setMixerControl_l("GSM Send Switch", 1);
+                setMixerControl_l("GSM Receive Switch", 1);
             }
             mInCallAudioMode = true;
         }
         if (mMode != AudioSystem::MODE_IN_CALL && mInCallAudioMode) {
-            struct mixer_ctl *ctl;
             if (mMixer != NULL) {
                 setAudioRoute(ROUTE_VOICE_OUT, 0);
                 setAudioRoute(ROUTE_VOICE_IN, 0);
                 setAudioRoute(ROUTE_OUTPUT, OUTPUT_RCV);
                 setAudioRoute(ROUTE_INPUT, 0);
                 setMasterVolume_l(mMasterVol);
-                ctl = mixer_get_control(mMixer, "GSM Send Switch", 0);
-                if (ctl)
-                    mixer_ctl_set(ctl, 0);
-                ctl = mixer_get_control(mMixer, "GSM Receive Switch", 0);
-                if (ctl)
-                    mixer_ctl_set(ctl, 0);
+                setMixerControl_l("GSM Send Switch", 0);
+                setMixerControl_l("GSM Receive Switch", 0);
             }
 
             LOGV("setMode() closePcmOut_l()");
@@ -613,10 +812,15 @@ status_t AudioHardware::setMode(int mode)
                 LOGV("setMode() off call force output standby");
                 spOut->doStandby_l();
             }
+            if (spDeepOut != 0) {
+                LOGV("setMode() off call force deep buffer output standby");
+                spDeepOut->doStandby_l();
+            }
             if (spIn != 0) {
                 LOGV("setMode() off call force input standby");
                 spIn->doStandby_l();
             }
+            mCapture->suspend_l();
 
             mInCallAudioMode = false;
         }
@@ -625,6 +829,9 @@ status_t AudioHardware::setMode(int mode)
     if (spIn != 0) {
         spIn->unlock();
     }
+    if (spDeepOut != 0) {
+        spDeepOut->unlock();
+    }
     if (spOut != 0) {
         spOut->unlock();
     }
@@ -693,6 +900,12 @@ status_t AudioHardware::setParameters(const String8& keyValuePairs)
         param.remove(String8(BT_NREC_KEY));
     }
 
+    key = String8(AUDIO_HW_TRACE_EXPORT_KEY);
+    if (param.get(key, value) == NO_ERROR) {
+        sDriverTrace.exportTo(AUDIO_HW_TRACE_EXPORT_FILE);
+        param.remove(key);
+    }
+
 #ifdef HAVE_FM_RADIO
     // fm radio on
     key = String8(AudioParameter::keyFmOn);
@@ -744,7 +957,6 @@ size_t AudioHardware::getInputBufferSize(uint32_t sampleRate, int format, int ch
 void AudioHardware::setOutputVolume(uint32_t device, uint32_t volume)
 {
     const char *name, *name2 = 0;
-    struct mixer_ctl *ctl;
 
     LOGV("AudioHardware::setOutputVolume");
 
@@ -771,17 +983,26 @@ void AudioHardware::setOutputVolume(uint32_t device, uint32_t volume)
     }
 
     if (mMixer) {
-        ctl = mixer_get_control(mMixer, name, 0);
-        if (ctl)
-            mixer_ctl_set(ctl, volume);
+        setMixerControl_l(name, volume);
         if (name2) {
-            ctl = mixer_get_control(mMixer, name2, 0);
-            if (ctl)
-                mixer_ctl_set(ctl, volume);
+            setMixerControl_l(name2, volume);
         }
     }
 }
 
+void AudioHardware::setMixerControl_l(const char *name, unsigned value)
+{
+    TRACE_DRIVER_IN(DRV_MIXER_GET)
+    struct mixer_ctl *ctl = mixer_get_control(mMixer, name, 0);
+    TRACE_DRIVER_OUT(ctl != NULL ? 0 : -1)
+    if (ctl == NULL) {
+        return;
+    }
+    TRACE_DRIVER_IN(DRV_MIXER_SET)
+    int ret = mixer_ctl_update(ctl, value);
+    TRACE_DRIVER_OUT(ret)
+}
+
 status_t AudioHardware::setVoiceVolume(float volume)
 {
     AutoMutex lock(mLock);
@@ -821,14 +1042,77 @@ void AudioHardware::setMasterVolume_l(float volume)
 
     mMasterVol = volume;
 
-    if (mMixer) {
-	struct mixer_ctl *ctl;
-        ctl = mixer_get_control(mMixer, "Master Playback Volume", 0);
-        if (ctl) {
-	    unsigned val = volume * 231;
-            mixer_ctl_set(ctl, CTL_VALUE_RAW | val);
-	}
+    applyMasterVolume_l();
+}
+
+// Returns the codec master volume control and the range of it the master
+// volume maps to: up to the level the current output route sets, or the
+// whole control for a route without one.
+struct mixer_ctl *AudioHardware::masterVolumeRange_l(long *min, long *max)
+{
+    TRACE_DRIVER_IN(DRV_MIXER_GET)
+    struct mixer_ctl *ctl = mixer_get_control(mMixer, "Master Playback Volume", 0);
+    TRACE_DRIVER_OUT(ctl != NULL ? 0 : -1)
+    if (ctl == NULL || mixer_ctl_get_range(ctl, min, max) != 0) {
+        return NULL;
+    }
+    const RoutePin *pin = findRoutePin(findRoute_l(ROUTE_OUTPUT, mRoute[ROUTE_OUTPUT]), ctl);
+    if (pin != NULL && pin->config->intValue < 100) {
+        // same scaling as mixer_ctl_update() for a level in percent
+        *max = *min + (*max - *min) * (long)pin->config->intValue / 100;
+    }
+    return ctl;
+}
+
+// Register writes are slow and change the level in audible steps: the codec
+// is only set to the coarse step at or above the master volume and the output
+// gain ramps down to the exact level. The control is left alone in call,
+// where it carries the voice volume, and when it already holds the step.
+void AudioHardware::applyMasterVolume_l()
+{
+    if (mMixer != NULL && mMode != AudioSystem::MODE_IN_CALL) {
+        long min, max;
+        struct mixer_ctl *ctl = masterVolumeRange_l(&min, &max);
+        if (ctl != NULL) {
+            long step = (long)ceilf(mMasterVol * AUDIO_HW_MASTER_VOL_STEPS);
+            long val = min + (step * (max - min) + AUDIO_HW_MASTER_VOL_STEPS - 1) /
+                    AUDIO_HW_MASTER_VOL_STEPS;
+            TRACE_DRIVER_IN(DRV_MIXER_SET)
+            int ret = mixer_ctl_update(ctl, CTL_VALUE_RAW | (unsigned)val);
+            TRACE_DRIVER_OUT(ret)
+        }
+    }
+
+    float gain = masterGain_l();
+    if (mOutput != 0) {
+        mOutput->setGain(gain);
     }
+    if (mDeepOutput != 0) {
+        mDeepOutput->setGain(gain);
+    }
+}
+
+// Software part of the master volume for the level the codec master volume
+// control holds, whoever wrote it, relative to the output route's level.
+// Without a mixer, or in call, the whole master volume is applied in
+// software. The level is never raised above the codec's.
+float AudioHardware::masterGain_l()
+{
+    float level = 1.0f;
+
+    if (mMixer != NULL && mMode != AudioSystem::MODE_IN_CALL) {
+        long min, max, val;
+        struct mixer_ctl *ctl = masterVolumeRange_l(&min, &max);
+        // served from the mixer's shadow copy, no driver access
+        if (ctl != NULL && max > min && mixer_ctl_get(ctl, 0, &val) == 0) {
+            level = (float)(val - min) / (max - min);
+        }
+    }
+    if (level <= 0.0f) {
+        return 0.0f;
+    }
+    float gain = mMasterVol / level;
+    return (gain < 1.0f) ? gain : 1.0f;
 }
 
 #ifdef HAVE_FM_RADIO
@@ -880,6 +1164,8 @@ status_t AudioHardware::dump(int fd, const Vector<String16>& args)
     result.append(buffer);
     snprintf(buffer, SIZE, "\tMic Mute %s\n", (mMicMute) ? "ON" : "OFF");
     result.append(buffer);
+    snprintf(buffer, SIZE, "\tALSA backend: %s\n", alsa_backend_name());
+    result.append(buffer);
     snprintf(buffer, SIZE, "\tmPcm: %p\n", mPcm);
     result.append(buffer);
     snprintf(buffer, SIZE, "\tmPcmOpenCnt: %d\n", mPcmOpenCnt);
@@ -888,6 +1174,26 @@ status_t AudioHardware::dump(int fd, const Vector<String16>& args)
     result.append(buffer);
     snprintf(buffer, SIZE, "\tmMixerOpenCnt: %d\n", mMixerOpenCnt);
     result.append(buffer);
+    snprintf(buffer, SIZE, "\tMixer open time: %lld us, reused %u times\n",
+             ns2us(mMixerOpenTime), mMixerReuseCnt);
+    result.append(buffer);
+    mRouteTime.dump(result, "\tRoute switch");
+    snprintf(buffer, SIZE, "\tRoute control writes: %u, skipped: %u\n",
+             mRouteWrites, mRouteSkips);
+    result.append(buffer);
+    if (tryLock(mLock)) {
+        struct mixer_ctl *ctl = NULL;
+        long vol;
+
+        if (mMixer != NULL)
+            ctl = mixer_get_control(mMixer, "Master Playback Volume", 0);
+        // served from the mixer's shadow copy, no driver access
+        if (ctl != NULL && mixer_ctl_get(ctl, 0, &vol) == 0) {
+            snprintf(buffer, SIZE, "\tMaster Playback Volume: %ld\n", vol);
+            result.append(buffer);
+        }
+        mLock.unlock();
+    }
     snprintf(buffer, SIZE, "\tIn Call Audio Mode %s\n",
              (mInCallAudioMode) ? "ON" : "OFF");
     result.append(buffer);
@@ -895,6 +1201,7 @@ status_t AudioHardware::dump(int fd, const Vector<String16>& args)
     result.append(buffer);
     snprintf(buffer, SIZE, "\tmDriverOp: %d\n", mDriverOp);
     result.append(buffer);
+    sDriverTrace.dump(result, AUDIO_HW_TRACE_DUMP_SIZE);
 
     snprintf(buffer, SIZE, "\n\tmOutput %p dump:\n", mOutput.get());
     result.append(buffer);
@@ -902,7 +1209,24 @@ status_t AudioHardware::dump(int fd, const Vector<String16>& args)
     if (mOutput != 0) {
         mOutput->dump(fd, args);
     }
+    if (mDeepOutput != 0) {
+        snprintf(buffer, SIZE, "\n\tmDeepOutput %p dump:\n", mDeepOutput.get());
+        write(fd, buffer, strlen(buffer));
+        mDeepOutput->dump(fd, args);
+    }
+    if (tryLock(mMixLock)) {
+        snprintf(buffer, SIZE, "\tPcm writer: %p%s\n", mPcmWriter,
+                 mPcmWriterBusy ? " (writing)" : "");
+        mMixLock.unlock();
+        write(fd, buffer, strlen(buffer));
+    }
 
+    if (tryLock(mLock)) {
+        String8 capture;
+        mCapture->dump(capture);
+        mLock.unlock();
+        write(fd, capture.string(), capture.size());
+    }
     snprintf(buffer, SIZE, "\n\t%d inputs opened:\n", mInputs.size());
     write(fd, buffer, strlen(buffer));
     for (size_t i = 0; i < mInputs.size(); i++) {
@@ -970,12 +1294,12 @@ void AudioHardware::disableFMRadio() {
         // No need to turn off the FM Radio path as the kernel driver will handle that
         TRACE_DRIVER_IN(DRV_MIXER_GET)
         struct mixer_ctl *ctl = mixer_get_control(mMixer, "Codec Status", 0);
-        TRACE_DRIVER_OUT
+        TRACE_DRIVER_OUT(ctl != NULL ? 0 : -1)
 
         if (ctl != NULL) {
             TRACE_DRIVER_IN(DRV_MIXER_SEL)
-            mixer_ctl_select(ctl, "FMR_FLAG_CLEAR");
-            TRACE_DRIVER_OUT
+            int ret = mixer_ctl_select(ctl, "FMR_FLAG_CLEAR");
+            TRACE_DRIVER_OUT(ret)
         }
 
         closeMixer_l();
@@ -989,7 +1313,54 @@ void AudioHardware::disableFMRadio() {
 }
 #endif
 
-struct pcm *AudioHardware::openPcmOut_l()
+AudioHardware::OutputProfile AudioHardware::getOutputProfile()
+{
+    char value[PROPERTY_VALUE_MAX];
+
+    property_get(AUDIO_HW_OUT_PROFILE_PROPERTY, value,
+                 outputProfiles[OUTPUT_PROFILE_NORMAL].name);
+    for (int i = 0; i < OUTPUT_PROFILE_COUNT; i++) {
+        if (strcmp(value, outputProfiles[i].name) == 0) {
+            return (OutputProfile)i;
+        }
+    }
+    LOGW("getOutputProfile() unknown output profile %s", value);
+    return OUTPUT_PROFILE_NORMAL;
+}
+
+// Playback and capture drivers found not to support mmap
+static bool sNoMmap[2];
+
+// Open a pcm with direct access to the kernel buffer, falling back to
+// read/write access when the driver does not support mmap. A driver that
+// cannot map its buffer once is not asked again.
+static struct pcm *openPcm(unsigned flags)
+{
+    bool *noMmap = &sNoMmap[(flags & PCM_IN) ? 1 : 0];
+    if (*noMmap) {
+        return pcm_open(flags);
+    }
+
+    struct pcm *pcm = pcm_open(flags | PCM_MMAP);
+    if (pcm_ready(pcm)) {
+        return pcm;
+    }
+    char error[128];
+    strncpy(error, pcm_error(pcm), sizeof(error) - 1);
+    error[sizeof(error) - 1] = '\0';
+    pcm_close(pcm);
+
+    pcm = pcm_open(flags);
+    // otherwise the failure was not about mmap
+    if (pcm_ready(pcm)) {
+        LOGW("openPcm() %s mmap access not available: %s",
+             (flags & PCM_IN) ? "capture" : "playback", error);
+        *noMmap = true;
+    }
+    return pcm;
+}
+
+struct pcm *AudioHardware::openPcmOut_l(uint32_t periodMult, uint32_t periodCnt)
 {
     LOGD("openPcmOut_l() mPcmOpenCnt: %d", mPcmOpenCnt);
     if (mPcmOpenCnt++ == 0) {
@@ -1000,17 +1371,29 @@ struct pcm *AudioHardware::openPcmOut_l()
         }
         unsigned flags = PCM_OUT;
 
-        flags |= (AUDIO_HW_OUT_PERIOD_MULT - 1) << PCM_PERIOD_SZ_SHIFT;
-        flags |= (AUDIO_HW_OUT_PERIOD_CNT - PCM_PERIOD_CNT_MIN) << PCM_PERIOD_CNT_SHIFT;
+        const OutputProfileConfig *config = &outputProfiles[mOutputProfile];
+        unsigned rateFlags;
+
+        if (getPcmRateFlags(mOutputSampleRate, &rateFlags)) {
+            flags |= rateFlags;
+        }
+        if (periodMult == 0) {
+            periodMult = config->periodMult;
+        }
+        flags |= (periodMult - 1) << PCM_PERIOD_SZ_SHIFT;
+        if (periodCnt == 0) {
+            periodCnt = config->periodCnt;
+        }
+        flags |= (periodCnt - PCM_PERIOD_CNT_MIN) << PCM_PERIOD_CNT_SHIFT;
 
         TRACE_DRIVER_IN(DRV_PCM_OPEN)
-        mPcm = pcm_open(flags);
-        TRACE_DRIVER_OUT
+        mPcm = openPcm(flags);
+        TRACE_DRIVER_OUT(pcm_ready(mPcm) ? 0 : -1)
         if (!pcm_ready(mPcm)) {
             LOGE("openPcmOut_l() cannot open pcm_out driver: %s\n", pcm_error(mPcm));
             TRACE_DRIVER_IN(DRV_PCM_CLOSE)
             pcm_close(mPcm);
-            TRACE_DRIVER_OUT
+            TRACE_DRIVER_OUT(0)
             mPcmOpenCnt--;
             mPcm = NULL;
         }
@@ -1029,7 +1412,7 @@ void AudioHardware::closePcmOut_l()
     if (--mPcmOpenCnt == 0) {
         TRACE_DRIVER_IN(DRV_PCM_CLOSE)
         pcm_close(mPcm);
-        TRACE_DRIVER_OUT
+        TRACE_DRIVER_OUT(0)
         mPcm = NULL;
     }
 }
@@ -1043,14 +1426,26 @@ struct mixer *AudioHardware::openMixer_l()
             mMixerOpenCnt--;
             return NULL;
         }
-        TRACE_DRIVER_IN(DRV_MIXER_OPEN)
-        mMixer = mixer_open();
-        TRACE_DRIVER_OUT
-        if (mMixer == NULL) {
-            LOGE("openMixer_l() cannot open mixer");
-            mMixerOpenCnt--;
-            return NULL;
+        // the control device stays open for the life of the HAL so that
+        // routes are only resolved once
+        if (mMixerHandle == NULL) {
+            nsecs_t start = systemTime();
+            TRACE_DRIVER_IN(DRV_MIXER_OPEN)
+            mMixerHandle = mixer_open();
+            TRACE_DRIVER_OUT(mMixerHandle != NULL ? 0 : -1)
+            if (mMixerHandle == NULL) {
+                LOGE("openMixer_l() cannot open mixer");
+                mMixerOpenCnt--;
+                return NULL;
+            }
+            mMixer = mMixerHandle;
+            resolveRoutes_l();
+            mMixerOpenTime = systemTime() - start;
+            LOGI("mixer opened in %lld us", ns2us(mMixerOpenTime));
+        } else {
+            mMixerReuseCnt++;
         }
+        mMixer = mMixerHandle;
     }
     return mMixer;
 }
@@ -1064,13 +1459,20 @@ void AudioHardware::closeMixer_l()
     }
 
     if (--mMixerOpenCnt == 0) {
-        TRACE_DRIVER_IN(DRV_MIXER_CLOSE)
-        mixer_close(mMixer);
-        TRACE_DRIVER_OUT
         mMixer = NULL;
     }
 }
 
+uint32_t AudioHardware::pcmOutSampleRate_l()
+{
+    return (mPcm != NULL) ? mOutputSampleRate : 0;
+}
+
+uint32_t AudioHardware::pcmInSampleRate_l()
+{
+    return mCapture->sampleRate_l();
+}
+
 uint32_t AudioHardware::getOutputRouteFromDevice(uint32_t device)
 {
 	LOGV("AudioHardware::getOutputRouteFromDevice");
@@ -1167,6 +1569,55 @@ uint32_t AudioHardware::getInputRouteFromDevice(uint32_t device)
     }
 }
 
+bool AudioHardware::getPcmRateFlags(uint32_t rate, unsigned *flags)
+{
+    switch (rate) {
+    case 8000:
+        *flags = PCM_8000HZ;
+        break;
+    case 11025:
+        *flags = PCM_11025HZ;
+        break;
+    case 16000:
+        *flags = PCM_16000HZ;
+        break;
+    case 22050:
+        *flags = PCM_22050HZ;
+        break;
+    case 44100:
+        *flags = PCM_44100HZ;
+        break;
+    case 48000:
+        *flags = PCM_48000HZ;
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+bool AudioHardware::isNativeRate(bool input, uint32_t rate)
+{
+    uint32_t rates = input ? mNativeInRates : mNativeOutRates;
+
+    for (size_t i = 0; i < NUM_PCM_SAMPLING_RATES; i++) {
+        if (pcmSamplingRates[i] == rate) {
+            return (rates & (1 << i)) != 0;
+        }
+    }
+    return false;
+}
+
+bool AudioHardware::isNativeMonoInRate(uint32_t rate)
+{
+    for (size_t i = 0; i < NUM_PCM_SAMPLING_RATES; i++) {
+        if (pcmSamplingRates[i] == rate) {
+            return (mNativeMonoInRates & (1 << i)) != 0;
+        }
+    }
+    return false;
+}
+
 uint32_t AudioHardware::getInputSampleRate(uint32_t sampleRate)
 {
     uint32_t i;
@@ -1189,8 +1640,8 @@ sp <AudioHardware::AudioStreamInALSA> AudioHardware::getActiveInput_l()
     LOGV("AudioHardware::getActiveInput_l");
 
     for (size_t i = 0; i < mInputs.size(); i++) {
-        // return first input found not being in standby mode
-        // as only one input can be in this state
+        // return first input found not being in standby mode, other
+        // active inputs share the same capture pcm
         if (!mInputs[i]->checkStandby()) {
             spIn = mInputs[i];
             break;
@@ -1200,6 +1651,73 @@ sp <AudioHardware::AudioStreamInALSA> AudioHardware::getActiveInput_l()
     return spIn;
 }
 
+// lockActiveOutput_l() must be called with mLock held
+sp<AudioHardware::AudioStreamOutALSA> AudioHardware::lockActiveOutput_l(bool deep)
+{
+    sp<AudioStreamOutALSA> spOut = deep ? mDeepOutput : mOutput;
+
+    while (spOut != 0) {
+        // an output in warm standby still holds the pcm
+        if (!spOut->checkStandby() || spOut->isWarmStandby()) {
+            int cnt = spOut->prepareLock();
+            mLock.unlock();
+            spOut->lock();
+            mLock.lock();
+            // make sure that another thread did not change output state while the
+            // mutex is released
+            if ((spOut == (deep ? mDeepOutput : mOutput)) && (cnt == spOut->standbyCnt())) {
+                break;
+            }
+            spOut->unlock();
+            spOut = deep ? mDeepOutput : mOutput;
+        } else {
+            spOut.clear();
+        }
+    }
+    // spOut is not 0 here only if the output is active or in warm standby
+    return spOut;
+}
+
+bool AudioHardware::acquirePcm(AudioStreamOutALSA *out, sp<AudioStreamOutALSA> *peer)
+{
+    AutoMutex lock(mMixLock);
+
+    *peer = (out == mOutput.get()) ? mDeepOutput : mOutput;
+    if (mPcmWriter != NULL && mPcmWriter != out &&
+            (mPcmWriterBusy || systemTime() - mPcmWriterTime < mPcmWriterIdle)) {
+        return false;
+    }
+    if (mPcmWriter != out) {
+        LOGV("acquirePcm() %s output takes the pcm over",
+             out->isDeep() ? "deep buffer" : "main");
+        mPcmWriter = out;
+        mPcmWriterIdle = out->pcmIdleTimeout();
+    }
+    mPcmWriterBusy = true;
+    return true;
+}
+
+void AudioHardware::releasePcm(AudioStreamOutALSA *out, bool standby)
+{
+    AutoMutex lock(mMixLock);
+
+    if (mPcmWriter != out) {
+        return;
+    }
+    mPcmWriterBusy = false;
+    mPcmWriterTime = systemTime();
+    if (standby) {
+        mPcmWriter = NULL;
+    }
+}
+
+// activePeer_l() must be called with mLock held
+AudioHardware::AudioStreamOutALSA *AudioHardware::activePeer_l(AudioStreamOutALSA *out)
+{
+    AudioStreamOutALSA *peer = (out == mOutput.get()) ? mDeepOutput.get() : mOutput.get();
+    return (peer != NULL && peer != out && !peer->isStandby_l()) ? peer : NULL;
+}
+
 //------------------------------------------------------------------------------
 //  AudioStreamOutALSA
 //------------------------------------------------------------------------------
@@ -1208,13 +1726,26 @@ AudioHardware::AudioStreamOutALSA::AudioStreamOutALSA() :
     mHardware(0), mPcm(0), mMixer(0),
     mStandby(true), mDevices(0), mChannels(AUDIO_HW_OUT_CHANNELS),
     mSampleRate(AUDIO_HW_OUT_SAMPLERATE), mBufferSize(AUDIO_HW_OUT_PERIOD_BYTES),
-    mDriverOp(DRV_NONE), mStandbyCnt(0), mSleepReq(false)
+    mProfile(OUTPUT_PROFILE_NORMAL), mPeriodSize(AUDIO_HW_OUT_PERIOD_SZ),
+    mPeriodCnt(AUDIO_HW_OUT_PERIOD_CNT), mChannelMixer(NULL), mMixBuffer(NULL),
+    mMixFrames(0), mDeep(false), mPcmConfigured(false), mMixRing(NULL),
+    mGainTarget(ChannelMixer::UNITY_GAIN), mGainEnd(ChannelMixer::UNITY_GAIN),
+    mGain(ChannelMixer::UNITY_GAIN << 16), mGainStep(0), mGainRamp(0),
+    mFramesWritten(0), mHwDelay(0),
+    mHwDelayValid(false), mRingFrames(0),
+    mWarmStandby(false), mWarmStandbyTimeout(0), mStartTime(0), mStartWarm(false),
+    mColdStartTime(0), mWarmStartTime(0), mColdStarts(0), mWarmStarts(0),
+    mUnderruns(0), mUnderrunBase(0), mAdapt(false), mAdaptMinCnt(0), mAdaptMaxCnt(0),
+    mAdaptPeriodCnt(0), mAdaptXruns(0), mAdaptLastXruns(0), mAdaptWindowFrames(0),
+    mAdaptStableFrames(0), mAdaptStableMs(AUDIO_HW_OUT_ADAPT_STABLE_MS),
+    mAdaptLowered(false), mAdaptRaises(0), mAdaptLowers(0), mStandbyEntries(0),
+    mDriverOp(DRV_NONE), mDriverOpStart(0), mStandbyCnt(0), mSleepReq(false)
 {
 }
 
 status_t AudioHardware::AudioStreamOutALSA::set(
     AudioHardware* hw, uint32_t devices, int *pFormat,
-    uint32_t *pChannels, uint32_t *pRate)
+    uint32_t *pChannels, uint32_t *pRate, OutputProfile profile, bool deep)
 {
     int lFormat = pFormat ? *pFormat : 0;
     uint32_t lChannels = pChannels ? *pChannels : 0;
@@ -1230,13 +1761,18 @@ status_t AudioHardware::AudioStreamOutALSA::set(
     if (lChannels == 0) lChannels = channels();
     if (lRate == 0) lRate = sampleRate();
 
-    // check values
+    // check values: the codec can be clocked at other rates than the
+    // default one, saving the resampling in AudioFlinger, and mono is
+    // upmixed here rather than by the mixer. The deep buffer output runs at
+    // the rate of the pcm it shares.
+    uint32_t rate = deep ? hw->mOutputSampleRate : sampleRate();
     if ((lFormat != format()) ||
-        (lChannels != channels()) ||
-        (lRate != sampleRate())) {
+        (lChannels != AUDIO_HW_OUT_CHANNELS &&
+         lChannels != AudioSystem::CHANNEL_OUT_MONO) ||
+        (lRate != rate && (deep || !hw->isNativeRate(false, lRate)))) {
         if (pFormat) *pFormat = format();
         if (pChannels) *pChannels = channels();
-        if (pRate) *pRate = sampleRate();
+        if (pRate) *pRate = rate;
         return BAD_VALUE;
     }
 
@@ -1246,109 +1782,524 @@ status_t AudioHardware::AudioStreamOutALSA::set(
 
     mChannels = lChannels;
     mSampleRate = lRate;
-    mBufferSize = AUDIO_HW_OUT_PERIOD_BYTES;
+    mProfile = profile;
+    mPeriodSize = PCM_PERIOD_SZ_MIN * outputProfiles[profile].periodMult;
+    mPeriodCnt = outputProfiles[profile].periodCnt;
+    mBufferSize = mPeriodSize * frameSize();
+    mDeep = deep;
+    if (mDeep) {
+        // write half the kernel buffer at a time
+        mBufferSize *= mPeriodCnt / 2;
+    }
+    mMixFrames = mPeriodSize;
+
+    if (mChannels != AUDIO_HW_OUT_CHANNELS) {
+        mChannelMixer = new ChannelMixer(2, AudioSystem::popCount(mChannels),
+                                         mMixFrames, NULL);
+        status_t status = mChannelMixer->initCheck();
+        if (status != NO_ERROR) {
+            delete mChannelMixer;
+            mChannelMixer = NULL;
+            LOGW("AudioStreamOutALSA::set() channel mixer init failed: %d", status);
+            return status;
+        }
+    }
+    mMixBuffer = new int16_t[mMixFrames * 2];
+    mMixRing = new RingBuffer(AUDIO_HW_OUT_MIX_RING_FRAMES * 2 * sizeof(int16_t));
+    if (mMixRing->initCheck() != NO_ERROR) {
+        LOGW("AudioStreamOutALSA::set() cannot allocate mix queue");
+        return NO_MEMORY;
+    }
+
+    LOGI("AudioStreamOutALSA::set() %s%s profile, %d x %d frames",
+         mDeep ? "deep output, " : "", outputProfiles[profile].name,
+         mPeriodCnt, mPeriodSize);
+
+    char value[PROPERTY_VALUE_MAX];
+    property_get(AUDIO_HW_OUT_WRITER_PROPERTY, value, "0");
+    // the deep buffer output wakes up rarely enough without a writer thread
+    if (!mDeep && (!strcmp(value, "1") || !strcasecmp(value, "true"))) {
+        sp<OutputWriter> writer = new OutputWriter(this,
+                mBufferSize * AUDIO_HW_OUT_WRITER_BUFFERS, mSampleRate);
+        if (writer->initCheck() == NO_ERROR &&
+                writer->run("AudioOutWriter", ANDROID_PRIORITY_URGENT_AUDIO) == NO_ERROR) {
+            mWriter = writer;
+            mRingFrames = writer->size() / frameSize();
+        } else {
+            LOGE("AudioStreamOutALSA::set() cannot start writer thread");
+        }
+    }
+
+    property_get(AUDIO_HW_OUT_ADAPT_PROPERTY, value, "1");
+    mAdapt = !mDeep && strcmp(value, "0") && strcasecmp(value, "false");
+    mAdaptMinCnt = mPeriodCnt;
+    mAdaptMaxCnt = (mPeriodCnt > AUDIO_HW_OUT_ADAPT_MAX_PERIOD_CNT) ?
+            mPeriodCnt : AUDIO_HW_OUT_ADAPT_MAX_PERIOD_CNT;
+    mAdaptPeriodCnt = mPeriodCnt;
+
+    property_get(AUDIO_HW_OUT_WARM_STANDBY_PROPERTY, value, "");
+    int warmMs = (value[0] != 0) ? atoi(value) : AUDIO_HW_OUT_WARM_STANDBY_MS;
+    if (warmMs > 0) {
+        sp<StandbyTimer> timer = new StandbyTimer(this);
+        if (timer->run("AudioOutStandby", ANDROID_PRIORITY_AUDIO) == NO_ERROR) {
+            mStandbyTimer = timer;
+            mWarmStandbyTimeout = milliseconds(warmMs);
+        }
+    }
 
     return NO_ERROR;
 }
 
 AudioHardware::AudioStreamOutALSA::~AudioStreamOutALSA()
 {
+    if (mWriter != 0) {
+        mWriter->stop();
+        mWriter.clear();
+    }
+    // stopped first so that it cannot demote a stream being deleted:
+    // standby() then closes the pcm even from warm standby
+    if (mStandbyTimer != 0) {
+        mStandbyTimer->stop();
+        mStandbyTimer.clear();
+    }
     standby();
+    delete mChannelMixer;
+    delete[] mMixBuffer;
+    delete mMixRing;
 }
 
 ssize_t AudioHardware::AudioStreamOutALSA::write(const void* buffer, size_t bytes)
 {
     //    LOGV("AudioStreamOutALSA::write(%p, %u)", buffer, bytes);
-    status_t status = NO_INIT;
-    const uint8_t* p = static_cast<const uint8_t*>(buffer);
-    int ret;
 
     if (mHardware == NULL) return NO_INIT;
 
-    if (mSleepReq) {
-        // 10ms are always shorter than the time to reconfigure the audio path
-        // which is the only condition when mSleepReq would be true.
-        usleep(10000);
+    nsecs_t start = systemTime();
+    ssize_t ret;
+
+    if (mWriter != 0) {
+        ret = mWriter->write(buffer, bytes);
+        mWriteTime.add(systemTime() - start);
+        return ret;
     }
 
     // bump thread priority to speed up mutex acquisition
     int  priority = getpriority(PRIO_PROCESS, 0);
     setpriority(PRIO_PROCESS, 0, ANDROID_PRIORITY_URGENT_AUDIO);
 
-    { // scope for the lock
+    ret = writePcm(buffer, bytes);
 
-        AutoMutex lock(mLock);
+    setpriority(PRIO_PROCESS, 0, priority);
 
-        if (mStandby) {
-            AutoMutex hwLock(mHardware->lock());
+    if (ret < 0) {
+        doStandby();
 
-            LOGD("AudioHardware pcm playback is exiting standby.");
-            acquire_wake_lock (PARTIAL_WAKE_LOCK, "AudioOutLock");
-
-            sp<AudioStreamInALSA> spIn = mHardware->getActiveInput_l();
-            while (spIn != 0) {
-                int cnt = spIn->prepareLock();
-                mHardware->lock().unlock();
-                // Mutex acquisition order is always out -> in -> hw
-                spIn->lock();
-                mHardware->lock().lock();
-                // make sure that another thread did not change input state
-                // while the mutex is released
-                if ((spIn == mHardware->getActiveInput_l()) &&
-                        (cnt == spIn->standbyCnt())) {
-                    LOGV("AudioStreamOutALSA::write() force input standby");
-                    spIn->close_l();
-                    break;
-                }
-                spIn->unlock();
-                spIn = mHardware->getActiveInput_l();
-            }
-            // spIn is not 0 here only if the input was active and has been
-            // closed above
+        // Simulate audio output timing in case of error
+        usleep((((bytes * 1000) / frameSize()) * 1000) / sampleRate());
+    }
+    mWriteTime.add(systemTime() - start);
+    return ret;
+}
 
-            // open output before input
-            open_l();
+ssize_t AudioHardware::AudioStreamOutALSA::writePcm(const void* buffer, size_t bytes)
+{
+    const int16_t *in = static_cast<const int16_t *>(buffer);
+    const uint32_t channelCount = AudioSystem::popCount(mChannels);
+    size_t frames = bytes / frameSize();
 
-            if (spIn != 0) {
-                if (spIn->open_l() != NO_ERROR) {
-                    spIn->doStandby_l();
-                }
-                spIn->unlock();
-            }
-            if (mPcm == NULL) {
-                release_wake_lock("AudioOutLock");
-                goto Error;
-            }
-            mStandby = false;
-        }
+    if (mSleepReq) {
+        // 10ms are always shorter than the time to reconfigure the audio path
+        // which is the only condition when mSleepReq would be true.
+        usleep(10000);
+    }
 
-        TRACE_DRIVER_IN(DRV_PCM_WRITE)
-        ret = pcm_write(mPcm,(void*) p, bytes);
-        TRACE_DRIVER_OUT
+    while (frames) {
+        size_t count = frames;
+        bool queued = false;
+        // released after mLock: the last reference to a closed output may
+        // be dropped here
+        sp<AudioStreamOutALSA> peer;
 
-        if (ret == 0) {
-            setpriority(PRIO_PROCESS, 0, priority);
-            return bytes;
+        { // scope for the lock
+
+            AutoMutex lock(mLock);
+
+            if (mStandby && exitStandby_l() != NO_ERROR) {
+                return NO_INIT;
+            }
+
+            if (mHardware->acquirePcm(this, &peer)) {
+                // short chunks let the other output take turns on the pcm
+                if (peer != 0 && count > mMixFrames) {
+                    count = mMixFrames;
+                }
+                nsecs_t start = systemTime();
+                int ret = writeOwner_l(in, count, peer);
+                int err = errno;
+                mDriverTime.add(systemTime() - start);
+                mHardware->releasePcm(this);
+
+                if (ret != 0) {
+                    LOGW("write error: %d %s", err,
+                         (mPcm != NULL) ? pcm_error(mPcm) : "pcm closed");
+                    return (err != 0) ? -err : NO_INIT;
+                }
+                if (mStartTime != 0) {
+                    nsecs_t startTime = systemTime() - mStartTime;
+                    if (mStartWarm) {
+                        mWarmStartTime = startTime;
+                        mWarmStarts++;
+                    } else {
+                        mColdStartTime = startTime;
+                        mColdStarts++;
+                    }
+                    mStartTime = 0;
+                }
+                mFramesWritten += count;
+                if (mAdapt && mPcmConfigured) {
+                    adaptPeriods_l(count);
+                }
+                if (mPcm != NULL && !mHwDelayValid) {
+                    updateHwDelay_l();
+                }
+            } else {
+                count = queueMix_l(in, count);
+                mFramesWritten += count;
+                queued = true;
+            }
+        }
+
+        if (queued && count == 0) {
+            waitForMixSpace();
         }
-        LOGW("write error: %d %s", errno, pcm_error(mPcm));
-        status = -errno;
+        in += count * channelCount;
+        frames -= count;
     }
 
-    setpriority(PRIO_PROCESS, 0, priority);
+    return bytes;
+}
 
-Error:
-    standby();
+// Called with mLock held
+status_t AudioHardware::AudioStreamOutALSA::exitStandby_l()
+{
+    AutoMutex hwLock(mHardware->lock());
 
-    // Simulate audio output timing in case of error
-    usleep((((bytes * 1000) / frameSize()) * 1000) / sampleRate());
+    LOGD("AudioHardware pcm playback is exiting standby.");
+    acquire_wake_lock (PARTIAL_WAKE_LOCK, "AudioOutLock");
+    mStartTime = systemTime();
+    // a pending change of the period count needs a cold start, and a pcm
+    // the other output plays on cannot be prepared again
+    mStartWarm = mWarmStandby && mPeriodCnt == mAdaptPeriodCnt &&
+            mHardware->activePeer_l(this) == NULL &&
+            (exitWarmStandby_l() == NO_ERROR);
+    if (!mStartWarm) {
+        close_l();
 
-    return status;
+        // the capture keeps running unless the codec clock must change
+        // for the output rate: it is then reopened after the output
+        uint32_t inRate = mHardware->pcmInSampleRate_l();
+        bool reclock = (inRate != 0 && inRate != mSampleRate);
+        if (reclock) {
+            LOGV("AudioStreamOutALSA::write() suspend capture at %d Hz", inRate);
+            mHardware->mCapture->suspend_l();
+        }
+
+        // open output before input
+        open_l();
+
+        if (reclock) {
+            mHardware->mCapture->resume_l(mHardware->pcmOutSampleRate_l());
+        }
+    }
+    if (mPcm == NULL) {
+        release_wake_lock("AudioOutLock");
+        return NO_INIT;
+    }
+
+    // frames queued before the standby are not played any more: the output
+    // mixing them skips them
+    mMixRing->discard();
+
+    mStandby = false;
+    mFramesWritten = 0;
+    mHwDelayValid = false;
+    // nothing is playing: no need to ramp to the current gain
+    latchGain_l(false);
+    return NO_ERROR;
+}
+
+// Write frames as the pcm writer, mixing in those queued by peer. Called
+// with mLock held.
+int AudioHardware::AudioStreamOutALSA::writeOwner_l(const int16_t *in, size_t frames,
+                                                    const sp<AudioStreamOutALSA>& peer)
+{
+    int ret = flushMix_l();
+    if (ret == 0 && !mPcmConfigured) {
+        ret = reconfigure_l();
+    }
+    if (ret != 0) {
+        return ret;
+    }
+
+    bool mix = (peer != 0 && peer->mixQueued() != 0);
+    if (latchGain_l(true) || mChannelMixer != NULL || mix) {
+        return render_l(in, frames, mix ? peer.get() : NULL);
+    }
+    TRACE_DRIVER_IN(DRV_PCM_WRITE)
+    ret = pcm_write(mPcm, (void *)in, frames * frameSize());
+    TRACE_DRIVER_OUT(ret)
+    return ret;
+}
+
+// Frames this stream queued while the other output was the writer go to the
+// pcm before the new ones.
+int AudioHardware::AudioStreamOutALSA::flushMix_l()
+{
+    void *data;
+    size_t bytes;
+
+    while ((bytes = mMixRing->peek(&data)) != 0) {
+        TRACE_DRIVER_IN(DRV_PCM_WRITE)
+        int ret = pcm_write(mPcm, data, bytes);
+        TRACE_DRIVER_OUT(ret)
+        mMixRing->advance(bytes);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    return 0;
+}
+
+// The pcm is configured by the output opening it. Once the other output
+// left, the frames queued in the kernel buffer are played and the pcm is
+// reopened with the configuration of this stream: the deep buffer output
+// only saves power with its own, and UI sounds should not keep its latency.
+// This leaves a gap of a few ms in the playback, once.
+int AudioHardware::AudioStreamOutALSA::reconfigure_l()
+{
+    {
+        AutoMutex hwLock(mHardware->lock());
+        if (mHardware->mPcmOpenCnt != 1) {
+            return 0;
+        }
+    }
+
+    int delay;
+    TRACE_DRIVER_IN(DRV_PCM_STATUS)
+    int ret = pcm_get_delay(mPcm, &delay);
+    TRACE_DRIVER_OUT(ret)
+    if (ret == 0 && delay > 0) {
+        usleep(((uint64_t)delay * 1000000) / mSampleRate);
+    }
+
+    AutoMutex hwLock(mHardware->lock());
+    // a call or the other output may have started meanwhile
+    if (mHardware->mPcmOpenCnt != 1) {
+        return 0;
+    }
+    LOGI("AudioStreamOutALSA: reopening the pcm with the %s profile",
+         outputProfiles[mProfile].name);
+    close_l();
+    if (open_l() != NO_ERROR) {
+        doStandby_l();
+        return -1;
+    }
+    mHwDelayValid = false;
+    return 0;
+}
+
+// Queue frames for the output writing to the pcm, as many as fit. Returns
+// the number of frames queued. Called with mLock held.
+size_t AudioHardware::AudioStreamOutALSA::queueMix_l(const int16_t *in, size_t frames)
+{
+    size_t count = mMixRing->availableToWrite() / (2 * sizeof(int16_t));
+
+    if (count > frames) {
+        count = frames;
+    }
+    if (count > mMixFrames) {
+        count = mMixFrames;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    latchGain_l(true);
+    convert_l(in, mMixBuffer, count);
+    mMixRing->write(mMixBuffer, count * 2 * sizeof(int16_t));
+    return count;
+}
+
+// Wait for the writer to mix some of the queued frames. The wait is bounded
+// as the writer may go to standby in between.
+void AudioHardware::AudioStreamOutALSA::waitForMixSpace()
+{
+    AutoMutex lock(mMixWaitLock);
+    if (mMixRing->availableToWrite() < 2 * sizeof(int16_t)) {
+        mMixSpaceCond.waitRelative(mMixWaitLock, milliseconds(AUDIO_HW_OUT_MIX_WAIT_MS));
+    }
+}
+
+nsecs_t AudioHardware::AudioStreamOutALSA::pcmIdleTimeout()
+{
+    return seconds((nsecs_t)mPeriodSize * mPeriodCnt) / mSampleRate / 2;
+}
+
+// Adjust the buffer depth to the underruns counted by the driver after
+// frames were written. Called with mLock held and the stream out of standby.
+void AudioHardware::AudioStreamOutALSA::adaptPeriods_l(size_t frames)
+{
+    uint32_t xruns = pcm_get_xruns(mPcm);
+    uint32_t newXruns = xruns - mAdaptLastXruns;
+    mAdaptLastXruns = xruns;
+
+    if (mAdaptXruns != 0) {
+        mAdaptWindowFrames += frames;
+        if (mAdaptWindowFrames > (mSampleRate * AUDIO_HW_OUT_ADAPT_WINDOW_MS) / 1000) {
+            mAdaptXruns = 0;
+        }
+    }
+
+    if (newXruns == 0) {
+        mAdaptStableFrames += frames;
+        if (mAdaptStableFrames < ((uint64_t)mSampleRate * mAdaptStableMs) / 1000) {
+            return;
+        }
+        mAdaptStableFrames = 0;
+        // removing a period at once would glitch: it is done on the next open
+        mAdaptLowered = (mAdaptPeriodCnt > mAdaptMinCnt);
+        if (mAdaptLowered) {
+            mAdaptPeriodCnt--;
+            mAdaptLowers++;
+            LOGI("AudioStreamOutALSA: no underrun for %u ms, %u periods from next start",
+                 mAdaptStableMs, mAdaptPeriodCnt);
+        }
+        return;
+    }
+
+    mAdaptStableFrames = 0;
+    if (mAdaptXruns == 0) {
+        mAdaptWindowFrames = 0;
+    }
+    mAdaptXruns += newXruns;
+    if (mAdaptXruns < AUDIO_HW_OUT_ADAPT_XRUNS || mAdaptPeriodCnt >= mAdaptMaxCnt) {
+        return;
+    }
+    mAdaptXruns = 0;
+
+    // the last period removed was needed: wait longer before the next one
+    if (mAdaptLowered && mAdaptStableMs < AUDIO_HW_OUT_ADAPT_STABLE_MAX_MS) {
+        mAdaptStableMs *= 2;
+    }
+    mAdaptLowered = false;
+    mAdaptPeriodCnt++;
+    mAdaptRaises++;
+    // reopening the pcm now would drop the frames queued in the kernel and
+    // make the render position jump: it is done on the next open as well
+    LOGW("AudioStreamOutALSA: %d underruns within %d ms, %u periods from next start",
+         AUDIO_HW_OUT_ADAPT_XRUNS, AUDIO_HW_OUT_ADAPT_WINDOW_MS, mAdaptPeriodCnt);
+}
+
+void AudioHardware::AudioStreamOutALSA::setGain(float gain)
+{
+    if (gain < 0.0f) {
+        gain = 0.0f;
+    } else if (gain > 1.0f) {
+        gain = 1.0f;
+    }
+    android_atomic_release_store((int32_t)(gain * ChannelMixer::UNITY_GAIN + 0.5f),
+                                 &mGainTarget);
+}
+
+// Pick up the last gain set, through a ramp if ramp is true. Returns true if
+// the gain is not unity or still ramping.
+bool AudioHardware::AudioStreamOutALSA::latchGain_l(bool ramp)
+{
+    int32_t target = android_atomic_acquire_load(&mGainTarget);
+
+    if (target != mGainEnd || !ramp) {
+        mGainEnd = target;
+        mGainRamp = ramp ? (mSampleRate * AUDIO_HW_OUT_GAIN_RAMP_MS) / 1000 : 0;
+        if (mGainRamp != 0) {
+            mGainStep = ((target << 16) - mGain) / (int32_t)mGainRamp;
+        } else {
+            mGain = target << 16;
+        }
+    }
+    return mGainRamp != 0 || mGainEnd != ChannelMixer::UNITY_GAIN;
+}
+
+// Write frames through the channel conversion and the software gain, mixing
+// in the frames queued by peer if not NULL. With an mmapped pcm they are
+// rendered straight into the kernel buffer, otherwise mMixFrames at a time
+// through mMixBuffer.
+int AudioHardware::AudioStreamOutALSA::render_l(const int16_t *in, size_t frames,
+                                                AudioStreamOutALSA *peer)
+{
+    const uint32_t channelCount = AudioSystem::popCount(mChannels);
+    const bool direct = pcm_mmap_enabled(mPcm);
+    int ret = 0;
+
+    while (frames && ret == 0) {
+        unsigned count = (frames > mMixFrames) ? mMixFrames : frames;
+        int16_t *out = mMixBuffer;
+
+        if (direct) {
+            void *data;
+            TRACE_DRIVER_IN(DRV_PCM_MMAP_BEGIN)
+            ret = pcm_mmap_begin(mPcm, &data, &count);
+            TRACE_DRIVER_OUT(ret)
+            if (ret != 0) {
+                break;
+            }
+            out = (int16_t *)data;
+        }
+
+        convert_l(in, out, count);
+        if (peer != NULL) {
+            peer->mixInto(out, count);
+        }
+
+        if (direct) {
+            TRACE_DRIVER_IN(DRV_PCM_MMAP_COMMIT)
+            ret = pcm_mmap_commit(mPcm, count);
+            TRACE_DRIVER_OUT(ret)
+        } else {
+            TRACE_DRIVER_IN(DRV_PCM_WRITE)
+            ret = pcm_write(mPcm, out, count * 2 * sizeof(int16_t));
+            TRACE_DRIVER_OUT(ret)
+        }
+        in += count * channelCount;
+        frames -= count;
+    }
+    return ret;
+}
+
+// Stereo frames at the output gain
+void AudioHardware::AudioStreamOutALSA::convert_l(const int16_t *in, int16_t *out,
+                                                  size_t frames)
+{
+    if (mChannelMixer != NULL) {
+        mChannelMixer->process(in, out, frames);
+        applyGain_l(out, out, frames);
+    } else {
+        applyGain_l(in, out, frames);
+    }
 }
 
 status_t AudioHardware::AudioStreamOutALSA::standby()
 {
     if (mHardware == NULL) return NO_INIT;
 
+    if (mWriter != 0) {
+        mWriter->drain();
+    }
+    doStandby(true);
+
+    return NO_ERROR;
+}
+
+void AudioHardware::AudioStreamOutALSA::doStandby(bool warm)
+{
     mSleepReq = true;
     {
         AutoMutex lock(mLock);
@@ -1357,13 +2308,83 @@ status_t AudioHardware::AudioStreamOutALSA::standby()
         { // scope for the AudioHardware lock
             AutoMutex hwLock(mHardware->lock());
 
-            doStandby_l();
+            if (!warm || !enterWarmStandby_l()) {
+                doStandby_l();
+            }
         }
     }
+}
+
+// Stop the pcm but keep it configured and the mixer paths set, so that the
+// next write() only has to prepare it. The pcm is closed if the stream
+// stays idle for mWarmStandbyTimeout. Not possible while the other output
+// plays on the pcm.
+bool AudioHardware::AudioStreamOutALSA::enterWarmStandby_l()
+{
+    if (mStandbyTimer == 0 || mPcm == NULL ||
+            mHardware->activePeer_l(this) != NULL) {
+        return false;
+    }
+    if (mWarmStandby) {
+        return true;
+    }
+
+    mStandbyCnt++;
+
+    TRACE_DRIVER_IN(DRV_PCM_STOP)
+    int ret = pcm_stop(mPcm);
+    TRACE_DRIVER_OUT(ret)
+    if (ret != 0) {
+        LOGW("cannot stop pcm_out driver: %s", pcm_error(mPcm));
+        return false;
+    }
+
+    if (!mStandby) {
+        LOGD("AudioHardware pcm playback is going to warm standby.");
+        release_wake_lock("AudioOutLock");
+        mStandby = true;
+        mStandbyEntries++;
+    }
+    mHardware->releasePcm(this, true);
+    mWarmStandby = true;
+    mStandbyTimer->arm(mWarmStandbyTimeout);
+    return true;
+}
+
+status_t AudioHardware::AudioStreamOutALSA::exitWarmStandby_l()
+{
+    mWarmStandby = false;
+    mStandbyTimer->cancel();
+
+    TRACE_DRIVER_IN(DRV_PCM_PREPARE)
+    int ret = pcm_prepare(mPcm);
+    TRACE_DRIVER_OUT(ret)
+    if (ret != 0) {
+        LOGW("cannot prepare pcm_out driver: %s", pcm_error(mPcm));
+        return NO_INIT;
+    }
 
+    // the route may have been changed by another stream meanwhile
+    if (mHardware->mode() != AudioSystem::MODE_IN_CALL) {
+        uint32_t route = mHardware->getOutputRouteFromDevice(mDevices);
+        mHardware->setAudioRoute(ROUTE_OUTPUT, route);
+    }
     return NO_ERROR;
 }
 
+void AudioHardware::AudioStreamOutALSA::demoteStandby()
+{
+    mSleepReq = true;
+    AutoMutex lock(mLock);
+    mSleepReq = false;
+    AutoMutex hwLock(mHardware->lock());
+
+    if (mStandby && mWarmStandby) {
+        LOGD("AudioHardware pcm playback warm standby expired.");
+        close_l();
+    }
+}
+
 void AudioHardware::AudioStreamOutALSA::doStandby_l()
 {
     mStandbyCnt++;
@@ -1372,18 +2393,28 @@ void AudioHardware::AudioStreamOutALSA::doStandby_l()
         LOGD("AudioHardware pcm playback is going to standby.");
         release_wake_lock("AudioOutLock");
         mStandby = true;
+        mStandbyEntries++;
     }
+    mHardware->releasePcm(this, true);
 
     close_l();
 }
 
 void AudioHardware::AudioStreamOutALSA::close_l()
 {
+    if (mWarmStandby) {
+        mWarmStandby = false;
+        // the timer is already gone when closed from the destructor
+        if (mStandbyTimer != 0) {
+            mStandbyTimer->cancel();
+        }
+    }
     if (mMixer) {
         mHardware->closeMixer_l();
         mMixer = NULL;
     }
     if (mPcm) {
+        mUnderruns += pcm_get_xruns(mPcm) - mUnderrunBase;
         mHardware->closePcmOut_l();
         mPcm = NULL;
     }
@@ -1392,10 +2423,18 @@ void AudioHardware::AudioStreamOutALSA::close_l()
 status_t AudioHardware::AudioStreamOutALSA::open_l()
 {
     LOGV("open pcm_out driver");
-    mPcm = mHardware->openPcmOut_l();
+    mPcm = mHardware->openPcmOut_l(outputProfiles[mProfile].periodMult, mAdaptPeriodCnt);
     if (mPcm == NULL) {
         return NO_INIT;
     }
+    // otherwise it is configured for the call or the other output
+    mPcmConfigured = (mHardware->mPcmOpenCnt == 1);
+    // the pcm may be shared with the voice call path
+    mUnderrunBase = pcm_get_xruns(mPcm);
+    mAdaptLastXruns = mUnderrunBase;
+    // the driver may have rounded the period size up
+    mPeriodSize = pcm_period_size(mPcm);
+    mPeriodCnt = pcm_buffer_size(mPcm) / mPeriodSize;
 
     mMixer = mHardware->openMixer_l();
     if (mMixer) {
@@ -1406,6 +2445,8 @@ status_t AudioHardware::AudioStreamOutALSA::open_l()
         LOGV("write() wakeup setting route %d", route);
         mHardware->setAudioRoute(ROUTE_OUTPUT, route);
     }
+    // the master volume could not reach the codec while the mixer was closed
+    mHardware->applyMasterVolume_l();
     return NO_ERROR;
 }
 
@@ -1428,7 +2469,11 @@ status_t AudioHardware::AudioStreamOutALSA::dump(int fd, const Vector<String16>&
     result.append(buffer);
     snprintf(buffer, SIZE, "\t\tmMixer: %p\n", mMixer);
     result.append(buffer);
-    snprintf(buffer, SIZE, "\t\tStandby %s\n", (mStandby) ? "ON" : "OFF");
+    snprintf(buffer, SIZE, "\t\tStandby %s%s\n", (mStandby) ? "ON" : "OFF",
+             (mWarmStandby) ? " (warm)" : "");
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\t\tStart of sound: cold %lld us (%u), warm %lld us (%u)\n",
+             ns2us(mColdStartTime), mColdStarts, ns2us(mWarmStartTime), mWarmStarts);
     result.append(buffer);
     snprintf(buffer, SIZE, "\t\tmDevices: 0x%08x\n", mDevices);
     result.append(buffer);
@@ -1438,8 +2483,38 @@ status_t AudioHardware::AudioStreamOutALSA::dump(int fd, const Vector<String16>&
     result.append(buffer);
     snprintf(buffer, SIZE, "\t\tmBufferSize: %d\n", mBufferSize);
     result.append(buffer);
+    snprintf(buffer, SIZE, "\t\tProfile: %s (%d x %d frames, latency %d ms)\n",
+             outputProfiles[mProfile].name, mPeriodCnt, mPeriodSize, latency());
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\t\tmFramesWritten: %u hw delay: %u frames%s\n",
+             mFramesWritten, mHwDelay, mHwDelayValid ? "" : " (not measured)");
+    result.append(buffer);
     snprintf(buffer, SIZE, "\t\tmDriverOp: %d\n", mDriverOp);
     result.append(buffer);
+    snprintf(buffer, SIZE, "\t\tGain: %d/%d%s\n", mGain >> 16,
+             ChannelMixer::UNITY_GAIN, mGainRamp ? " (ramping)" : "");
+    result.append(buffer);
+    if (mAdapt) {
+        snprintf(buffer, SIZE, "\t\tAdaptive periods: %u next start (%u..%u), "
+                 "%u added, %u removed, stable %u/%u ms\n",
+                 mAdaptPeriodCnt, mAdaptMinCnt, mAdaptMaxCnt, mAdaptRaises,
+                 mAdaptLowers, (uint32_t)(((uint64_t)mAdaptStableFrames * 1000) / mSampleRate),
+                 mAdaptStableMs);
+        result.append(buffer);
+    }
+    snprintf(buffer, SIZE, "\t\tMix queue: %u frames, pcm %s\n",
+             mMixRing ? mixQueued() : 0,
+             mPcmConfigured ? "configured by this output" : "shared");
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\t\tUnderruns: %u, standby entries: %u\n",
+             mUnderruns + (mPcm ? pcm_get_xruns(mPcm) - mUnderrunBase : 0),
+             mStandbyEntries);
+    result.append(buffer);
+    mWriteTime.dump(result, "\t\twrite()");
+    mDriverTime.dump(result, "\t\tpcm_write()");
+    if (mWriter != 0) {
+        mWriter->dump(result);
+    }
 
     ::write(fd, result.string(), result.size());
 
@@ -1482,52 +2557,918 @@ status_t AudioHardware::AudioStreamOutALSA::setParameters(const String8& keyValu
             param.remove(String8(AudioParameter::keyRouting));
         }
     }
-
-    if (param.size()) {
-        status = BAD_VALUE;
+
+    if (param.size()) {
+        status = BAD_VALUE;
+    }
+
+
+    return status;
+
+}
+
+String8 AudioHardware::AudioStreamOutALSA::getParameters(const String8& keys)
+{
+    AudioParameter param = AudioParameter(keys);
+    String8 value;
+    String8 key = String8(AudioParameter::keyRouting);
+
+    if (param.get(key, value) == NO_ERROR) {
+        param.addInt(key, (int)mDevices);
+    }
+
+    LOGV("AudioStreamOutALSA::getParameters() %s", param.toString().string());
+    return param.toString();
+}
+
+// Measure the delay the driver reports beyond the frames queued in the
+// kernel buffer (DMA FIFOs, codec...)
+void AudioHardware::AudioStreamOutALSA::updateHwDelay_l()
+{
+    int delay;
+    unsigned avail;
+    struct timespec tstamp;
+
+    TRACE_DRIVER_IN(DRV_PCM_STATUS)
+    int ret = pcm_get_delay(mPcm, &delay);
+    if (ret == 0) {
+        ret = pcm_get_htimestamp(mPcm, &avail, &tstamp);
+    }
+    TRACE_DRIVER_OUT(ret)
+    if (ret != 0) {
+        return;
+    }
+    int queued = (int)pcm_buffer_size(mPcm) - (int)avail;
+    mHwDelay = (queued >= 0 && delay > queued) ? delay - queued : 0;
+    mHwDelayValid = true;
+    LOGV("updateHwDelay_l() delay %d queued %d: hw delay %d frames",
+         delay, queued, mHwDelay);
+}
+
+status_t AudioHardware::AudioStreamOutALSA::getRenderPosition(uint32_t *dspFrames)
+{
+    unsigned avail;
+    struct timespec tstamp;
+    struct timespec now;
+
+    if (dspFrames == NULL) {
+        return BAD_VALUE;
+    }
+
+    AutoMutex lock(mLock);
+
+    if (mStandby || mPcm == NULL) {
+        *dspFrames = 0;
+        return NO_ERROR;
+    }
+
+    TRACE_DRIVER_IN(DRV_PCM_STATUS)
+    int ret = pcm_get_htimestamp(mPcm, &avail, &tstamp);
+    TRACE_DRIVER_OUT(ret)
+    if (ret != 0) {
+        return INVALID_OPERATION;
+    }
+
+    // frames consumed by the DMA when the hardware pointer was last updated,
+    // minus those still in flight to the DAC
+    int64_t queued = (int64_t)pcm_buffer_size(mPcm) - avail;
+    if (queued < 0) {
+        // underrun: everything written has been played
+        queued = 0;
+    }
+    // frames queued for the other output to mix did not reach the pcm yet
+    int64_t rendered = (int64_t)mFramesWritten - mixQueued() - queued - mHwDelay;
+
+    // account for the time elapsed since that update, up to one period, as
+    // the driver may only move the pointer on period interrupts
+    if (rendered > 0) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int64_t elapsedNs = (int64_t)(now.tv_sec - tstamp.tv_sec) * 1000000000LL +
+                (now.tv_nsec - tstamp.tv_nsec);
+        if (elapsedNs > 0) {
+            int64_t frames = (elapsedNs * mSampleRate) / 1000000000LL;
+            if (frames > mPeriodSize) {
+                frames = mPeriodSize;
+            }
+            if (frames > queued) {
+                frames = queued;
+            }
+            rendered += frames;
+        }
+    }
+
+    if (rendered < 0) {
+        rendered = 0;
+    } else if (rendered > mFramesWritten) {
+        rendered = mFramesWritten;
+    }
+    *dspFrames = (uint32_t)rendered;
+    return NO_ERROR;
+}
+
+int AudioHardware::AudioStreamOutALSA::prepareLock()
+{
+    // request sleep next time write() is called so that caller can acquire
+    // mLock
+    mSleepReq = true;
+    return mStandbyCnt;
+}
+
+void AudioHardware::AudioStreamOutALSA::lock()
+{
+    mLock.lock();
+    mSleepReq = false;
+}
+
+void AudioHardware::AudioStreamOutALSA::unlock() {
+    mLock.unlock();
+}
+
+//------------------------------------------------------------------------------
+//  RingBuffer
+//------------------------------------------------------------------------------
+
+AudioHardware::RingBuffer::RingBuffer(size_t size) :
+    mData(NULL), mSize(1), mFront(0), mRear(0), mDiscard(0)
+{
+    // a power of 2 size keeps the indexes valid when they wrap around
+    while (mSize < size) {
+        mSize <<= 1;
+    }
+    mData = new uint8_t[mSize];
+}
+
+AudioHardware::RingBuffer::~RingBuffer()
+{
+    delete[] mData;
+}
+
+// Not counting the discarded data the consumer did not skip yet
+size_t AudioHardware::RingBuffer::availableToRead() const
+{
+    uint32_t front = (uint32_t)android_atomic_acquire_load(&mFront);
+    uint32_t discard = (uint32_t)android_atomic_acquire_load(&mDiscard);
+
+    if ((int32_t)(discard - front) > 0) {
+        front = discard;
+    }
+    return (uint32_t)android_atomic_acquire_load(&mRear) - front;
+}
+
+size_t AudioHardware::RingBuffer::availableToWrite() const
+{
+    return mSize - (uint32_t)(android_atomic_acquire_load(&mRear) -
+            android_atomic_acquire_load(&mFront));
+}
+
+size_t AudioHardware::RingBuffer::write(const void* buffer, size_t bytes)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(buffer);
+    uint32_t rear = (uint32_t)mRear;
+    size_t avail = mSize - (uint32_t)(rear - android_atomic_acquire_load(&mFront));
+
+    if (bytes > avail) {
+        bytes = avail;
+    }
+    size_t offset = rear & (mSize - 1);
+    size_t part = mSize - offset;
+    if (part > bytes) {
+        part = bytes;
+    }
+    memcpy(mData + offset, p, part);
+    memcpy(mData, p + part, bytes - part);
+
+    // publish the data after it has been copied
+    android_atomic_release_store((int32_t)(rear + bytes), &mRear);
+    return bytes;
+}
+
+void AudioHardware::RingBuffer::discard()
+{
+    android_atomic_release_store(mRear, &mDiscard);
+}
+
+size_t AudioHardware::RingBuffer::peek(void** buffer)
+{
+    uint32_t front = (uint32_t)mFront;
+    uint32_t discard = (uint32_t)android_atomic_acquire_load(&mDiscard);
+
+    if ((int32_t)(discard - front) > 0) {
+        front = discard;
+        android_atomic_release_store((int32_t)front, &mFront);
+    }
+    size_t avail = (uint32_t)(android_atomic_acquire_load(&mRear) - front);
+    size_t offset = front & (mSize - 1);
+
+    if (avail > mSize - offset) {
+        avail = mSize - offset;
+    }
+    *buffer = mData + offset;
+    return avail;
+}
+
+void AudioHardware::RingBuffer::advance(size_t bytes)
+{
+    android_atomic_release_store((int32_t)((uint32_t)mFront + bytes), &mFront);
+}
+
+//------------------------------------------------------------------------------
+//  DriverTrace
+//------------------------------------------------------------------------------
+
+AudioHardware::DriverTrace AudioHardware::sDriverTrace;
+
+void AudioHardware::DriverTrace::record(int op, const void *stream,
+                                        nsecs_t start, int result)
+{
+    uint32_t n = (uint32_t)android_atomic_inc(&mNext);
+    Event *event = &mEvents[n & (AUDIO_HW_TRACE_SIZE - 1)];
+
+    // invalidate the slot before changing it
+    android_atomic_acquire_store(0, &event->seq);
+    event->op = op;
+    event->result = result;
+    event->tid = androidGetTid();
+    event->stream = (uint64_t)(uintptr_t)stream;
+    event->start = start;
+    event->end = systemTime();
+    android_atomic_release_store((int32_t)(n + 1), &event->seq);
+}
+
+size_t AudioHardware::DriverTrace::snapshot(Event *events, size_t max)
+{
+    uint32_t next = (uint32_t)android_atomic_acquire_load(&mNext);
+    uint32_t count = next < AUDIO_HW_TRACE_SIZE ? next : AUDIO_HW_TRACE_SIZE;
+    size_t copied = 0;
+
+    if (count > max) {
+        count = max;
+    }
+    for (uint32_t n = next - count; n != next; n++) {
+        Event *event = &mEvents[n & (AUDIO_HW_TRACE_SIZE - 1)];
+        int32_t seq = android_atomic_acquire_load(&event->seq);
+
+        if (seq != (int32_t)(n + 1)) {
+            // not published yet or already overwritten
+            continue;
+        }
+        events[copied] = *event;
+        if (android_atomic_release_load(&event->seq) == seq) {
+            copied++;
+        }
+    }
+    return copied;
+}
+
+void AudioHardware::DriverTrace::dump(String8& result, size_t max)
+{
+    const size_t SIZE = 256;
+    char buffer[SIZE];
+    Event *events = new Event[max];
+    size_t count = snapshot(events, max);
+    nsecs_t now = systemTime();
+
+    snprintf(buffer, SIZE, "\tDriver trace, last %u of %u operations:\n",
+             count, (uint32_t)android_atomic_acquire_load(&mNext));
+    result.append(buffer);
+    for (size_t i = 0; i < count; i++) {
+        const Event *event = &events[i];
+        const char *name = "?";
+
+        if (event->op >= 0 && event->op < DRV_COUNT) {
+            name = driverOpNames[event->op];
+        }
+        snprintf(buffer, SIZE, "\t\t-%lld us %-12s %lld us tid %d %p ret %d\n",
+                 ns2us(now - event->start), name,
+                 ns2us(event->end - event->start), event->tid,
+                 (void *)(uintptr_t)event->stream, event->result);
+        result.append(buffer);
+    }
+    delete[] events;
+}
+
+status_t AudioHardware::DriverTrace::exportTo(const char *path)
+{
+    Event *events = new Event[AUDIO_HW_TRACE_SIZE];
+    ExportHeader header;
+    status_t status = NO_ERROR;
+
+    header.count = snapshot(events, AUDIO_HW_TRACE_SIZE);
+    memcpy(header.magic, "ADTR", sizeof(header.magic));
+    header.version = 1;
+    header.eventSize = sizeof(Event);
+    header.monotonicTime = systemTime(SYSTEM_TIME_MONOTONIC);
+    header.realTime = systemTime(SYSTEM_TIME_REALTIME);
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0640);
+    if (fd < 0) {
+        LOGW("cannot create driver trace file %s: %s", path, strerror(errno));
+        delete[] events;
+        return UNKNOWN_ERROR;
+    }
+    size_t size = header.count * sizeof(Event);
+    if (write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header) ||
+            write(fd, events, size) != (ssize_t)size) {
+        LOGW("cannot write driver trace file %s: %s", path, strerror(errno));
+        status = UNKNOWN_ERROR;
+    } else {
+        LOGI("exported %u driver operations to %s", header.count, path);
+    }
+    close(fd);
+    delete[] events;
+    return status;
+}
+
+//------------------------------------------------------------------------------
+//  TimingHistogram
+//------------------------------------------------------------------------------
+
+void AudioHardware::TimingHistogram::reset()
+{
+    memset(mBuckets, 0, sizeof(mBuckets));
+    mCount = 0;
+    mTotal = 0;
+    mMax = 0;
+}
+
+void AudioHardware::TimingHistogram::add(nsecs_t duration)
+{
+    size_t bucket = 0;
+    for (nsecs_t limit = microseconds(AUDIO_HW_HIST_MIN_US);
+         duration >= limit && bucket < AUDIO_HW_HIST_SIZE - 1;
+         limit <<= 1) {
+        bucket++;
+    }
+    mBuckets[bucket]++;
+    mCount++;
+    mTotal += duration;
+    if (duration > mMax) {
+        mMax = duration;
+    }
+}
+
+void AudioHardware::TimingHistogram::dump(String8& result, const char *name)
+{
+    const size_t SIZE = 256;
+    char buffer[SIZE];
+    uint32_t count = mCount;
+
+    snprintf(buffer, SIZE, "%s: %u, avg %lld us, max %lld us",
+             name, count, count ? ns2us(mTotal) / count : 0, ns2us(mMax));
+    result.append(buffer);
+    for (size_t i = 0; i < AUDIO_HW_HIST_SIZE; i++) {
+        if (mBuckets[i] == 0) {
+            continue;
+        }
+        if (i < AUDIO_HW_HIST_SIZE - 1) {
+            snprintf(buffer, SIZE, " <%dus:%u", AUDIO_HW_HIST_MIN_US << i,
+                     mBuckets[i]);
+        } else {
+            snprintf(buffer, SIZE, " more:%u", mBuckets[i]);
+        }
+        result.append(buffer);
+    }
+    result.append("\n");
+}
+
+//------------------------------------------------------------------------------
+//  OutputWriter
+//------------------------------------------------------------------------------
+
+AudioHardware::OutputWriter::OutputWriter(AudioStreamOutALSA* output,
+                                          size_t bufferSize,
+                                          uint32_t sampleRate) :
+    Thread(false),
+    mOutput(output), mRing(bufferSize), mBufferSize(output->bufferSize()),
+    mConsumerWaiting(0), mProducerWaiting(0), mParked(true), mRealTime(false)
+{
+    mBufferNs = seconds((nsecs_t)mBufferSize / output->frameSize()) / sampleRate;
+}
+
+status_t AudioHardware::OutputWriter::readyToRun()
+{
+    struct sched_param param;
+
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = AUDIO_HW_OUT_WRITER_PRIORITY;
+    if (sched_setscheduler(0, SCHED_FIFO, &param) == 0) {
+        mRealTime = true;
+    } else {
+        LOGW("OutputWriter cannot get SCHED_FIFO priority: %s", strerror(errno));
+    }
+    return NO_ERROR;
+}
+
+bool AudioHardware::OutputWriter::threadLoop()
+{
+    void *data;
+    size_t bytes = mRing.peek(&data);
+
+    if (bytes == 0) {
+        waitForData();
+        return true;
+    }
+    if (bytes > mBufferSize) {
+        bytes = mBufferSize;
+    }
+
+    ssize_t ret = mOutput->writePcm(data, bytes);
+    // release the space once the data is in the driver so that the ring
+    // only looks empty when everything has been written
+    mRing.advance(bytes);
+    wakeProducer();
+
+    if (ret < 0) {
+        mOutput->doStandby();
+
+        // Simulate audio output timing in case of error
+        usleep((((bytes * 1000) / mOutput->frameSize()) * 1000) /
+               mOutput->sampleRate());
+    }
+    return true;
+}
+
+ssize_t AudioHardware::OutputWriter::write(const void* buffer, size_t bytes)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(buffer);
+    size_t left = bytes;
+
+    if (mParked) {
+        AutoMutex lock(mWaitLock);
+        mParked = false;
+        mDataCond.signal();
+    }
+
+    while (left != 0 && !exitPending()) {
+        size_t written = mRing.write(p, left);
+        if (written == 0) {
+            waitForSpace();
+            continue;
+        }
+        p += written;
+        left -= written;
+        wakeConsumer();
+    }
+
+    return bytes - left;
+}
+
+void AudioHardware::OutputWriter::drain()
+{
+    // everything queued plays in less than twice the ring duration
+    nsecs_t timeout = systemTime() +
+            2 * mBufferNs * (mRing.size() / mBufferSize + 1);
+
+    while (mRing.availableToRead() != 0 && !exitPending()) {
+        if (systemTime() > timeout) {
+            LOGW("OutputWriter::drain() timed out, %d bytes left",
+                 mRing.availableToRead());
+            break;
+        }
+        waitForSpace();
+    }
+
+    AutoMutex lock(mWaitLock);
+    mParked = true;
+}
+
+void AudioHardware::OutputWriter::stop()
+{
+    requestExit();
+    {
+        AutoMutex lock(mWaitLock);
+        mDataCond.signal();
+        mSpaceCond.signal();
+    }
+    requestExitAndWait();
+}
+
+// The waiting flags spare the other side a mutex acquisition when nobody
+// sleeps. A wake up missed while a flag is being set only delays the waiter
+// until its timeout, one buffer duration.
+void AudioHardware::OutputWriter::waitForData()
+{
+    AutoMutex lock(mWaitLock);
+
+    android_atomic_release_store(1, &mConsumerWaiting);
+    while (mRing.availableToRead() == 0 && !exitPending()) {
+        if (mParked) {
+            mDataCond.wait(mWaitLock);
+        } else if (mDataCond.waitRelative(mWaitLock, mBufferNs) == TIMED_OUT) {
+            break;
+        }
+    }
+    android_atomic_release_store(0, &mConsumerWaiting);
+}
+
+void AudioHardware::OutputWriter::waitForSpace()
+{
+    size_t avail = mRing.availableToWrite();
+    AutoMutex lock(mWaitLock);
+
+    android_atomic_release_store(1, &mProducerWaiting);
+    while (mRing.availableToWrite() == avail && !exitPending()) {
+        if (mSpaceCond.waitRelative(mWaitLock, mBufferNs) == TIMED_OUT) {
+            break;
+        }
+    }
+    android_atomic_release_store(0, &mProducerWaiting);
+}
+
+void AudioHardware::OutputWriter::wakeConsumer()
+{
+    if (android_atomic_acquire_load(&mConsumerWaiting)) {
+        AutoMutex lock(mWaitLock);
+        mDataCond.signal();
+    }
+}
+
+void AudioHardware::OutputWriter::wakeProducer()
+{
+    if (android_atomic_acquire_load(&mProducerWaiting)) {
+        AutoMutex lock(mWaitLock);
+        mSpaceCond.signal();
+    }
+}
+
+void AudioHardware::OutputWriter::dump(String8& result)
+{
+    const size_t SIZE = 256;
+    char buffer[SIZE];
+
+    snprintf(buffer, SIZE, "\t\tWriter thread: %s, ring %d bytes, %d queued%s\n",
+             mRealTime ? "SCHED_FIFO" : "normal", mRing.size(),
+             mRing.availableToRead(), mParked ? ", parked" : "");
+    result.append(buffer);
+}
+
+//------------------------------------------------------------------------------
+//  StandbyTimer
+//------------------------------------------------------------------------------
+
+AudioHardware::StandbyTimer::StandbyTimer(AudioStreamOutALSA* output) :
+    Thread(false), mOutput(output), mDeadline(0)
+{
+}
+
+void AudioHardware::StandbyTimer::arm(nsecs_t delay)
+{
+    AutoMutex lock(mLock);
+    mDeadline = systemTime() + delay;
+    mCond.signal();
+}
+
+void AudioHardware::StandbyTimer::cancel()
+{
+    AutoMutex lock(mLock);
+    mDeadline = 0;
+}
+
+void AudioHardware::StandbyTimer::stop()
+{
+    requestExit();
+    {
+        AutoMutex lock(mLock);
+        mCond.signal();
+    }
+    requestExitAndWait();
+}
+
+bool AudioHardware::StandbyTimer::threadLoop()
+{
+    {
+        AutoMutex lock(mLock);
+        while (!exitPending()) {
+            if (mDeadline == 0) {
+                mCond.wait(mLock);
+                continue;
+            }
+            nsecs_t now = systemTime();
+            if (now >= mDeadline) {
+                break;
+            }
+            mCond.waitRelative(mLock, mDeadline - now);
+        }
+        if (exitPending()) {
+            return false;
+        }
+        mDeadline = 0;
+    }
+    // the stream checks it is still in warm standby
+    mOutput->demoteStandby();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//  CaptureSource
+//------------------------------------------------------------------------------
+
+AudioHardware::CaptureSource::CaptureSource() :
+    mPcm(NULL), mClients(0), mSampleRate(AUDIO_HW_IN_SAMPLERATE), mChannelCount(2),
+    mPeriodSize(AUDIO_HW_IN_PERIOD_SZ), mRingFrames(0), mPosition(0),
+    mGeneration(0), mReading(false), mDriverReads(0), mOverruns(0),
+    mDriverOp(DRV_NONE), mDriverOpStart(0)
+{
+    // periods are never larger than AUDIO_HW_IN_PERIOD_SZ
+    mRing = new int16_t[AUDIO_HW_IN_PERIOD_SZ * AUDIO_HW_IN_SHARED_PERIODS * 2];
+}
+
+AudioHardware::CaptureSource::~CaptureSource()
+{
+    if (mPcm != NULL) {
+        closePcm_l();
+    }
+    delete[] mRing;
+}
+
+status_t AudioHardware::CaptureSource::openPcm_l(uint32_t rate, bool native,
+                                                 bool mono, uint32_t clockRate)
+{
+    unsigned flags;
+    unsigned rateFlags;
+
+    mSampleRate = AUDIO_HW_IN_SAMPLERATE;
+    mChannelCount = 2;
+    if (native && (clockRate == 0 || clockRate == rate) &&
+            getPcmRateFlags(rate, &rateFlags)) {
+        // keep the period duration of the resampled path
+        uint32_t periodMult = AudioStreamInALSA::getBufferSize(rate, 1) /
+                (sizeof(int16_t) * PCM_PERIOD_SZ_MIN);
+        flags = PCM_IN | rateFlags;
+        flags |= (periodMult - 1) << PCM_PERIOD_SZ_SHIFT;
+        flags |= (AUDIO_HW_IN_PERIOD_CNT - PCM_PERIOD_CNT_MIN)
+                << PCM_PERIOD_CNT_SHIFT;
+
+        // a mono input at its native rate reads the frames as captured,
+        // without any conversion
+        if (mono) {
+            LOGV("open mono pcm_in driver at %d Hz", rate);
+            TRACE_DRIVER_IN(DRV_PCM_OPEN)
+            mPcm = openPcm(flags | PCM_MONO);
+            TRACE_DRIVER_OUT(pcm_ready(mPcm) ? 0 : -1)
+            if (pcm_ready(mPcm)) {
+                mSampleRate = rate;
+                mChannelCount = 1;
+            } else {
+                LOGW("cannot open mono pcm_in driver at %d Hz: %s, downmixing",
+                     rate, pcm_error(mPcm));
+                TRACE_DRIVER_IN(DRV_PCM_CLOSE)
+                pcm_close(mPcm);
+                TRACE_DRIVER_OUT(0)
+                mPcm = NULL;
+            }
+        }
+
+        if (mPcm == NULL) {
+            LOGV("open pcm_in driver at %d Hz", rate);
+            TRACE_DRIVER_IN(DRV_PCM_OPEN)
+            mPcm = openPcm(flags);
+            TRACE_DRIVER_OUT(pcm_ready(mPcm) ? 0 : -1)
+            if (pcm_ready(mPcm)) {
+                mSampleRate = rate;
+            } else {
+                // the codec clock is probably held at another rate by the output
+                LOGW("cannot open pcm_in driver at %d Hz: %s, resampling",
+                     rate, pcm_error(mPcm));
+                TRACE_DRIVER_IN(DRV_PCM_CLOSE)
+                pcm_close(mPcm);
+                TRACE_DRIVER_OUT(0)
+                mPcm = NULL;
+            }
+        }
+    }
+
+    if (mPcm == NULL && clockRate != 0 && clockRate != AUDIO_HW_IN_SAMPLERATE) {
+        // the input retries on each read until the output stops
+        LOGV("cannot capture at %d Hz while the codec is clocked at %d Hz",
+             rate, clockRate);
+        return INVALID_OPERATION;
+    }
+    if (mPcm == NULL) {
+        flags = PCM_IN;
+        flags |= (AUDIO_HW_IN_PERIOD_MULT - 1) << PCM_PERIOD_SZ_SHIFT;
+        flags |= (AUDIO_HW_IN_PERIOD_CNT - PCM_PERIOD_CNT_MIN)
+                << PCM_PERIOD_CNT_SHIFT;
+
+        LOGV("open pcm_in driver");
+        TRACE_DRIVER_IN(DRV_PCM_OPEN)
+        mPcm = openPcm(flags);
+        TRACE_DRIVER_OUT(pcm_ready(mPcm) ? 0 : -1)
+    }
+    if (!pcm_ready(mPcm)) {
+        LOGE("cannot open pcm_in driver: %s\n", pcm_error(mPcm));
+        TRACE_DRIVER_IN(DRV_PCM_CLOSE)
+        pcm_close(mPcm);
+        TRACE_DRIVER_OUT(0)
+        mPcm = NULL;
+        return NO_INIT;
+    }
+
+    mPeriodSize = pcm_period_size(mPcm);
+    if (mPeriodSize > AUDIO_HW_IN_PERIOD_SZ) {
+        mPeriodSize = AUDIO_HW_IN_PERIOD_SZ;
+    }
+    mRingFrames = mPeriodSize * AUDIO_HW_IN_SHARED_PERIODS;
+    mPosition = 0;
+    // inputs reset their cursor and conversion state
+    mGeneration++;
+    return NO_ERROR;
+}
+
+// mLock held, no read in progress
+void AudioHardware::CaptureSource::closePcm_l()
+{
+    mOverruns += pcm_get_xruns(mPcm);
+    TRACE_DRIVER_IN(DRV_PCM_CLOSE)
+    pcm_close(mPcm);
+    TRACE_DRIVER_OUT(0)
+    mPcm = NULL;
+}
+
+status_t AudioHardware::CaptureSource::open_l(uint32_t rate, bool native, bool mono,
+                                              uint32_t clockRate, Cursor *cursor)
+{
+    AutoMutex lock(mLock);
+
+    while (mReading) {
+        mCond.wait(mLock);
+    }
+
+    if (mPcm != NULL && mSampleRate != AUDIO_HW_IN_SAMPLERATE &&
+            (mSampleRate != rate || (mChannelCount == 1 && !mono))) {
+        // the pcm runs at the native rate or is mono for another input:
+        // switch to the configuration every input can convert from, unless
+        // the output holds the codec at another rate
+        if (clockRate != 0 && clockRate != AUDIO_HW_IN_SAMPLERATE) {
+            LOGW("cannot capture at %d Hz while the codec is clocked at %d Hz",
+                 rate, clockRate);
+            return INVALID_OPERATION;
+        }
+        LOGD("CaptureSource reopening pcm_in at %d Hz for a %d Hz input",
+             AUDIO_HW_IN_SAMPLERATE, rate);
+        closePcm_l();
+    }
+    if (mPcm == NULL) {
+        status_t status = openPcm_l(rate, native && (mClients == 0), mono, clockRate);
+        if (status != NO_ERROR) {
+            return status;
+        }
     }
 
+    mClients++;
+    cursor->position = mPosition;
+    cursor->generation = mGeneration;
+    return NO_ERROR;
+}
 
-    return status;
+void AudioHardware::CaptureSource::close_l(Cursor *cursor)
+{
+    AutoMutex lock(mLock);
 
+    if (mClients == 0) {
+        LOGE("CaptureSource::close_l() no input attached");
+        return;
+    }
+    if (--mClients == 0) {
+        while (mReading) {
+            mCond.wait(mLock);
+        }
+        if (mPcm != NULL) {
+            closePcm_l();
+        }
+    }
 }
 
-String8 AudioHardware::AudioStreamOutALSA::getParameters(const String8& keys)
+void AudioHardware::CaptureSource::suspend_l()
 {
-    AudioParameter param = AudioParameter(keys);
-    String8 value;
-    String8 key = String8(AudioParameter::keyRouting);
+    AutoMutex lock(mLock);
 
-    if (param.get(key, value) == NO_ERROR) {
-        param.addInt(key, (int)mDevices);
+    while (mReading) {
+        mCond.wait(mLock);
+    }
+    if (mPcm != NULL) {
+        LOGV("CaptureSource::suspend_l()");
+        closePcm_l();
     }
-
-    LOGV("AudioStreamOutALSA::getParameters() %s", param.toString().string());
-    return param.toString();
 }
 
-status_t AudioHardware::AudioStreamOutALSA::getRenderPosition(uint32_t *dspFrames)
+status_t AudioHardware::CaptureSource::resume_l(uint32_t clockRate)
 {
-    //TODO
-    return INVALID_OPERATION;
+    AutoMutex lock(mLock);
+
+    if (mPcm != NULL || mClients == 0) {
+        return NO_ERROR;
+    }
+    // at another clock rate the inputs reattach on their next read, those
+    // able to capture at that rate natively
+    if (clockRate != 0 && clockRate != AUDIO_HW_IN_SAMPLERATE) {
+        LOGV("CaptureSource::resume_l() codec clocked at %d Hz, left closed", clockRate);
+        return INVALID_OPERATION;
+    }
+    LOGV("CaptureSource::resume_l() clock %d Hz", clockRate);
+    return openPcm_l(AUDIO_HW_IN_SAMPLERATE, false, false, clockRate);
 }
 
-int AudioHardware::AudioStreamOutALSA::prepareLock()
+bool AudioHardware::CaptureSource::sync(Cursor *cursor)
 {
-    // request sleep next time write() is called so that caller can acquire
-    // mLock
-    mSleepReq = true;
-    return mStandbyCnt;
+    AutoMutex lock(mLock);
+
+    if (cursor->generation == mGeneration) {
+        return false;
+    }
+    cursor->position = mPosition;
+    cursor->generation = mGeneration;
+    return true;
 }
 
-void AudioHardware::AudioStreamOutALSA::lock()
+status_t AudioHardware::CaptureSource::read(Cursor *cursor, int16_t *buffer,
+                                            size_t *frames)
 {
-    mLock.lock();
-    mSleepReq = false;
+    AutoMutex lock(mLock);
+    size_t wanted = *frames;
+    size_t done = 0;
+
+    *frames = 0;
+    while (done < wanted) {
+        // after a reopen the caller syncs the cursor and reads on
+        if (mPcm == NULL || cursor->generation != mGeneration) {
+            return NO_INIT;
+        }
+
+        // the period after the newest one is being overwritten by the driver
+        uint64_t avail = mPosition - cursor->position;
+        uint32_t window = mRingFrames - mPeriodSize;
+        if (avail > window) {
+            // this input fell behind: skip what has been overwritten
+            cursor->framesLost += (uint32_t)(avail - window);
+            cursor->position = mPosition - window;
+            avail = window;
+        }
+
+        if (avail == 0) {
+            if (mReading) {
+                // another input is already reading the next period
+                mCond.wait(mLock);
+                continue;
+            }
+            mReading = true;
+            struct pcm *pcm = mPcm;
+            int16_t *period = mRing + (mPosition % mRingFrames) * mChannelCount;
+            size_t bytes = mPeriodSize * mChannelCount * sizeof(int16_t);
+
+            // let the other inputs copy what they have not read yet
+            mLock.unlock();
+            nsecs_t start = systemTime();
+            TRACE_DRIVER_IN(DRV_PCM_READ)
+            int ret = pcm_read(pcm, period, bytes);
+            TRACE_DRIVER_OUT(ret)
+            mDriverTime.add(systemTime() - start);
+            mLock.lock();
+
+            mReading = false;
+            mCond.broadcast();
+            if (ret != 0) {
+                *frames = done;
+                return ret;
+            }
+            mPosition += mPeriodSize;
+            mDriverReads++;
+            continue;
+        }
+
+        size_t offset = cursor->position % mRingFrames;
+        size_t count = wanted - done;
+        if (count > avail) {
+            count = avail;
+        }
+        if (count > mRingFrames - offset) {
+            count = mRingFrames - offset;
+        }
+        memcpy(buffer + done * mChannelCount, mRing + offset * mChannelCount,
+               count * mChannelCount * sizeof(int16_t));
+        done += count;
+        *frames = done;
+        cursor->position += count;
+    }
+    return NO_ERROR;
 }
 
-void AudioHardware::AudioStreamOutALSA::unlock() {
-    mLock.unlock();
+void AudioHardware::CaptureSource::dump(String8& result)
+{
+    const size_t SIZE = 256;
+    char buffer[SIZE];
+
+    snprintf(buffer, SIZE, "\tCapture source: mPcm %p, %d inputs, %d Hz %s, "
+             "period %d frames\n", mPcm, mClients, mSampleRate,
+             (mChannelCount == 1) ? "mono" : "stereo", mPeriodSize);
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\t\tframes captured %llu, driver reads %u, mDriverOp %d\n",
+             mPosition, mDriverReads, mDriverOp);
+    result.append(buffer);
+    snprintf(buffer, SIZE, "\t\tOverruns: %u\n",
+             mOverruns + (mPcm ? pcm_get_xruns(mPcm) : 0));
+    result.append(buffer);
+    mDriverTime.dump(result, "\t\tpcm_read()");
 }
 
 //------------------------------------------------------------------------------
@@ -1535,13 +3476,16 @@ void AudioHardware::AudioStreamOutALSA::unlock() {
 //------------------------------------------------------------------------------
 
 AudioHardware::AudioStreamInALSA::AudioStreamInALSA() :
-    mHardware(0), mPcm(0), mMixer(0),
+    mHardware(0), mAttached(false), mStandbyEntries(0), mMixer(0),
     mStandby(true), mDevices(0), mChannels(AUDIO_HW_IN_CHANNELS), mChannelCount(2),
-    mSampleRate(AUDIO_HW_IN_SAMPLERATE), mBufferSize(AUDIO_HW_IN_PERIOD_BYTES),
-    mDownSampler(NULL), mChannelMixer(NULL), mReadStatus(NO_ERROR),
+    mSampleRate(AUDIO_HW_IN_SAMPLERATE), mNativeRate(false), mNativeMono(false),
+    mPcmSampleRate(AUDIO_HW_IN_SAMPLERATE), mPcmChannelCount(2),
+    mPeriodSize(AUDIO_HW_IN_PERIOD_SZ),
+    mBufferSize(AUDIO_HW_IN_PERIOD_BYTES), mDownSampler(NULL), mChannelMixer(NULL), mReadStatus(NO_ERROR),
     mInPcmInBuf(0), mPcmIn(NULL), mDriverOp(DRV_NONE),
     mStandbyCnt(0), mSleepReq(false)
 {
+    memset(&mCursor, 0, sizeof(mCursor));
 }
 
 status_t AudioHardware::AudioStreamInALSA::set(
@@ -1577,7 +3521,6 @@ status_t AudioHardware::AudioStreamInALSA::set(
 
     LOGD("AudioStreamInALSA::set(%d, %d, %u)", *pFormat, *pChannels, *pRate);
 
-    BufferProvider *bufferProvider = this;
     mDevices = devices;
     mInputChannels = AUDIO_HW_IN_CHANNELS;
     mInputChannelCount = 2;
@@ -1591,11 +3534,11 @@ status_t AudioHardware::AudioStreamInALSA::set(
         status_t status = mChannelMixer->initCheck();
         if (status != NO_ERROR) {
             delete mChannelMixer;
+            mChannelMixer = NULL;
             LOGW("AudioStreamInALSA::set() channel mixer init failed: %d", status);
             return status;
         }
 
-        bufferProvider = mChannelMixer;
         if (!mPcmIn)
             mPcmIn = new int16_t[AUDIO_HW_IN_PERIOD_SZ * mInputChannelCount];
         if (!mPcmIn)
@@ -1603,13 +3546,21 @@ status_t AudioHardware::AudioStreamInALSA::set(
     }
     mBufferSize = getBufferSize(rate, mChannelCount);
     mSampleRate = rate;
+    mNativeRate = (mSampleRate != AUDIO_HW_IN_SAMPLERATE) &&
+            mHardware->isNativeRate(true, mSampleRate);
+    // voice inputs are mono at a low rate: if the codec can capture them
+    // as they are, the channel mixer and down sampler are only fallbacks
+    mNativeMono = mNativeRate && (mChannelCount == 1) &&
+            mHardware->isNativeMonoInRate(mSampleRate);
     delete mDownSampler;
     mDownSampler = NULL;
+    // the down sampler is still needed with a native rate in case the codec
+    // cannot be switched to it when the pcm is opened
     if (mSampleRate != AUDIO_HW_IN_SAMPLERATE) {
         mDownSampler = new AudioHardware::DownSampler(mSampleRate,
                                                   mChannelCount,
                                                   AUDIO_HW_IN_PERIOD_SZ,
-                                                  bufferProvider);
+                                                  this, mChannelMixer);
         status_t status = mDownSampler->initCheck();
         if (status != NO_ERROR) {
             delete mDownSampler;
@@ -1646,6 +3597,8 @@ ssize_t AudioHardware::AudioStreamInALSA::read(void* buffer, ssize_t bytes)
 
     if (mHardware == NULL) return NO_INIT;
 
+    nsecs_t start = systemTime();
+
     if (mSleepReq) {
         // 10ms are always shorter than the time to reconfigure the audio path
         // which is the only condition when mSleepReq would be true.
@@ -1665,84 +3618,32 @@ ssize_t AudioHardware::AudioStreamInALSA::read(void* buffer, ssize_t bytes)
             LOGD("AudioHardware pcm capture is exiting standby.");
             acquire_wake_lock (PARTIAL_WAKE_LOCK, "AudioInLock");
 
-            sp<AudioStreamOutALSA> spOut = mHardware->output();
-            while (spOut != 0) {
-                if (!spOut->checkStandby()) {
-                    int cnt = spOut->prepareLock();
-                    mHardware->lock().unlock();
-                    mLock.unlock();
-                    // Mutex acquisition order is always out -> in -> hw
-                    spOut->lock();
-                    mLock.lock();
-                    mHardware->lock().lock();
-                    // make sure that another thread did not change output state
-                    // while the mutex is released
-                    if ((spOut == mHardware->output()) && (cnt == spOut->standbyCnt())) {
-                        LOGV("AudioStreamInALSA::read() force output standby");
-                        spOut->close_l();
-                        break;
-                    }
-                    spOut->unlock();
-                    spOut = mHardware->output();
-                } else {
-                    spOut.clear();
-                }
-            }
-            // spOut is not 0 here only if the output was active and has been
-            // closed above
-
-            // open output before input
-            if (spOut != 0) {
-                if (spOut->open_l() != NO_ERROR) {
-                    spOut->doStandby_l();
-                }
-                spOut->unlock();
-            }
-
-            open_l();
+            // capture runs alongside playback, at a rate it can share the
+            // codec clock with: the playback is never interrupted for it
+            open_l(mHardware->pcmOutSampleRate_l());
 
-            if (mPcm == NULL) {
+            if (!mAttached) {
                 release_wake_lock("AudioInLock");
                 goto Error;
             }
             mStandby = false;
         }
 
+        syncCapture();
 
-        if (mDownSampler != NULL) {
-            size_t frames = bytes / frameSize();
-            size_t framesIn = 0;
-            mReadStatus = 0;
-            do {
-                size_t outframes = frames - framesIn;
-                mDownSampler->resample(
-                        (int16_t *)buffer + (framesIn * mChannelCount),
-                        &outframes);
-                framesIn += outframes;
-            } while ((framesIn < frames) && mReadStatus == 0);
-            ret = mReadStatus;
-            bytes = framesIn * frameSize();
-        } else if (mChannelMixer != NULL) {
-            size_t frames = bytes / frameSize();
-            size_t framesIn = 0;
-            mReadStatus = 0;
-            do {
-                size_t outframes = frames - framesIn;
-                mChannelMixer->mix(
-                        (int16_t *)buffer + (framesIn * mChannelCount),
-                        &outframes);
-                framesIn += outframes;
-            } while ((framesIn < frames) && mReadStatus == 0);
-            ret = mReadStatus;
-            bytes = framesIn * frameSize();
-        } else {
-            TRACE_DRIVER_IN(DRV_PCM_READ)
-            ret = pcm_read(mPcm, buffer, bytes);
-            TRACE_DRIVER_OUT
-        }
+        size_t frames = bytes / frameSize();
+        size_t framesIn = 0;
+        do {
+            size_t count = frames - framesIn;
+            ret = readCapture_l((int16_t *)buffer + (framesIn * mChannelCount), &count);
+            framesIn += count;
+            // the capture was reopened for another input: carry on with the
+            // new configuration rather than failing the read
+        } while (ret != 0 && syncCapture());
 
         if (ret == 0) {
             setpriority(PRIO_PROCESS, 0, priority);
+            mReadTime.add(systemTime() - start);
             return bytes;
         }
 
@@ -1758,6 +3659,7 @@ Error:
     // Simulate audio output timing in case of error
     usleep((((bytes * 1000) / frameSize()) * 1000) / sampleRate());
 
+    mReadTime.add(systemTime() - start);
     return status;
 }
 
@@ -1787,6 +3689,7 @@ void AudioHardware::AudioStreamInALSA::doStandby_l()
         LOGD("AudioHardware pcm capture is going to standby.");
         release_wake_lock("AudioInLock");
         mStandby = true;
+        mStandbyEntries++;
     }
     close_l();
 }
@@ -1798,36 +3701,74 @@ void AudioHardware::AudioStreamInALSA::close_l()
         mMixer = NULL;
     }
 
-    if (mPcm) {
-        TRACE_DRIVER_IN(DRV_PCM_CLOSE)
-        pcm_close(mPcm);
-        TRACE_DRIVER_OUT
-        mPcm = NULL;
+    if (mAttached) {
+        mHardware->mCapture->close_l(&mCursor);
+        mAttached = false;
     }
 }
 
-status_t AudioHardware::AudioStreamInALSA::open_l()
+// Read frames from the capture through the conversion the pcm configuration
+// needs. frames: in, the frames wanted; out, the frames read. Called with
+// mLock held.
+status_t AudioHardware::AudioStreamInALSA::readCapture_l(int16_t *buffer, size_t *frames)
 {
-    unsigned flags = PCM_IN;
-    flags |= (AUDIO_HW_IN_PERIOD_MULT - 1) << PCM_PERIOD_SZ_SHIFT;
-    flags |= (AUDIO_HW_IN_PERIOD_CNT - PCM_PERIOD_CNT_MIN)
-            << PCM_PERIOD_CNT_SHIFT;
+    size_t wanted = *frames;
+    size_t done = 0;
 
-    LOGV("open pcm_in driver");
-    TRACE_DRIVER_IN(DRV_PCM_OPEN)
-    mPcm = pcm_open(flags);
-    TRACE_DRIVER_OUT
-    if (!pcm_ready(mPcm)) {
-        LOGE("cannot open pcm_in driver: %s\n", pcm_error(mPcm));
-        TRACE_DRIVER_IN(DRV_PCM_CLOSE)
-        pcm_close(mPcm);
-        TRACE_DRIVER_OUT
-        mPcm = NULL;
-        return NO_INIT;
+    if (mDownSampler != NULL && mPcmSampleRate != mSampleRate) {
+        mReadStatus = 0;
+        do {
+            size_t outframes = wanted - done;
+            mDownSampler->resample(buffer + (done * mChannelCount), &outframes);
+            done += outframes;
+        } while ((done < wanted) && mReadStatus == 0);
+        *frames = done;
+        return mReadStatus;
+    }
+    if (mChannelMixer != NULL && mPcmChannelCount != mChannelCount) {
+        mReadStatus = 0;
+        do {
+            size_t outframes = wanted - done;
+            mChannelMixer->mix(buffer + (done * mChannelCount), &outframes);
+            done += outframes;
+        } while ((done < wanted) && mReadStatus == 0);
+        *frames = done;
+        return mReadStatus;
+    }
+    return mHardware->mCapture->read(&mCursor, buffer, frames);
+}
+
+// Pick up a reopening of the capture pcm by another stream
+bool AudioHardware::AudioStreamInALSA::syncCapture()
+{
+    if (!mHardware->mCapture->sync(&mCursor)) {
+        return false;
     }
+    LOGV("AudioStreamInALSA::syncCapture() capture reopened");
+    mPcmSampleRate = mHardware->mCapture->sampleRate();
+    mPcmChannelCount = mHardware->mCapture->channelCount();
+    mPeriodSize = mHardware->mCapture->periodSize();
+    mInPcmInBuf = 0;
+    if (mDownSampler != NULL) {
+        mDownSampler->reset();
+    }
+    return true;
+}
 
+status_t AudioHardware::AudioStreamInALSA::open_l(uint32_t clockRate)
+{
+    status_t status = mHardware->mCapture->open_l(mSampleRate, mNativeRate, mNativeMono,
+                                                  clockRate, &mCursor);
+    if (status != NO_ERROR) {
+        return status;
+    }
+    mAttached = true;
+
+    mPcmSampleRate = mHardware->mCapture->sampleRate();
+    mPcmChannelCount = mHardware->mCapture->channelCount();
+    mPeriodSize = mHardware->mCapture->periodSize();
+    mInPcmInBuf = 0;
     if (mDownSampler != NULL) {
-        mInPcmInBuf = 0;
         mDownSampler->reset();
     }
 
@@ -1857,8 +3798,11 @@ status_t AudioHardware::AudioStreamInALSA::dump(int fd, const Vector<String16>&
 
     snprintf(buffer, SIZE, "\t\tmHardware: %p\n", mHardware);
     result.append(buffer);
-    snprintf(buffer, SIZE, "\t\tmPcm: %p\n", mPcm);
+    snprintf(buffer, SIZE, "\t\tCapture: %s, %u frames lost, standby entries: %u\n",
+             mAttached ? "attached" : "detached", mCursor.framesLost,
+             mStandbyEntries);
     result.append(buffer);
+    mReadTime.dump(result, "\t\tread()");
     snprintf(buffer, SIZE, "\t\tmMixer: %p\n", mMixer);
     result.append(buffer);
     snprintf(buffer, SIZE, "\t\tStandby %s\n", (mStandby) ? "ON" : "OFF");
@@ -1869,10 +3813,30 @@ status_t AudioHardware::AudioStreamInALSA::dump(int fd, const Vector<String16>&
     result.append(buffer);
     snprintf(buffer, SIZE, "\t\tmSampleRate: %d\n", mSampleRate);
     result.append(buffer);
+    snprintf(buffer, SIZE, "\t\tmPcmSampleRate: %d%s\n", mPcmSampleRate,
+             mNativeRate ? (mNativeMono ? " (native mono rate supported)" :
+                            " (native rate supported)") : "");
+    result.append(buffer);
+    // frames reach read() a driver period after being captured
+    snprintf(buffer, SIZE, "\t\tCapture path: %s%s, latency %u ms\n",
+             (mPcmSampleRate != mSampleRate) ? "resampled" : "native rate",
+             (mPcmChannelCount != mChannelCount) ? " + channel conversion" : "",
+             (uint32_t)((1000 * (uint64_t)mPeriodSize) / mPcmSampleRate +
+                        (1000 * (uint64_t)mBufferSize) / (frameSize() * mSampleRate)));
+    result.append(buffer);
     snprintf(buffer, SIZE, "\t\tmBufferSize: %d\n", mBufferSize);
     result.append(buffer);
     snprintf(buffer, SIZE, "\t\tmDriverOp: %d\n", mDriverOp);
     result.append(buffer);
+    if (tryLock(mLock)) {
+        if (mDownSampler != NULL) {
+            mDownSampler->dump(result);
+        }
+        if (mChannelMixer != NULL) {
+            mChannelMixer->dump(result);
+        }
+        mLock.unlock();
+    }
     write(fd, result.string(), result.size());
 
     return NO_ERROR;
@@ -1939,7 +3903,7 @@ String8 AudioHardware::AudioStreamInALSA::getParameters(const String8& keys)
 
 status_t AudioHardware::AudioStreamInALSA::getNextBuffer(AudioHardware::BufferProvider::Buffer* buffer)
 {
-    if (mPcm == NULL) {
+    if (!mAttached) {
         buffer->raw = NULL;
         buffer->frameCount = 0;
         mReadStatus = NO_INIT;
@@ -1947,19 +3911,18 @@ status_t AudioHardware::AudioStreamInALSA::getNextBuffer(AudioHardware::BufferPr
     }
 
     if (mInPcmInBuf == 0) {
-        TRACE_DRIVER_IN(DRV_PCM_READ)
-        mReadStatus = pcm_read(mPcm,(void*) mPcmIn, AUDIO_HW_IN_PERIOD_BYTES);
-        TRACE_DRIVER_OUT
+        size_t frames = mPeriodSize;
+        mReadStatus = mHardware->mCapture->read(&mCursor, mPcmIn, &frames);
         if (mReadStatus != 0) {
             buffer->raw = NULL;
             buffer->frameCount = 0;
             return mReadStatus;
         }
-        mInPcmInBuf = AUDIO_HW_IN_PERIOD_SZ;
+        mInPcmInBuf = mPeriodSize;
     }
 
     buffer->frameCount = (buffer->frameCount > mInPcmInBuf) ? mInPcmInBuf : buffer->frameCount;
-    buffer->i16 = mPcmIn + (AUDIO_HW_IN_PERIOD_SZ - mInPcmInBuf) * mInputChannelCount;
+    buffer->i16 = mPcmIn + (mPeriodSize - mInPcmInBuf) * mInputChannelCount;
 
     return mReadStatus;
 }
@@ -2010,455 +3973,53 @@ void AudioHardware::AudioStreamInALSA::unlock() {
 }
 
 //------------------------------------------------------------------------------
-//  DownSampler
+//  Software gain
 //------------------------------------------------------------------------------
 
-/*
- * 2.30 fixed point FIR filter coefficients for conversion 44100 -> 22050.
- * (Works equivalently for 22010 -> 11025 or any other halving, of course.)
- *
- * Transition band from about 18 kHz, passband ripple < 0.1 dB,
- * stopband ripple at about -55 dB, linear phase.
- *
- * Design and display in MATLAB or Octave using:
- *
- * filter = fir1(19, 0.5); filter = round(filter * 2**30); freqz(filter * 2**-30);
- */
-static const int32_t filter_22khz_coeff[] = {
-    2089257, 2898328, -5820678, -10484531,
-    19038724, 30542725, -50469415, -81505260,
-    152544464, 478517512, 478517512, 152544464,
-    -81505260, -50469415, 30542725, 19038724,
-    -10484531, -5820678, 2898328, 2089257,
-};
-#define NUM_COEFF_22KHZ (sizeof(filter_22khz_coeff) / sizeof(filter_22khz_coeff[0]))
-#define OVERLAP_22KHZ (NUM_COEFF_22KHZ - 2)
-
-/*
- * Convolution of signals A and reverse(B). (In our case, the filter response
- * is symmetric, so the reversing doesn't matter.)
- * A is taken to be in 0.16 fixed-point, and B is taken to be in 2.30 fixed-point.
- * The answer will be in 16.16 fixed-point, unclipped.
- *
- * This function would probably be the prime candidate for SIMD conversion if
- * you want more speed.
- */
-int32_t fir_convolve(const int16_t* a, const int32_t* b, int num_samples)
-{
-        int32_t sum = 1 << 13;
-        for (int i = 0; i < num_samples; ++i) {
-                sum += a[i] * (b[i] >> 16);
-        }
-        return sum >> 14;
-}
-
-/* Clip from 16.16 fixed-point to 0.16 fixed-point. */
-int16_t clip(int32_t x)
-{
-    if (x < -32768) {
-        return -32768;
-    } else if (x > 32767) {
-        return 32767;
-    } else {
-        return x;
-    }
-}
-
-/*
- * Convert a chunk from 44 kHz to 22 kHz. Will update num_samples_in and num_samples_out
- * accordingly, since it may leave input samples in the buffer due to overlap.
- *
- * Input and output are taken to be in 0.16 fixed-point.
- */
-void resample_2_1(int16_t* input, int16_t* output, int* num_samples_in, int* num_samples_out)
-{
-    if (*num_samples_in < (int)NUM_COEFF_22KHZ) {
-        *num_samples_out = 0;
-        return;
-    }
-
-    int odd_smp = *num_samples_in & 0x1;
-    int num_samples = *num_samples_in - odd_smp - OVERLAP_22KHZ;
-
-    for (int i = 0; i < num_samples; i += 2) {
-            output[i / 2] = clip(fir_convolve(input + i, filter_22khz_coeff, NUM_COEFF_22KHZ));
-    }
-
-    memmove(input, input + num_samples, (OVERLAP_22KHZ + odd_smp) * sizeof(*input));
-    *num_samples_out = num_samples / 2;
-    *num_samples_in = OVERLAP_22KHZ + odd_smp;
-}
-
-/*
- * 2.30 fixed point FIR filter coefficients for conversion 22050 -> 16000,
- * or 11025 -> 8000.
- *
- * Transition band from about 14 kHz, passband ripple < 0.1 dB,
- * stopband ripple at about -50 dB, linear phase.
- *
- * Design and display in MATLAB or Octave using:
- *
- * filter = fir1(23, 16000 / 22050); filter = round(filter * 2**30); freqz(filter * 2**-30);
- */
-static const int32_t filter_16khz_coeff[] = {
-    2057290, -2973608, 1880478, 4362037,
-    -14639744, 18523609, -1609189, -38502470,
-    78073125, -68353935, -59103896, 617555440,
-    617555440, -59103896, -68353935, 78073125,
-    -38502470, -1609189, 18523609, -14639744,
-    4362037, 1880478, -2973608, 2057290,
-};
-#define NUM_COEFF_16KHZ (sizeof(filter_16khz_coeff) / sizeof(filter_16khz_coeff[0]))
-#define OVERLAP_16KHZ (NUM_COEFF_16KHZ - 1)
-
-/*
- * Convert a chunk from 22 kHz to 16 kHz. Will update num_samples_in and
- * num_samples_out accordingly, since it may leave input samples in the buffer
- * due to overlap.
- *
- * This implementation is rather ad-hoc; it first low-pass filters the data
- * into a temporary buffer, and then converts chunks of 441 input samples at a
- * time into 320 output samples by simple linear interpolation. A better
- * implementation would use a polyphase filter bank to do these two operations
- * in one step.
- *
- * Input and output are taken to be in 0.16 fixed-point.
- */
-
-#define RESAMPLE_16KHZ_SAMPLES_IN 441
-#define RESAMPLE_16KHZ_SAMPLES_OUT 320
-
-void resample_441_320(int16_t* input, int16_t* output, int* num_samples_in, int* num_samples_out)
-{
-    const int num_blocks = (*num_samples_in - OVERLAP_16KHZ) / RESAMPLE_16KHZ_SAMPLES_IN;
-    if (num_blocks < 1) {
-        *num_samples_out = 0;
-        return;
-    }
-
-    for (int i = 0; i < num_blocks; ++i) {
-        uint32_t tmp[RESAMPLE_16KHZ_SAMPLES_IN];
-        for (int j = 0; j < RESAMPLE_16KHZ_SAMPLES_IN; ++j) {
-            tmp[j] = fir_convolve(input + i * RESAMPLE_16KHZ_SAMPLES_IN + j,
-                          filter_16khz_coeff,
-                          NUM_COEFF_16KHZ);
-        }
-
-        const float step_float = (float)RESAMPLE_16KHZ_SAMPLES_IN / (float)RESAMPLE_16KHZ_SAMPLES_OUT;
-        const uint32_t step = (uint32_t)(step_float * 32768.0f + 0.5f);  // 17.15 fixed point
-
-        uint32_t in_sample_num = 0;   // 17.15 fixed point
-        for (int j = 0; j < RESAMPLE_16KHZ_SAMPLES_OUT; ++j, in_sample_num += step) {
-            const uint32_t whole = in_sample_num >> 15;
-            const uint32_t frac = (in_sample_num & 0x7fff);  // 0.15 fixed point
-            const int32_t s1 = tmp[whole];
-            const int32_t s2 = tmp[whole + 1];
-            *output++ = clip(s1 + (((s2 - s1) * (int32_t)frac) >> 15));
-        }
-
-    }
-
-    const int samples_consumed = num_blocks * RESAMPLE_16KHZ_SAMPLES_IN;
-    memmove(input, input + samples_consumed, (*num_samples_in - samples_consumed) * sizeof(*input));
-    *num_samples_in -= samples_consumed;
-    *num_samples_out = RESAMPLE_16KHZ_SAMPLES_OUT * num_blocks;
-}
-
-
-AudioHardware::DownSampler::DownSampler(uint32_t outSampleRate,
-                                    uint32_t channelCount,
-                                    uint32_t frameCount,
-                                    AudioHardware::BufferProvider* provider)
-    :  mStatus(NO_INIT), mProvider(provider), mSampleRate(outSampleRate),
-       mChannelCount(channelCount), mFrameCount(frameCount),
-       mInLeft(NULL), mInRight(NULL), mTmpLeft(NULL), mTmpRight(NULL),
-       mTmp2Left(NULL), mTmp2Right(NULL), mOutLeft(NULL), mOutRight(NULL)
-
-{
-    LOGD("AudioHardware::DownSampler() cstor %p SR %d channels %d frames %d",
-         this, mSampleRate, mChannelCount, mFrameCount);
-
-    if (mSampleRate != 8000 && mSampleRate != 11025 && mSampleRate != 16000 &&
-            mSampleRate != 22050) {
-        LOGW("AudioHardware::DownSampler cstor: bad sampling rate: %d", mSampleRate);
-        return;
-    }
-
-    mInLeft = new int16_t[mFrameCount];
-    mInRight = new int16_t[mFrameCount];
-    mTmpLeft = new int16_t[mFrameCount];
-    mTmpRight = new int16_t[mFrameCount];
-    mTmp2Left = new int16_t[mFrameCount];
-    mTmp2Right = new int16_t[mFrameCount];
-    mOutLeft = new int16_t[mFrameCount];
-    mOutRight = new int16_t[mFrameCount];
-
-    mStatus = NO_ERROR;
-}
-
-AudioHardware::DownSampler::~DownSampler()
-{
-    if (mInLeft) delete[] mInLeft;
-    if (mInRight) delete[] mInRight;
-    if (mTmpLeft) delete[] mTmpLeft;
-    if (mTmpRight) delete[] mTmpRight;
-    if (mTmp2Left) delete[] mTmp2Left;
-    if (mTmp2Right) delete[] mTmp2Right;
-    if (mOutLeft) delete[] mOutLeft;
-    if (mOutRight) delete[] mOutRight;
-}
-
-void AudioHardware::DownSampler::reset()
-{
-    mInInBuf = 0;
-    mInTmpBuf = 0;
-    mInTmp2Buf = 0;
-    mOutBufPos = 0;
-    mInOutBuf = 0;
-}
-
-
-int AudioHardware::DownSampler::resample(int16_t* out, size_t *outFrameCount)
+void AudioHardware::AudioStreamOutALSA::applyGain_l(const int16_t *in,
+                                                    int16_t *out, size_t frames)
 {
-    if (mStatus != NO_ERROR) {
-        return mStatus;
-    }
-
-    if (out == NULL || outFrameCount == NULL) {
-        return BAD_VALUE;
-    }
-
-    int16_t *outLeft = mTmp2Left;
-    int16_t *outRight = mTmp2Right;
-    if (mSampleRate == 22050) {
-        outLeft = mTmpLeft;
-        outRight = mTmpRight;
-    } else if (mSampleRate == 8000){
-        outLeft = mOutLeft;
-        outRight = mOutRight;
-    }
-
-    int outFrames = 0;
-    int remaingFrames = *outFrameCount;
-
-    if (mInOutBuf) {
-        int frames = (remaingFrames > mInOutBuf) ? mInOutBuf : remaingFrames;
-
-        for (int i = 0; i < frames; ++i) {
-            out[i] = outLeft[mOutBufPos + i];
-        }
-        if (mChannelCount == 2) {
-            for (int i = 0; i < frames; ++i) {
-                out[i * 2] = outLeft[mOutBufPos + i];
-                out[i * 2 + 1] = outRight[mOutBufPos + i];
-            }
-        }
-        remaingFrames -= frames;
-        mInOutBuf -= frames;
-        mOutBufPos += frames;
-        outFrames += frames;
-    }
-
-    while (remaingFrames) {
-        LOGW_IF((mInOutBuf != 0), "mInOutBuf should be 0 here");
-
-        AudioHardware::BufferProvider::Buffer buf;
-        buf.frameCount =  mFrameCount - mInInBuf;
-        int ret = mProvider->getNextBuffer(&buf);
-        if (buf.raw == NULL) {
-            *outFrameCount = outFrames;
-            return ret;
-        }
-
-        for (size_t i = 0; i < buf.frameCount; ++i) {
-            mInLeft[i + mInInBuf] = buf.i16[i];
-        }
-        if (mChannelCount == 2) {
-            for (size_t i = 0; i < buf.frameCount; ++i) {
-                mInLeft[i + mInInBuf] = buf.i16[i * 2];
-                mInRight[i + mInInBuf] = buf.i16[i * 2 + 1];
-            }
-        }
-        mInInBuf += buf.frameCount;
-        mProvider->releaseBuffer(&buf);
-
-        /* 44010 -> 22050 */
-        {
-            int samples_in_left = mInInBuf;
-            int samples_out_left;
-            resample_2_1(mInLeft, mTmpLeft + mInTmpBuf, &samples_in_left, &samples_out_left);
-
-            if (mChannelCount == 2) {
-                int samples_in_right = mInInBuf;
-                int samples_out_right;
-                resample_2_1(mInRight, mTmpRight + mInTmpBuf, &samples_in_right, &samples_out_right);
-            }
-
-            mInInBuf = samples_in_left;
-            mInTmpBuf += samples_out_left;
-            mInOutBuf = samples_out_left;
-        }
-
-        if (mSampleRate == 11025 || mSampleRate == 8000) {
-            /* 22050 - > 11025 */
-            int samples_in_left = mInTmpBuf;
-            int samples_out_left;
-            resample_2_1(mTmpLeft, mTmp2Left + mInTmp2Buf, &samples_in_left, &samples_out_left);
-
-            if (mChannelCount == 2) {
-                int samples_in_right = mInTmpBuf;
-                int samples_out_right;
-                resample_2_1(mTmpRight, mTmp2Right + mInTmp2Buf, &samples_in_right, &samples_out_right);
-            }
-
-
-            mInTmpBuf = samples_in_left;
-            mInTmp2Buf += samples_out_left;
-            mInOutBuf = samples_out_left;
-
-            if (mSampleRate == 8000) {
-                /* 11025 -> 8000*/
-                int samples_in_left = mInTmp2Buf;
-                int samples_out_left;
-                resample_441_320(mTmp2Left, mOutLeft, &samples_in_left, &samples_out_left);
-
-                if (mChannelCount == 2) {
-                    int samples_in_right = mInTmp2Buf;
-                    int samples_out_right;
-                    resample_441_320(mTmp2Right, mOutRight, &samples_in_right, &samples_out_right);
-                }
-
-                mInTmp2Buf = samples_in_left;
-                mInOutBuf = samples_out_left;
-            } else {
-                mInTmp2Buf = 0;
-            }
-
-        } else if (mSampleRate == 16000) {
-            /* 22050 -> 16000*/
-            int samples_in_left = mInTmpBuf;
-            int samples_out_left;
-            resample_441_320(mTmpLeft, mTmp2Left, &samples_in_left, &samples_out_left);
-
-            if (mChannelCount == 2) {
-                int samples_in_right = mInTmpBuf;
-                int samples_out_right;
-                resample_441_320(mTmpRight, mTmp2Right, &samples_in_right, &samples_out_right);
-            }
-
-            mInTmpBuf = samples_in_left;
-            mInOutBuf = samples_out_left;
-        } else {
-            mInTmpBuf = 0;
-        }
-
-        int frames = (remaingFrames > mInOutBuf) ? mInOutBuf : remaingFrames;
-
-        for (int i = 0; i < frames; ++i) {
-            out[outFrames + i] = outLeft[i];
-        }
-        if (mChannelCount == 2) {
-            for (int i = 0; i < frames; ++i) {
-                out[(outFrames + i) * 2] = outLeft[i];
-                out[(outFrames + i) * 2 + 1] = outRight[i];
+    while (frames) {
+        size_t count = frames;
+        if (mGainRamp != 0) {
+            if (count > mGainRamp) {
+                count = mGainRamp;
             }
+            gain_ramp_stereo(in, out, count, mGain, mGainStep);
+            mGainRamp -= count;
+            mGain = (mGainRamp != 0) ? mGain + mGainStep * (int32_t)count
+                                     : mGainEnd << 16;
+        } else if (mGainEnd != ChannelMixer::UNITY_GAIN) {
+            gain_stereo(in, out, count, mGainEnd);
+        } else if (in != out) {
+            memcpy(out, in, count * 2 * sizeof(int16_t));
         }
-        remaingFrames -= frames;
-        outFrames += frames;
-        mOutBufPos = frames;
-        mInOutBuf -= frames;
-    }
-
-    return 0;
-}
-
-//------------------------------------------------------------------------------
-//  Channel mixer
-//------------------------------------------------------------------------------
-
-AudioHardware::ChannelMixer::ChannelMixer(uint32_t outChannelCount,
-                                    uint32_t channelCount,
-                                    uint32_t frameCount,
-                                    AudioHardware::BufferProvider* provider)
-    :  mStatus(NO_INIT), mProvider(provider), mOutChannelCount(outChannelCount),
-       mChannelCount(channelCount)
-{
-    LOGV("AudioHardware::ChannelMixer() cstor %p channels %d frames %d",
-         this, mChannelCount, frameCount);
-
-    if (outChannelCount != 1 || channelCount != 2) {
-        LOGE("AudioHardware::ChannelMixer cstor: bad conversion: %d => %d",
-                                                mChannelCount, outChannelCount);
-        return;
-    }
-
-    mStatus = NO_ERROR;
-}
-
-status_t AudioHardware::ChannelMixer::getNextBuffer(AudioHardware::BufferProvider::Buffer* buffer)
-{
-    status_t ret;
-
-    if (!mProvider)
-        return NO_INIT;
-
-    ret = mProvider->getNextBuffer(buffer);
-    if (ret != 0) {
-        LOGE("%s: mProvider->getNextBuffer() failed (%d)", __func__, ret);
-        return ret;
+        in += count * 2;
+        out += count * 2;
+        frames -= count;
     }
-    if (!buffer->raw)
-        return NO_ERROR;
-
-    short *in = buffer->i16;
-    short *out = buffer->i16;
-    for (unsigned int i = 0; i < buffer->frameCount; ++i, ++out, in += 2)
-        out[0] = (in[0] + in[1]) / 2;
-
-    return NO_ERROR;
-}
-
-void AudioHardware::ChannelMixer::releaseBuffer(Buffer* buffer)
-{
-    if (mProvider)
-        mProvider->releaseBuffer(buffer);
 }
 
-int AudioHardware::ChannelMixer::mix(int16_t* out, size_t *outFrameCount)
+// Mix queued frames into out, by the output writing to the pcm
+void AudioHardware::AudioStreamOutALSA::mixInto(int16_t *out, size_t frames)
 {
-    if (mStatus != NO_ERROR) {
-        return mStatus;
-    }
-
-    if (out == NULL || outFrameCount == NULL) {
-        return BAD_VALUE;
-    }
-
-    int remaingFrames = *outFrameCount;
-    while (remaingFrames) {
-        AudioHardware::BufferProvider::Buffer buf;
-        buf.frameCount = remaingFrames;
-
-        int ret = mProvider->getNextBuffer(&buf);
-        if (ret || buf.raw == NULL) {
-            *outFrameCount -= remaingFrames;
-            return ret;
+    while (frames) {
+        void *data;
+        size_t count = mMixRing->peek(&data) / (2 * sizeof(int16_t));
+        if (count == 0) {
+            break;
         }
-
-        remaingFrames -= buf.frameCount;
-
-        int framesRead = buf.frameCount;
-        int16_t *inBuf = buf.i16;
-        while (framesRead--) {
-            out[0] = (int16_t)(((int32_t)inBuf[0] + (int32_t)inBuf[1]) / 2);
-            out += 1;
-            inBuf += 2;
+        if (count > frames) {
+            count = frames;
         }
-
-        mProvider->releaseBuffer(&buf);
+        mix_stereo(out, (const int16_t *)data, count);
+        mMixRing->advance(count * 2 * sizeof(int16_t));
+        out += count * 2;
+        frames -= count;
     }
 
-    return 0;
+    AutoMutex lock(mMixWaitLock);
+    mMixSpaceCond.signal();
 }
 
 //------------------------------------------------------------------------------
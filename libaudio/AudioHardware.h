@@ -22,6 +22,7 @@
 
 #include <utils/threads.h>
 #include <utils/SortedVector.h>
+#include <utils/Timers.h>
 
 #include <hardware_legacy/AudioHardwareBase.h>
 #include <media/mediarecorder.h>
@@ -34,8 +35,9 @@ extern "C" {
 
 namespace android {
 
-// TODO: determine actual audio DSP and hardware latency
-// Additionnal latency introduced by audio DSP and hardware in ms
+// Additionnal latency introduced by the analog path after the codec in ms.
+// The delay of the kernel buffer, DMA FIFOs and codec is measured from the
+// driver when the output starts.
 #define AUDIO_HW_OUT_LATENCY_MS 0
 // Default audio output sample rate
 #define AUDIO_HW_OUT_SAMPLERATE 44100
@@ -49,6 +51,71 @@ namespace android {
 #define AUDIO_HW_OUT_PERIOD_CNT 4
 // Default audio output buffer size in bytes
 #define AUDIO_HW_OUT_PERIOD_BYTES (AUDIO_HW_OUT_PERIOD_SZ * 2 * sizeof(int16_t))
+// Low latency output profile: 2 periods of 256 frames (~12ms at 44.1kHz)
+#define AUDIO_HW_OUT_LOW_LATENCY_PERIOD_MULT 2
+#define AUDIO_HW_OUT_LOW_LATENCY_PERIOD_CNT 2
+// Deep buffer output profile: 16 periods of 2048 frames (~740ms at 44.1kHz),
+// the largest period and buffer the DMA allows. Writes are half the buffer
+// so that the mixer thread only wakes up a few times per second.
+#define AUDIO_HW_OUT_DEEP_BUFFER_PERIOD_MULT 16
+#define AUDIO_HW_OUT_DEEP_BUFFER_PERIOD_CNT 16
+// System property selecting the output profile ("normal", "low_latency" or
+// "deep_buffer"), read when the output stream is opened
+#define AUDIO_HW_OUT_PROFILE_PROPERTY "audio.output.profile"
+// System property enabling the output writer thread: write() only copies
+// to a ring buffer drained into the driver by a real time thread
+#define AUDIO_HW_OUT_WRITER_PROPERTY "audio.output.writer_thread"
+// Ring buffer between write() and the writer thread, in output buffers
+#define AUDIO_HW_OUT_WRITER_BUFFERS 2
+// SCHED_FIFO priority of the writer thread
+#define AUDIO_HW_OUT_WRITER_PRIORITY 2
+// Time an idle output stays in warm standby (pcm stopped but configured)
+// before it is closed, in ms. 0 disables warm standby
+#define AUDIO_HW_OUT_WARM_STANDBY_MS 5000
+#define AUDIO_HW_OUT_WARM_STANDBY_PROPERTY "audio.output.warm_standby_ms"
+// A second output can be opened next to the first one for long running
+// music: it uses the deep buffer profile and shares the pcm. Set the property
+// to 0 to only allow one output.
+#define AUDIO_HW_OUT_DEEP_BUFFER_PROPERTY "audio.output.deep_buffer"
+// Frames an output queues for the other one to mix while that one writes to
+// the pcm, and the longest wait for room in that queue in ms
+#define AUDIO_HW_OUT_MIX_RING_FRAMES 8192
+#define AUDIO_HW_OUT_MIX_WAIT_MS 20
+// The master volume is applied by a software gain on the output, ramped
+// linearly to each new value over AUDIO_HW_OUT_GAIN_RAMP_MS. The codec
+// master volume only moves in AUDIO_HW_MASTER_VOL_STEPS coarse steps, the
+// software gain making up the difference.
+#define AUDIO_HW_OUT_GAIN_RAMP_MS 20
+#define AUDIO_HW_MASTER_VOL_STEPS 4
+// Adaptive output buffer depth: a period is added when
+// AUDIO_HW_OUT_ADAPT_XRUNS underruns happen within AUDIO_HW_OUT_ADAPT_WINDOW_MS
+// of playback, up to AUDIO_HW_OUT_ADAPT_MAX_PERIOD_CNT periods, and removed
+// again after AUDIO_HW_OUT_ADAPT_STABLE_MS of playback without underrun. The
+// stable time doubles, up to AUDIO_HW_OUT_ADAPT_STABLE_MAX_MS, each time
+// periods must be added back soon after one was removed. Changes take
+// effect when the pcm is next opened cold: a running pcm is not reopened.
+// Set the property to 0 to keep the count of the output profile.
+#define AUDIO_HW_OUT_ADAPT_PROPERTY "audio.output.adaptive_periods"
+#define AUDIO_HW_OUT_ADAPT_XRUNS 2
+#define AUDIO_HW_OUT_ADAPT_WINDOW_MS 2000
+#define AUDIO_HW_OUT_ADAPT_MAX_PERIOD_CNT 8
+#define AUDIO_HW_OUT_ADAPT_STABLE_MS 20000
+#define AUDIO_HW_OUT_ADAPT_STABLE_MAX_MS 160000
+
+// Number of timing histogram buckets, the first one is
+// AUDIO_HW_HIST_MIN_US wide and each following one twice as wide as the
+// previous
+#define AUDIO_HW_HIST_SIZE 12
+#define AUDIO_HW_HIST_MIN_US 16
+
+// Number of driver operations kept in the trace ring (power of 2) and
+// number of the most recent ones printed by dump()
+#define AUDIO_HW_TRACE_SIZE 256
+#define AUDIO_HW_TRACE_DUMP_SIZE 32
+// setParameters() key writing the driver trace ring to
+// AUDIO_HW_TRACE_EXPORT_FILE in binary form
+#define AUDIO_HW_TRACE_EXPORT_KEY "driver_trace_export"
+#define AUDIO_HW_TRACE_EXPORT_FILE "/data/misc/audio/driver_trace.bin"
 
 // Default audio input sample rate
 #define AUDIO_HW_IN_SAMPLERATE 44100
@@ -64,12 +131,17 @@ namespace android {
 #define AUDIO_HW_IN_PERIOD_CNT 4
 // Default audio input buffer size in bytes
 #define AUDIO_HW_IN_PERIOD_BYTES (AUDIO_HW_IN_PERIOD_SZ * 2 * sizeof(int16_t))
+// Periods kept in the ring shared by the inputs. One is being filled from the
+// driver, the others can still be read by inputs lagging behind.
+#define AUDIO_HW_IN_SHARED_PERIODS 4
 
 class AudioHardware : public AudioHardwareBase
 {
     class AudioStreamOutALSA;
     class AudioStreamInALSA;
+    class CaptureSource;
 public:
+    class ChannelMixer;
 
     // input path names used to translate from input sources to driver paths
     static const char *inputPathNameDefault;
@@ -128,17 +200,61 @@ public:
     void setVoiceVolume_l(float volume);
 
     static uint32_t    getInputSampleRate(uint32_t sampleRate);
+    static bool        getPcmRateFlags(uint32_t rate, unsigned *flags);
+    bool               isNativeRate(bool input, uint32_t rate);
+    // true if the codec can capture a single channel at rate
+    bool               isNativeMonoInRate(uint32_t rate);
     sp <AudioStreamInALSA> getActiveInput_l();
+    // rate the codec is clocked at by the capture, 0 if it is closed
+    uint32_t pcmInSampleRate_l();
 
     Mutex& lock() { return mLock; }
 
-    struct pcm *openPcmOut_l();
+    /* Output buffer geometry */
+    enum OutputProfile {
+        OUTPUT_PROFILE_NORMAL = 0,
+        OUTPUT_PROFILE_LOW_LATENCY,
+        OUTPUT_PROFILE_DEEP_BUFFER,
+        OUTPUT_PROFILE_COUNT
+    };
+
+    struct OutputProfileConfig {
+        const char *name;
+        uint32_t periodMult;
+        uint32_t periodCnt;
+    };
+
+    static const OutputProfileConfig outputProfiles[OUTPUT_PROFILE_COUNT];
+    static OutputProfile getOutputProfile();
+
+    // periodMult and periodCnt override the values of the output profile if
+    // not 0, they only apply if the pcm is not already open
+    struct pcm *openPcmOut_l(uint32_t periodMult = 0, uint32_t periodCnt = 0);
     void closePcmOut_l();
+    // rate the codec is clocked at by the output, 0 if it is closed
+    uint32_t pcmOutSampleRate_l();
 
     struct mixer *openMixer_l();
     void closeMixer_l();
 
     sp <AudioStreamOutALSA>  output() { return mOutput; }
+    // The main or deep buffer output, locked, if it is active or in warm
+    // standby. mLock is released while the stream lock is taken. The main
+    // output is locked before the deep buffer one.
+    sp <AudioStreamOutALSA>  lockActiveOutput_l(bool deep);
+
+    // Playback pcm sharing between the two outputs. The output writing to
+    // the pcm mixes in the frames the other one queued. acquirePcm() makes out
+    // the writer unless the other output is writing or wrote recently, and
+    // returns false if out must queue its frames instead. peer is set to the
+    // other output, if any, whose queue the writer mixes. The mix lock is
+    // taken last, after any other lock.
+    bool acquirePcm(AudioStreamOutALSA *out, sp<AudioStreamOutALSA> *peer);
+    // done writing; standby: out stops writing until it acquires the pcm
+    // again
+    void releasePcm(AudioStreamOutALSA *out, bool standby = false);
+    // the other output if it is open and not in standby
+    AudioStreamOutALSA *activePeer_l(AudioStreamOutALSA *out);
 
     /* Audio routing */
     enum PinType {
@@ -207,6 +323,64 @@ public:
         const AudioPinConfig    *config;
     };
 
+    // Distribution of durations. Updated by one thread at a time without
+    // locking, dump() may read it while it changes.
+    class TimingHistogram {
+    public:
+        TimingHistogram() { reset(); }
+
+        void reset();
+        void add(nsecs_t duration);
+        void dump(String8& result, const char *name);
+
+    private:
+        uint32_t mBuckets[AUDIO_HW_HIST_SIZE];
+        uint32_t mCount;
+        nsecs_t mTotal;
+        nsecs_t mMax;
+    };
+
+    // Ring of the last timestamped driver operations. Any thread records
+    // without locking: a slot is claimed by incrementing the event counter
+    // and its sequence number is only published once the event is complete,
+    // so readers can skip events being overwritten.
+    class DriverTrace {
+    public:
+        // exported as is: fixed size fields and no padding
+        struct Event {
+            int32_t seq;        // event number + 1, 0 while being written
+            int32_t op;         // DRV_xxx
+            int32_t result;     // return value, or 0/-1 for handles
+            int32_t tid;
+            uint64_t stream;    // object issuing the operation
+            int64_t start;      // SYSTEM_TIME_MONOTONIC, in ns
+            int64_t end;
+        };
+
+        // binary export file header, followed by count Events oldest first
+        struct ExportHeader {
+            char magic[4];      // "ADTR"
+            uint32_t version;
+            uint32_t eventSize;
+            uint32_t count;
+            // clocks sampled together to map event times to wall time
+            int64_t monotonicTime;
+            int64_t realTime;
+        };
+
+        DriverTrace() : mNext(0) { memset(mEvents, 0, sizeof(mEvents)); }
+
+        void record(int op, const void *stream, nsecs_t start, int result);
+        // copies up to max of the most recent complete events, oldest first
+        size_t snapshot(Event *events, size_t max);
+        void dump(String8& result, size_t max);
+        status_t exportTo(const char *path);
+
+    private:
+        volatile int32_t mNext;
+        Event mEvents[AUDIO_HW_TRACE_SIZE];
+    };
+
 protected:
     virtual status_t dump(int fd, const Vector<String16>& args);
 
@@ -219,21 +393,67 @@ private:
     uint32_t mInputRoute;
     uint32_t mVoiceInRoute;
 
+    // route pins with their mixer control, resolved when the mixer is opened
+    struct RoutePin {
+        const AudioPinConfig *config;
+        struct mixer_ctl *ctl;
+    };
+
+    struct ResolvedRoute {
+        uint32_t route;
+        RoutePin *pins;
+        size_t count;
+    };
+
+    ResolvedRoute *mResolvedRoutes[ROUTE_COUNT];
+    TimingHistogram mRouteTime;
+    // route control writes issued and skipped as redundant
+    uint32_t mRouteWrites;
+    uint32_t mRouteSkips;
+
     void setAudioRoute(RouteType type, uint32_t route);
+    void resolveRoutes_l();
+    void releaseRoutes_l();
+    const ResolvedRoute *findRoute_l(RouteType type, uint32_t route);
+    static const RoutePin *findRoutePin(const ResolvedRoute *route,
+                                        struct mixer_ctl *ctl);
 
     /* Android audio interface */
     bool            mInit;
     bool            mMicMute;
     sp <AudioStreamOutALSA>                 mOutput;
+    // deep buffer output, only open with mOutput
+    sp <AudioStreamOutALSA>                 mDeepOutput;
     SortedVector < sp<AudioStreamInALSA> >   mInputs;
+    CaptureSource*  mCapture;
     Mutex           mLock;
     struct pcm*     mPcm;
     struct mixer*   mMixer;
+    // kept open across openMixer_l()/closeMixer_l() cycles
+    struct mixer*   mMixerHandle;
     uint32_t        mPcmOpenCnt;
+    // output writing to the pcm, whether it is writing now, when it last
+    // did and how long after that the other output can take over
+    Mutex           mMixLock;
+    AudioStreamOutALSA* mPcmWriter;
+    bool            mPcmWriterBusy;
+    nsecs_t         mPcmWriterTime;
+    nsecs_t         mPcmWriterIdle;
+    OutputProfile   mOutputProfile;
+    uint32_t        mOutputSampleRate;
+    // rates supported by the codec, one bit per pcmSamplingRates[] entry
+    uint32_t        mNativeInRates;
+    uint32_t        mNativeOutRates;
+    uint32_t        mNativeMonoInRates;
     uint32_t        mMixerOpenCnt;
+    nsecs_t         mMixerOpenTime;
+    uint32_t        mMixerReuseCnt;
     bool            mInCallAudioMode;
     float           mVoiceVol;
     float           mMasterVol;
+    struct mixer_ctl *masterVolumeRange_l(long *min, long *max);
+    void            applyMasterVolume_l();
+    float           masterGain_l();
 
     audio_source    mInputSource;
     bool            mBluetoothNrec;
@@ -246,11 +466,105 @@ private:
 
     //  trace driver operations for dump
     int             mDriverOp;
+    nsecs_t         mDriverOpStart;
+    static DriverTrace sDriverTrace;
 
     void setMasterVolume_l(float volume);
     void setOutputVolume(uint32_t device, uint32_t volume);
+    void setMixerControl_l(const char *name, unsigned value);
     static uint32_t         checkInputSampleRate(uint32_t sampleRate);
     static const uint32_t   inputSamplingRates[];
+    static const uint32_t   pcmSamplingRates[];
+
+    // Byte ring shared by a single producer and a single consumer. Each side
+    // only moves its own index, so data is exchanged without locks.
+    class RingBuffer {
+    public:
+        RingBuffer(size_t size);
+        ~RingBuffer();
+
+        status_t initCheck() { return (mData != NULL) ? NO_ERROR : NO_MEMORY; }
+        size_t size() const { return mSize; }
+        size_t availableToRead() const;
+        size_t availableToWrite() const;
+
+        // producer side
+        size_t write(const void* buffer, size_t bytes);
+        // drop the data written so far: the consumer skips it on its next peek
+        void discard();
+        // consumer side: contiguous readable region, then release it
+        size_t peek(void** buffer);
+        void advance(size_t bytes);
+
+    private:
+        uint8_t *mData;
+        size_t mSize;
+        volatile int32_t mFront;
+        volatile int32_t mRear;
+        volatile int32_t mDiscard;
+    };
+
+    // Owns the output pcm on behalf of an AudioStreamOutALSA: write() copies
+    // to the ring and a real time thread drains it into the driver.
+    class OutputWriter : public Thread {
+    public:
+        OutputWriter(AudioStreamOutALSA* output, size_t bufferSize,
+                     uint32_t sampleRate);
+        virtual ~OutputWriter() {}
+
+        status_t initCheck() { return mRing.initCheck(); }
+        size_t bufferedBytes() const { return mRing.availableToRead(); }
+        size_t size() const { return mRing.size(); }
+
+        ssize_t write(const void* buffer, size_t bytes);
+        // wait for the queued data to reach the driver, then let the thread
+        // sleep until the next write()
+        void drain();
+        void stop();
+        void dump(String8& result);
+
+    private:
+        virtual bool threadLoop();
+        virtual status_t readyToRun();
+
+        void waitForData();
+        void waitForSpace();
+        void wakeConsumer();
+        void wakeProducer();
+
+        AudioStreamOutALSA* mOutput;
+        RingBuffer mRing;
+        size_t mBufferSize;
+        nsecs_t mBufferNs;
+        Mutex mWaitLock;
+        Condition mDataCond;
+        Condition mSpaceCond;
+        volatile int32_t mConsumerWaiting;
+        volatile int32_t mProducerWaiting;
+        // only changed by the producer, with mWaitLock held
+        bool mParked;
+        bool mRealTime;
+    };
+
+    // Closes an output left in warm standby once its idle time is over
+    class StandbyTimer : public Thread {
+    public:
+        StandbyTimer(AudioStreamOutALSA* output);
+        virtual ~StandbyTimer() {}
+
+        void arm(nsecs_t delay);
+        void cancel();
+        void stop();
+
+    private:
+        virtual bool threadLoop();
+
+        AudioStreamOutALSA* mOutput;
+        Mutex mLock;
+        Condition mCond;
+        // 0 when not armed
+        nsecs_t mDeadline;
+    };
 
     class AudioStreamOutALSA : public AudioStreamOut, public RefBase
     {
@@ -261,7 +575,9 @@ private:
                      uint32_t devices,
                      int *pFormat,
                      uint32_t *pChannels,
-                     uint32_t *pRate);
+                     uint32_t *pRate,
+                     OutputProfile profile = OUTPUT_PROFILE_NORMAL,
+                     bool deep = false);
         virtual uint32_t sampleRate()
             const { return mSampleRate; }
         virtual size_t bufferSize()
@@ -271,9 +587,8 @@ private:
         virtual int format()
             const { return AUDIO_HW_OUT_FORMAT; }
         virtual uint32_t latency()
-            const { return (1000 * AUDIO_HW_OUT_PERIOD_CNT *
-                            (bufferSize()/frameSize()))/sampleRate() +
-                AUDIO_HW_OUT_LATENCY_MS; }
+            const { return (1000 * (mPeriodCnt * mPeriodSize + mHwDelay + mRingFrames)) /
+                sampleRate() + AUDIO_HW_OUT_LATENCY_MS; }
         virtual status_t setVolume(float left, float right)
         { return INVALID_OPERATION; }
         virtual ssize_t write(const void* buffer, size_t bytes);
@@ -285,6 +600,17 @@ private:
         virtual String8 getParameters(const String8& keys);
         uint32_t device() { return mDevices; }
         virtual status_t getRenderPosition(uint32_t *dspFrames);
+        // software gain, reached by a ramp starting at the next write. Does
+        // not take any lock.
+        void setGain(float gain);
+        // frames queued for the pcm writer to mix, mixed into out by the
+        // writer. The queue is stereo after channel conversion and gain.
+        size_t mixQueued() const { return mMixRing->availableToRead() / 4; }
+        void mixInto(int16_t *out, size_t frames);
+        bool isStandby_l() { return mStandby; }
+        bool isDeep() { return mDeep; }
+        // time after its last write the other output can take the pcm over
+        nsecs_t pcmIdleTimeout();
 
         void doStandby_l();
         void close_l();
@@ -295,7 +621,29 @@ private:
         void lock();
         void unlock();
 
+        // write to the driver, exiting standby if needed
+        ssize_t writePcm(const void* buffer, size_t bytes);
+        // warm: stop the pcm instead of closing it if possible
+        void doStandby(bool warm = false);
+        bool isWarmStandby() { return mWarmStandby; }
+        void demoteStandby();
+
     private:
+        status_t exitStandby_l();
+        int writeOwner_l(const int16_t *in, size_t frames,
+                         const sp<AudioStreamOutALSA>& peer);
+        size_t queueMix_l(const int16_t *in, size_t frames);
+        void waitForMixSpace();
+        int flushMix_l();
+        int reconfigure_l();
+        void convert_l(const int16_t *in, int16_t *out, size_t frames);
+        void adaptPeriods_l(size_t frames);
+        bool latchGain_l(bool ramp);
+        int render_l(const int16_t *in, size_t frames, AudioStreamOutALSA *peer);
+        void applyGain_l(const int16_t *in, int16_t *out, size_t frames);
+        void updateHwDelay_l();
+        bool enterWarmStandby_l();
+        status_t exitWarmStandby_l();
 
         Mutex mLock;
         AudioHardware* mHardware;
@@ -307,12 +655,83 @@ private:
         uint32_t mChannels;
         uint32_t mSampleRate;
         size_t mBufferSize;
+        OutputProfile mProfile;
+        // kernel buffer geometry in frames, as granted by the driver once open
+        uint32_t mPeriodSize;
+        uint32_t mPeriodCnt;
+        // mono streams are upmixed a period at a time for the stereo pcm
+        ChannelMixer *mChannelMixer;
+        // mMixFrames stereo frames, used if the pcm is not mmapped and to
+        // queue frames for the other output
+        int16_t *mMixBuffer;
+        uint32_t mMixFrames;
+        // deep buffer output next to the main one
+        bool mDeep;
+        // true if the pcm was opened with the configuration of this stream
+        bool mPcmConfigured;
+        // frames queued while the other output writes to the pcm
+        RingBuffer *mMixRing;
+        Mutex mMixWaitLock;
+        Condition mMixSpaceCond;
+        // software gain target in 2.14 fixed-point, set by setGain()
+        volatile int32_t mGainTarget;
+        // target of the current ramp in 2.14 fixed-point, the current gain
+        // in 2.30 fixed-point and its per frame step while mGainRamp frames
+        // are left in the ramp
+        int32_t mGainEnd;
+        int32_t mGain;
+        int32_t mGainStep;
+        uint32_t mGainRamp;
+        // frames written since exiting standby
+        uint32_t mFramesWritten;
+        // delay added by the driver after the kernel buffer, in frames
+        uint32_t mHwDelay;
+        bool mHwDelayValid;
+        sp<OutputWriter> mWriter;
+        uint32_t mRingFrames;
+        sp<StandbyTimer> mStandbyTimer;
+        bool mWarmStandby;
+        nsecs_t mWarmStandbyTimeout;
+        // time from standby exit to the first buffer in the driver
+        nsecs_t mStartTime;
+        bool mStartWarm;
+        nsecs_t mColdStartTime;
+        nsecs_t mWarmStartTime;
+        uint32_t mColdStarts;
+        uint32_t mWarmStarts;
+        // write() calls and time spent in pcm_write()
+        TimingHistogram mWriteTime;
+        TimingHistogram mDriverTime;
+        // underruns of the pcms closed so far, and the count of the open one
+        // when this stream attached to it
+        uint32_t mUnderruns;
+        uint32_t mUnderrunBase;
+        // adaptive period count: bounds and count for the next open, frames
+        // played in the current underrun window and since the last underrun
+        // or change, and the stable time needed to remove a period
+        bool mAdapt;
+        uint32_t mAdaptMinCnt;
+        uint32_t mAdaptMaxCnt;
+        uint32_t mAdaptPeriodCnt;
+        uint32_t mAdaptXruns;
+        uint32_t mAdaptLastXruns;
+        uint32_t mAdaptWindowFrames;
+        uint32_t mAdaptStableFrames;
+        uint32_t mAdaptStableMs;
+        bool mAdaptLowered;
+        uint32_t mAdaptRaises;
+        uint32_t mAdaptLowers;
+        uint32_t mStandbyEntries;
         //  trace driver operations for dump
         int mDriverOp;
+        nsecs_t mDriverOpStart;
         int mStandbyCnt;
         bool mSleepReq;
     };
 
+public:
+    // Capture DSP stages, implemented in AudioDsp.cpp. Public so that they
+    // can be exercised on their own by the host tests in tests/.
     class DownSampler;
 
     class BufferProvider
@@ -334,62 +753,171 @@ private:
         virtual void releaseBuffer(Buffer* buffer) = 0;
     };
 
+    // Channel conversion by a gain matrix: output channel o of each frame is
+    // the sum of input channels i weighted by the 2.14 fixed-point gain
+    // matrix[o * channelCount + i], saturated to 16 bits. The default matrix
+    // averages all inputs for a mono output, copies a mono input to every
+    // output and maps channels one to one otherwise.
     class ChannelMixer : public BufferProvider {
     public:
+        enum {
+            MAX_CHANNELS = 8,
+            UNITY_GAIN = 1 << 14,
+        };
+
+        // provider may be NULL if only process() is used
         ChannelMixer(uint32_t outChannelCount,
                   uint32_t channelCount,
                   uint32_t frameCount,
                   BufferProvider* provider);
 
-        virtual ~ChannelMixer() {}
+        virtual ~ChannelMixer();
 
         status_t initCheck() { return mStatus; }
+        status_t setMatrix(const int16_t *gains);
+        uint32_t channelCount() { return mChannelCount; }
+        uint32_t outChannelCount() { return mOutChannelCount; }
+        // convert frameCount frames from in to out, which must not overlap
+        void process(const int16_t* in, int16_t* out, size_t frameCount);
         int mix(int16_t* out, size_t *outFrameCount);
+        void dump(String8& result);
 
         virtual status_t getNextBuffer(Buffer* buffer);
         virtual void releaseBuffer(Buffer* buffer);
 
     private:
+        enum {
+            KERNEL_MATRIX,
+            KERNEL_STEREO_TO_MONO,
+            KERNEL_MONO_TO_STEREO,
+        };
+
         status_t    mStatus;
         BufferProvider* mProvider;
         uint32_t mOutChannelCount;
         uint32_t mChannelCount;
+        int mKernel;
+        int16_t mMatrix[MAX_CHANNELS * MAX_CHANNELS];
+        // converted frames handed out by getNextBuffer()
+        int16_t *mBuffer;
+        uint32_t mFrameCount;
+        void *mProviderData;
+        // conversion cost, excluding the time spent in the provider
+        nsecs_t mProcessTime;
+        uint64_t mFramesOut;
     };
 
     class DownSampler {
     public:
+        // if mixer is not NULL, the frames from provider are converted by it
+        // to channelCount channels as they are stored in the filter history
         DownSampler(uint32_t outSampleRate,
                   uint32_t channelCount,
                   uint32_t frameCount,
-                  BufferProvider* provider);
+                  BufferProvider* provider,
+                  ChannelMixer* mixer = NULL);
 
         virtual ~DownSampler();
 
         void reset();
         status_t initCheck() { return mStatus; }
         int resample(int16_t* out, size_t *outFrameCount);
+        void dump(String8& result);
 
     private:
+        void writeHistory(const int16_t* in, uint32_t frames);
+
         status_t    mStatus;
         BufferProvider* mProvider;
+        ChannelMixer* mMixer;
         uint32_t mSampleRate;
         uint32_t mChannelCount;
         uint32_t mFrameCount;
-        int16_t *mInLeft;
-        int16_t *mInRight;
-        int16_t *mTmpLeft;
-        int16_t *mTmpRight;
-        int16_t *mTmp2Left;
-        int16_t *mTmp2Right;
-        int16_t *mOutLeft;
-        int16_t *mOutRight;
-        int mInInBuf;
-        int mInTmpBuf;
-        int mInTmp2Buf;
-        int mOutBufPos;
-        int mInOutBuf;
+        int16_t *mIn;
+        int16_t *mCoeffs;
+        uint32_t mUp;
+        uint32_t mDown;
+        int mNumTaps;
+        int mStride;
+        uint32_t mRingSize;
+        uint32_t mMirrorSize;
+        uint32_t mInInBuf;
+        uint32_t mInPos;
+        uint32_t mPhase;
+        // filtering cost, excluding the time spent in the provider
+        nsecs_t mProcessTime;
+        uint64_t mFramesOut;
     };
 
+private:
+    // Capture pcm shared by all the active inputs. Periods read from the
+    // driver go to a ring that each input copies from at its own pace, doing
+    // its own channel and rate conversion. Open, close, suspend and resume
+    // are called with the AudioHardware lock held.
+    class CaptureSource {
+    public:
+        struct Cursor {
+            uint64_t position;
+            uint32_t generation;
+            uint32_t framesLost;
+        };
+
+        CaptureSource();
+        ~CaptureSource();
+
+        // attach an input: the pcm is opened by the first one, at rate if
+        // native is true and the codec is not already clocked at another
+        // rate (clockRate), otherwise at AUDIO_HW_IN_SAMPLERATE. A native
+        // rate pcm is opened mono if mono is true, stereo otherwise. Fails
+        // if the codec is clocked at a rate the input cannot capture at.
+        status_t open_l(uint32_t rate, bool native, bool mono, uint32_t clockRate,
+                        Cursor *cursor);
+        void close_l(Cursor *cursor);
+        // close the pcm for a codec reconfiguration; the inputs read errors
+        // until resume_l() reopens it at the new clockRate, or until they
+        // reattach if the pcm cannot run at that rate
+        void suspend_l();
+        status_t resume_l(uint32_t clockRate);
+
+        uint32_t sampleRate_l() { return (mPcm != NULL) ? mSampleRate : 0; }
+        uint32_t sampleRate() { return mSampleRate; }
+        uint32_t channelCount() { return mChannelCount; }
+        uint32_t periodSize() { return mPeriodSize; }
+
+        // true if the pcm was reopened since the cursor was last synced
+        bool sync(Cursor *cursor);
+        // frames: in, the frames wanted; out, the frames read. Fails if the
+        // pcm was reopened since the cursor was last synced.
+        status_t read(Cursor *cursor, int16_t *buffer, size_t *frames);
+        void dump(String8& result);
+
+    private:
+        status_t openPcm_l(uint32_t rate, bool native, bool mono, uint32_t clockRate);
+        void closePcm_l();
+
+        Mutex mLock;
+        Condition mCond;
+        struct pcm *mPcm;
+        uint32_t mClients;
+        uint32_t mSampleRate;
+        uint32_t mChannelCount;
+        uint32_t mPeriodSize;
+        int16_t *mRing;
+        uint32_t mRingFrames;
+        // frames captured since the pcm was opened
+        uint64_t mPosition;
+        uint32_t mGeneration;
+        // a period is being read from the driver, without mLock held
+        bool mReading;
+        uint32_t mDriverReads;
+        // time spent in pcm_read()
+        TimingHistogram mDriverTime;
+        // overruns of the pcms closed so far
+        uint32_t mOverruns;
+        //  trace driver operations for dump
+        int mDriverOp;
+        nsecs_t mDriverOpStart;
+    };
 
     class AudioStreamInALSA : public AudioStreamIn, public BufferProvider, public RefBase
     {
@@ -418,7 +946,8 @@ private:
         uint32_t device() { return mDevices; }
         void doStandby_l();
         void close_l();
-        status_t open_l();
+        // clockRate: rate the codec already runs at, 0 if it is free
+        status_t open_l(uint32_t clockRate = 0);
         int standbyCnt() { return mStandbyCnt; }
 
         static size_t getBufferSize(uint32_t sampleRate, int channelCount);
@@ -432,9 +961,17 @@ private:
         void unlock();
 
     private:
+        // true if the capture was reopened with another configuration
+        bool syncCapture();
+        status_t readCapture_l(int16_t *buffer, size_t *frames);
+
         Mutex mLock;
         AudioHardware* mHardware;
-        struct pcm *mPcm;
+        // reading from the shared capture source
+        bool mAttached;
+        TimingHistogram mReadTime;
+        uint32_t mStandbyEntries;
+        CaptureSource::Cursor mCursor;
         struct mixer *mMixer;
         const char *next_route;
         bool mStandby;
@@ -444,6 +981,14 @@ private:
         uint32_t mInputChannelCount;
         uint32_t mChannelCount;
         uint32_t mSampleRate;
+        // true if the codec can capture at mSampleRate, and mono if
+        // mNativeMono is true. Rate and channels the pcm was actually
+        // opened with.
+        bool mNativeRate;
+        bool mNativeMono;
+        uint32_t mPcmSampleRate;
+        uint32_t mPcmChannelCount;
+        uint32_t mPeriodSize;
         size_t mBufferSize;
         DownSampler *mDownSampler;
         ChannelMixer *mChannelMixer;
@@ -29,6 +29,80 @@ namespace android {
 // Common audio policy manager code is implemented in AudioPolicyManagerBase class
 // ----------------------------------------------------------------------------
 
+// Music is played on the deep buffer output of the audio HAL instead of the
+// hardware output when the HAL has one: its long buffer lets the CPU sleep
+// between writes. Other streams keep the short latency of the hardware output.
+audio_io_handle_t AudioPolicyManager::getOutput(AudioSystem::stream_type stream,
+                                                uint32_t samplingRate,
+                                                uint32_t format,
+                                                uint32_t channels,
+                                                AudioSystem::output_flags flags)
+{
+    audio_io_handle_t output = AudioPolicyManagerBase::getOutput(stream, samplingRate,
+                                                                 format, channels, flags);
+
+    if (output == 0 || output != mHardwareOutput || stream != AudioSystem::MUSIC ||
+            mPhoneState == AudioSystem::MODE_IN_CALL || !mDeepBufferAvailable) {
+        return output;
+    }
+
+    if (mDeepBufferOutput == 0) {
+        AudioOutputDescriptor *hwDesc = mOutputs.valueFor(mHardwareOutput);
+        AudioOutputDescriptor *outputDesc = new AudioOutputDescriptor();
+        outputDesc->mDevice = hwDesc->device();
+        outputDesc->mSamplingRate = hwDesc->mSamplingRate;
+        outputDesc->mFormat = hwDesc->mFormat;
+        outputDesc->mChannels = hwDesc->mChannels;
+        outputDesc->mLatency = 0;
+        outputDesc->mFlags = AudioSystem::OUTPUT_FLAG_INDIRECT;
+        mDeepBufferOutput = mpClientInterface->openOutput(&outputDesc->mDevice,
+                                                          &outputDesc->mSamplingRate,
+                                                          &outputDesc->mFormat,
+                                                          &outputDesc->mChannels,
+                                                          &outputDesc->mLatency,
+                                                          outputDesc->mFlags);
+        if (mDeepBufferOutput == 0) {
+            LOGW("getOutput() no deep buffer output, music stays on the hardware output");
+            delete outputDesc;
+            mDeepBufferAvailable = false;
+            return output;
+        }
+        LOGV("getOutput() deep buffer output %d, latency %d",
+             mDeepBufferOutput, outputDesc->mLatency);
+        mOutputs.add(mDeepBufferOutput, outputDesc);
+    }
+    return mDeepBufferOutput;
+}
+
+status_t AudioPolicyManager::setDeviceConnectionState(AudioSystem::audio_devices device,
+                                                      AudioSystem::device_connection_state state,
+                                                      const char *device_address)
+{
+    status_t status = AudioPolicyManagerBase::setDeviceConnectionState(device, state,
+                                                                       device_address);
+    updateDeepBufferOutput();
+    return status;
+}
+
+void AudioPolicyManager::setForceUse(AudioSystem::force_use usage,
+                                     AudioSystem::forced_config config)
+{
+    AudioPolicyManagerBase::setForceUse(usage, config);
+    updateDeepBufferOutput();
+}
+
+void AudioPolicyManager::updateDeepBufferOutput()
+{
+    if (mDeepBufferOutput == 0) {
+        return;
+    }
+    uint32_t device = getNewDevice(mDeepBufferOutput, false);
+    if (device != 0) {
+        setOutputDevice(mDeepBufferOutput, device);
+        applyStreamVolumes(mDeepBufferOutput, device);
+    }
+}
+
 // ---  class factory
 
 
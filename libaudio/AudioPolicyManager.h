@@ -30,10 +30,23 @@ class AudioPolicyManager: public AudioPolicyManagerBase
 
 public:
                 AudioPolicyManager(AudioPolicyClientInterface *clientInterface)
-                : AudioPolicyManagerBase(clientInterface) {}
+                : AudioPolicyManagerBase(clientInterface),
+                  mDeepBufferOutput(0), mDeepBufferAvailable(true) {}
 
         virtual ~AudioPolicyManager() {}
 
+        virtual status_t setDeviceConnectionState(AudioSystem::audio_devices device,
+                                                  AudioSystem::device_connection_state state,
+                                                  const char *device_address);
+        virtual void setForceUse(AudioSystem::force_use usage,
+                                 AudioSystem::forced_config config);
+        virtual audio_io_handle_t getOutput(AudioSystem::stream_type stream,
+                                            uint32_t samplingRate = 0,
+                                            uint32_t format = AudioSystem::FORMAT_DEFAULT,
+                                            uint32_t channels = 0,
+                                            AudioSystem::output_flags flags =
+                                                    AudioSystem::OUTPUT_FLAG_INDIRECT);
+
 protected:
         // true is current platform implements a back microphone
         virtual bool hasBackMicrophone() const { return false; }
@@ -42,5 +55,13 @@ protected:
         virtual bool a2dpUsedForSonification() const { return true; }
 #endif
 
+private:
+        // the base class only routes the hardware and A2DP outputs
+        void updateDeepBufferOutput();
+
+        // second output of the audio HAL with a deep buffer, for music.
+        // Opened on first use, 0 if not open.
+        audio_io_handle_t mDeepBufferOutput;
+        bool mDeepBufferAvailable;
 };
 };
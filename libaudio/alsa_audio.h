@@ -18,6 +18,7 @@
 #define _AUDIO_H_
 
 struct pcm;
+struct timespec;
 
 #define PCM_OUT        0x00000000
 #define PCM_IN         0x10000000
@@ -25,9 +26,14 @@ struct pcm;
 #define PCM_STEREO     0x00000000
 #define PCM_MONO       0x01000000
 
+#define PCM_MMAP       0x02000000
+
 #define PCM_44100HZ    0x00000000
 #define PCM_48000HZ    0x00100000
 #define PCM_8000HZ     0x00200000
+#define PCM_11025HZ    0x00300000
+#define PCM_16000HZ    0x00400000
+#define PCM_22050HZ    0x00500000
 #define PCM_RATE_MASK  0x00F00000
 
 #define PCM_PERIOD_CNT_MIN 2
@@ -44,6 +50,15 @@ struct pcm *pcm_open(unsigned flags);
 int pcm_close(struct pcm *pcm);
 int pcm_ready(struct pcm *pcm);
 
+/* Returns the sample rate (in Hz) encoded in flags. */
+unsigned pcm_rate(unsigned flags);
+
+/* Returns non-zero if the driver can run the stream described by flags
+ * (direction, channels and rate) without opening it for playback or
+ * capture. Returns zero if the device is busy.
+ */
+int pcm_rate_supported(unsigned flags);
+
 /* Returns a human readable reason for the last error. */
 const char *pcm_error(struct pcm *pcm);
 
@@ -52,6 +67,17 @@ const char *pcm_error(struct pcm *pcm);
  */
 unsigned pcm_buffer_size(struct pcm *pcm);
 
+/* Returns the period size (in frames) chosen by the driver. pcm_open()
+ * requests the exact geometry encoded in its flags and only falls back to
+ * a larger period if the driver rejects it.
+ */
+unsigned pcm_period_size(struct pcm *pcm);
+
+/* Returns the number of underruns (or overruns for capture) recovered
+ * from since the pcm was opened.
+ */
+unsigned pcm_get_xruns(struct pcm *pcm);
+
 /* Write data to the fifo.
  * Will start playback on the first write or on a write that
  * occurs after a fifo underrun.
@@ -59,6 +85,38 @@ unsigned pcm_buffer_size(struct pcm *pcm);
 int pcm_write(struct pcm *pcm, void *data, unsigned count);
 int pcm_read(struct pcm *pcm, void *data, unsigned count);
 
+/* Stop the stream and drop any pending data, keeping the hardware
+ * configured. pcm_prepare() readies a stopped stream for the next
+ * transfer, which then starts without further setup.
+ */
+int pcm_stop(struct pcm *pcm);
+int pcm_prepare(struct pcm *pcm);
+
+/* Returns the number of frames written but not yet heard, as reported by
+ * SNDRV_PCM_IOCTL_DELAY: frames still in the buffer plus any FIFO or codec
+ * delay the driver accounts for.
+ */
+int pcm_get_delay(struct pcm *pcm, int *frames);
+
+/* Returns the number of frames available in the buffer (free space for
+ * playback, captured frames for capture) and the CLOCK_MONOTONIC time at
+ * which the hardware pointer was last updated.
+ */
+int pcm_get_htimestamp(struct pcm *pcm, unsigned *avail,
+                       struct timespec *tstamp);
+
+/* Direct access to the kernel buffer of a pcm opened with PCM_MMAP.
+ * pcm_mmap_begin() waits until frames can be transferred, then returns a
+ * pointer to the next area of the buffer and lowers *frames to the number
+ * of contiguous frames available there. Playback starts once the buffer
+ * has been filled, capture on the first call. pcm_mmap_commit() hands the
+ * frames written (or read) back to the driver.
+ * pcm_write() and pcm_read() also work on PCM_MMAP pcms.
+ */
+int pcm_mmap_enabled(struct pcm *pcm);
+int pcm_mmap_begin(struct pcm *pcm, void **data, unsigned *frames);
+int pcm_mmap_commit(struct pcm *pcm, unsigned frames);
+
 struct mixer;
 struct mixer_ctl;
 
@@ -74,7 +132,35 @@ struct mixer_ctl *mixer_get_nth_control(struct mixer *mixer, unsigned n);
 #define CTL_VALUE_MASK	(0x00FFFFFF)
 int mixer_ctl_set(struct mixer_ctl *ctl, unsigned percent);
 
+/* Returns the raw value of element n of a control (item index for
+ * enumerations). The mixer keeps a copy of the values it read or wrote
+ * and only asks the driver again after a change notification.
+ */
+int mixer_ctl_get(struct mixer_ctl *ctl, unsigned n, long *value);
+
+/* Returns the range of the raw values of an integer control. */
+int mixer_ctl_get_range(struct mixer_ctl *ctl, long *min, long *max);
+
 int mixer_ctl_select(struct mixer_ctl *ctl, const char *value);
+
+/* Same as mixer_ctl_set() and mixer_ctl_select(), but leave the control
+ * alone if it already holds the value.
+ * Returns 1 if the control was written, 0 if not, -1 on error.
+ */
+int mixer_ctl_update(struct mixer_ctl *ctl, unsigned percent);
+int mixer_ctl_update_select(struct mixer_ctl *ctl, const char *value);
 void mixer_ctl_print(struct mixer_ctl *ctl);
 
+/* Selects the device backend of the pcm and mixer functions by name:
+ * "kernel" (the /dev/snd nodes) or "sim", a simulated card for running
+ * without sound hardware. Unless selected before the first pcm or mixer
+ * call, the backend comes from the ALSA_BACKEND_PROPERTY system property,
+ * else the ALSA_BACKEND_ENV environment variable.
+ * Returns non-zero if there is no such backend.
+ */
+#define ALSA_BACKEND_PROPERTY "audio.alsa.backend"
+#define ALSA_BACKEND_ENV "ALSA_BACKEND"
+int alsa_select_backend(const char *name);
+const char *alsa_backend_name(void);
+
 #endif
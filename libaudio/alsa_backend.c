@@ -0,0 +1,123 @@
+/*
+** Copyright 2010, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#define LOG_TAG "alsa_backend"
+//#define LOG_NDEBUG 0
+#include <cutils/log.h>
+#include <cutils/properties.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#include "alsa_audio.h"
+#include "alsa_backend.h"
+
+#ifdef ALSA_DEFAULT_BACKEND_SIM
+#define ALSA_DEFAULT_BACKEND "sim"
+#else
+#define ALSA_DEFAULT_BACKEND "kernel"
+#endif
+
+static int kernel_open(const char *path, int flags)
+{
+    return open(path, flags);
+}
+
+static int kernel_ioctl(int fd, unsigned request, void *arg)
+{
+    return ioctl(fd, request, arg);
+}
+
+static void *kernel_mmap(void *addr, size_t length, int prot, int flags,
+                         int fd, off_t offset)
+{
+    return mmap(addr, length, prot, flags, fd, offset);
+}
+
+const struct alsa_backend alsa_kernel_backend = {
+    .name = "kernel",
+    .open = kernel_open,
+    .close = close,
+    .ioctl = kernel_ioctl,
+    .read = read,
+    .mmap = kernel_mmap,
+    .munmap = munmap,
+    .poll = poll,
+};
+
+static const struct alsa_backend *backends[] = {
+    &alsa_kernel_backend,
+    &alsa_sim_backend,
+};
+
+static const struct alsa_backend *current;
+static pthread_once_t current_once = PTHREAD_ONCE_INIT;
+
+static void alsa_backend_init(void)
+{
+    char value[PROPERTY_VALUE_MAX];
+    const char *name;
+
+        /* already chosen by alsa_select_backend() */
+    if (current)
+        return;
+
+    property_get(ALSA_BACKEND_PROPERTY, value, "");
+    name = value;
+    if (!name[0])
+        name = getenv(ALSA_BACKEND_ENV);
+    if (!name || !name[0])
+        name = ALSA_DEFAULT_BACKEND;
+
+    if (alsa_select_backend(name)) {
+        LOGW("unknown alsa backend '%s', using the kernel", name);
+        current = &alsa_kernel_backend;
+    }
+}
+
+const struct alsa_backend *alsa_backend(void)
+{
+    pthread_once(&current_once, alsa_backend_init);
+    return current;
+}
+
+int alsa_select_backend(const char *name)
+{
+    unsigned n;
+
+    for (n = 0; n < sizeof(backends) / sizeof(backends[0]); n++) {
+        if (!strcmp(backends[n]->name, name)) {
+            if (current != backends[n])
+                LOGI("using the %s alsa backend", name);
+            current = backends[n];
+            return 0;
+        }
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+const char *alsa_backend_name(void)
+{
+    return alsa_backend()->name;
+}
@@ -0,0 +1,55 @@
+/*
+** Copyright 2010, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef _ALSA_BACKEND_H_
+#define _ALSA_BACKEND_H_
+
+#include <sys/types.h>
+#include <poll.h>
+
+/* Device access used by alsa_pcm.c and alsa_mixer.c. Every file
+ * descriptor they use comes from the open() of the current backend and is
+ * only passed back to that backend.
+ */
+struct alsa_backend {
+    const char *name;
+    int (*open)(const char *path, int flags);
+    int (*close)(int fd);
+    int (*ioctl)(int fd, unsigned request, void *arg);
+    ssize_t (*read)(int fd, void *buf, size_t count);
+    void *(*mmap)(void *addr, size_t length, int prot, int flags,
+                  int fd, off_t offset);
+    int (*munmap)(void *addr, size_t length);
+    int (*poll)(struct pollfd *fds, nfds_t nfds, int timeout);
+};
+
+/* /dev/snd device nodes */
+extern const struct alsa_backend alsa_kernel_backend;
+/* clocked pcms and a scripted control set, see alsa_sim.c */
+extern const struct alsa_backend alsa_sim_backend;
+
+const struct alsa_backend *alsa_backend(void);
+
+#define alsa_open(path, flags) alsa_backend()->open(path, flags)
+#define alsa_close(fd) alsa_backend()->close(fd)
+#define alsa_ioctl(fd, request, arg) alsa_backend()->ioctl(fd, request, arg)
+#define alsa_read(fd, buf, count) alsa_backend()->read(fd, buf, count)
+#define alsa_mmap(addr, length, prot, flags, fd, offset) \
+    alsa_backend()->mmap(addr, length, prot, flags, fd, offset)
+#define alsa_munmap(addr, length) alsa_backend()->munmap(addr, length)
+#define alsa_poll(fds, nfds, timeout) alsa_backend()->poll(fds, nfds, timeout)
+
+#endif
@@ -22,6 +22,7 @@
 #include <errno.h>
 #include <ctype.h>
 
+#include <sys/ioctl.h>
 #include <linux/ioctl.h>
 #define __force
 #define __bitwise
@@ -29,6 +30,7 @@
 #include "asound.h"
 
 #include "alsa_audio.h"
+#include "alsa_backend.h"
 
 static const char *elem_iface_name(snd_ctl_elem_iface_t n)
 {
@@ -63,6 +65,12 @@ struct mixer_ctl {
     struct mixer *mixer;
     struct snd_ctl_elem_info *info;
     char **ename;
+    /* info and ename are only fetched on first lookup */
+    int info_valid;
+
+    /* last value read or written, valid until the next change event */
+    struct snd_ctl_elem_value *shadow;
+    int shadow_valid;
 };
 
 struct mixer {
@@ -70,6 +78,7 @@ struct mixer {
     struct snd_ctl_elem_info *info;
     struct mixer_ctl *ctl;
     unsigned count;
+    int subscribed;
 };
 
 void mixer_close(struct mixer *mixer)
@@ -77,10 +86,12 @@ void mixer_close(struct mixer *mixer)
     unsigned n,m;
 
     if (mixer->fd >= 0)
-        close(mixer->fd);
+        alsa_close(mixer->fd);
 
     if (mixer->ctl) {
         for (n = 0; n < mixer->count; n++) {
+            if (mixer->ctl[n].shadow)
+                free(mixer->ctl[n].shadow);
             if (mixer->ctl[n].ename) {
                 unsigned max = mixer->ctl[n].info->value.enumerated.items;
                 for (m = 0; m < max; m++)
@@ -97,21 +108,59 @@ void mixer_close(struct mixer *mixer)
     free(mixer);
 }
 
+static int mixer_ctl_load(struct mixer_ctl *ctl)
+{
+    struct snd_ctl_elem_info *ei = ctl->info;
+    struct snd_ctl_elem_info tmp;
+    int fd = ctl->mixer->fd;
+    unsigned m;
+
+    if (ctl->info_valid)
+        return 0;
+
+    if (alsa_ioctl(fd, SNDRV_CTL_IOCTL_ELEM_INFO, ei) < 0)
+        return -1;
+    if (ei->type == SNDRV_CTL_ELEM_TYPE_ENUMERATED) {
+        char **enames = calloc(ei->value.enumerated.items, sizeof(char*));
+        if (!enames)
+            return -1;
+        ctl->ename = enames;
+        for (m = 0; m < ei->value.enumerated.items; m++) {
+            memset(&tmp, 0, sizeof(tmp));
+            tmp.id.numid = ei->id.numid;
+            tmp.value.enumerated.item = m;
+            if (alsa_ioctl(fd, SNDRV_CTL_IOCTL_ELEM_INFO, &tmp) < 0)
+                goto fail;
+            enames[m] = strdup(tmp.value.enumerated.name);
+            if (!enames[m])
+                goto fail;
+        }
+    }
+    ctl->info_valid = 1;
+    return 0;
+
+fail:
+    for (m = 0; m < ei->value.enumerated.items; m++)
+        free(ctl->ename[m]);
+    free(ctl->ename);
+    ctl->ename = 0;
+    return -1;
+}
+
 struct mixer *mixer_open(void)
 {
     struct snd_ctl_elem_list elist;
-    struct snd_ctl_elem_info tmp;
     struct snd_ctl_elem_id *eid = NULL;
     struct mixer *mixer = NULL;
-    unsigned n, m;
+    unsigned n;
     int fd;
 
-    fd = open("/dev/snd/controlC0", O_RDWR);
+    fd = alsa_open("/dev/snd/controlC0", O_RDWR);
     if (fd < 0)
         return 0;
 
     memset(&elist, 0, sizeof(elist));
-    if (ioctl(fd, SNDRV_CTL_IOCTL_ELEM_LIST, &elist) < 0)
+    if (alsa_ioctl(fd, SNDRV_CTL_IOCTL_ELEM_LIST, &elist) < 0)
         goto fail;
 
     mixer = calloc(1, sizeof(*mixer));
@@ -131,35 +180,28 @@ struct mixer *mixer_open(void)
     mixer->fd = fd;
     elist.space = mixer->count;
     elist.pids = eid;
-    if (ioctl(fd, SNDRV_CTL_IOCTL_ELEM_LIST, &elist) < 0)
+    if (alsa_ioctl(fd, SNDRV_CTL_IOCTL_ELEM_LIST, &elist) < 0)
         goto fail;
 
+        /* the element list has the names, which is all the lookups
+         * need; the rest of the info is fetched when a control is used.
+         */
     for (n = 0; n < mixer->count; n++) {
-        struct snd_ctl_elem_info *ei = mixer->info + n;
-        ei->id.numid = eid[n].numid;
-        if (ioctl(fd, SNDRV_CTL_IOCTL_ELEM_INFO, ei) < 0)
-            goto fail;
-        mixer->ctl[n].info = ei;
+        mixer->info[n].id = eid[n];
+        mixer->ctl[n].info = mixer->info + n;
         mixer->ctl[n].mixer = mixer;
-        if (ei->type == SNDRV_CTL_ELEM_TYPE_ENUMERATED) {
-            char **enames = calloc(ei->value.enumerated.items, sizeof(char*));
-            if (!enames)
-                goto fail;
-            mixer->ctl[n].ename = enames;
-            for (m = 0; m < ei->value.enumerated.items; m++) {
-                memset(&tmp, 0, sizeof(tmp));
-                tmp.id.numid = ei->id.numid;
-                tmp.value.enumerated.item = m;
-                if (ioctl(fd, SNDRV_CTL_IOCTL_ELEM_INFO, &tmp) < 0)
-                    goto fail;
-                enames[m] = strdup(tmp.value.enumerated.name);
-                if (!enames[m])
-                    goto fail;
-            }
-        }
     }
 
     free(eid);
+
+        /* get notified of changes made by others to keep the shadow
+         * values coherent; events are drained without blocking.
+         */
+    n = 1;
+    if (alsa_ioctl(fd, SNDRV_CTL_IOCTL_SUBSCRIBE_EVENTS, &n) == 0 &&
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) == 0)
+        mixer->subscribed = 1;
+
     return mixer;
 
 fail:
@@ -168,7 +210,7 @@ fail:
     if (mixer)
         mixer_close(mixer);
     else if (fd >= 0)
-        close(fd);
+        alsa_close(fd);
     return 0;
 }
 
@@ -180,6 +222,8 @@ void mixer_dump(struct mixer *mixer)
     for (n = 0; n < mixer->count; n++) {
         struct snd_ctl_elem_info *ei = mixer->info + n;
 
+        if (mixer_ctl_load(mixer->ctl + n) < 0)
+            continue;
         printf("%4d %5s %3d %3d %3d %3d %c%c%c%c%c%c%c%c%c %-6s %s",
                ei->id.numid, elem_iface_name(ei->id.iface),
                ei->id.device, ei->id.subdevice, ei->id.index,
@@ -230,6 +274,8 @@ struct mixer_ctl *mixer_get_control(struct mixer *mixer,
     for (n = 0; n < mixer->count; n++) {
         if (mixer->info[n].id.index == index) {
             if (!strcmp(name, (char*) mixer->info[n].id.name)) {
+                if (mixer_ctl_load(mixer->ctl + n) < 0)
+                    return 0;
                 return mixer->ctl + n;
             }
         }
@@ -237,9 +283,120 @@ struct mixer_ctl *mixer_get_control(struct mixer *mixer,
     return 0;
 }
 
+static struct mixer_ctl *mixer_get_numid(struct mixer *mixer, unsigned numid)
+{
+    unsigned n;
+
+        /* numids are usually allocated contiguously */
+    n = numid - mixer->info[0].id.numid;
+    if (n < mixer->count && mixer->info[n].id.numid == numid)
+        return mixer->ctl + n;
+
+    for (n = 0; n < mixer->count; n++)
+        if (mixer->info[n].id.numid == numid)
+            return mixer->ctl + n;
+    return 0;
+}
+
+/* Drop the shadow values of changed controls. Our own writes are notified
+ * too, but cannot be told apart: the kernel merges the pending events of a
+ * control, so the echo of our write may carry someone else's change as well.
+ */
+static void mixer_sync(struct mixer *mixer)
+{
+    struct snd_ctl_event ev;
+    struct mixer_ctl *ctl;
+
+    while (alsa_read(mixer->fd, &ev, sizeof(ev)) == sizeof(ev)) {
+        if (ev.type != SNDRV_CTL_EVENT_ELEM)
+            continue;
+        ctl = mixer_get_numid(mixer, ev.data.elem.id.numid);
+        if (ctl)
+            ctl->shadow_valid = 0;
+    }
+}
+
+static int mixer_ctl_cacheable(struct mixer_ctl *ctl)
+{
+    return ctl->mixer->subscribed &&
+        !(ctl->info->access & SNDRV_CTL_ELEM_ACCESS_VOLATILE);
+}
+
+/* Returns the current value of ctl, from the shadow copy if it is valid. */
+static struct snd_ctl_elem_value *mixer_ctl_read(struct mixer_ctl *ctl)
+{
+    if (!ctl->shadow) {
+        ctl->shadow = calloc(1, sizeof(*ctl->shadow));
+        if (!ctl->shadow)
+            return 0;
+    }
+
+    if (mixer_ctl_cacheable(ctl)) {
+        mixer_sync(ctl->mixer);
+        if (ctl->shadow_valid)
+            return ctl->shadow;
+    }
+
+    memset(ctl->shadow, 0, sizeof(*ctl->shadow));
+    ctl->shadow->id.numid = ctl->info->id.numid;
+    if (alsa_ioctl(ctl->mixer->fd, SNDRV_CTL_IOCTL_ELEM_READ, ctl->shadow) < 0)
+        return 0;
+    ctl->shadow_valid = 1;
+    return ctl->shadow;
+}
+
+int mixer_ctl_get(struct mixer_ctl *ctl, unsigned n, long *value)
+{
+    struct snd_ctl_elem_value *ev;
+
+    if (n >= ctl->info->count) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ev = mixer_ctl_read(ctl);
+    if (!ev)
+        return -1;
+
+    switch (ctl->info->type) {
+    case SNDRV_CTL_ELEM_TYPE_BOOLEAN:
+    case SNDRV_CTL_ELEM_TYPE_INTEGER:
+        *value = ev->value.integer.value[n];
+        break;
+    case SNDRV_CTL_ELEM_TYPE_INTEGER64:
+        *value = (long)ev->value.integer64.value[n];
+        break;
+    case SNDRV_CTL_ELEM_TYPE_ENUMERATED:
+        *value = ev->value.enumerated.item[n];
+        break;
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+int mixer_ctl_get_range(struct mixer_ctl *ctl, long *min, long *max)
+{
+    switch (ctl->info->type) {
+    case SNDRV_CTL_ELEM_TYPE_INTEGER:
+        *min = ctl->info->value.integer.min;
+        *max = ctl->info->value.integer.max;
+        break;
+    case SNDRV_CTL_ELEM_TYPE_INTEGER64:
+        *min = (long)ctl->info->value.integer64.min;
+        *max = (long)ctl->info->value.integer64.max;
+        break;
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
 struct mixer_ctl *mixer_get_nth_control(struct mixer *mixer, unsigned n)
 {
-    if (n < mixer->count)
+    if (n < mixer->count && mixer_ctl_load(mixer->ctl + n) == 0)
         return mixer->ctl + n;
     return 0;
 }
@@ -251,7 +408,7 @@ void mixer_ctl_print(struct mixer_ctl *ctl)
 
     memset(&ev, 0, sizeof(ev));
     ev.id.numid = ctl->info->id.numid;
-    if (ioctl(ctl->mixer->fd, SNDRV_CTL_IOCTL_ELEM_READ, &ev))
+    if (alsa_ioctl(ctl->mixer->fd, SNDRV_CTL_IOCTL_ELEM_READ, &ev))
         return;
     printf("%s:", ctl->info->id.name);
 
@@ -312,20 +469,21 @@ static long long scale_int64(struct snd_ctl_elem_info *ei, unsigned _percent)
     return ei->value.integer.min + (range / percent);
 }
 
-int mixer_ctl_set(struct mixer_ctl *ctl, unsigned percent)
+/* Fill ev with the value mixer_ctl_set() would write. */
+static int mixer_ctl_value(struct mixer_ctl *ctl, unsigned percent,
+                           struct snd_ctl_elem_value *ev)
 {
-    struct snd_ctl_elem_value ev;
     unsigned n;
     int raw = percent & CTL_VALUE_RAW;
 
     percent &= CTL_VALUE_MASK;
 
-    memset(&ev, 0, sizeof(ev));
-    ev.id.numid = ctl->info->id.numid;
+    memset(ev, 0, sizeof(*ev));
+    ev->id.numid = ctl->info->id.numid;
     switch (ctl->info->type) {
     case SNDRV_CTL_ELEM_TYPE_BOOLEAN:
         for (n = 0; n < ctl->info->count; n++)
-            ev.value.integer.value[n] = !!percent;
+            ev->value.integer.value[n] = !!percent;
         break;
     case SNDRV_CTL_ELEM_TYPE_INTEGER: {
         long value;
@@ -334,7 +492,7 @@ int mixer_ctl_set(struct mixer_ctl *ctl, unsigned percent)
 	else
 		value = percent;
         for (n = 0; n < ctl->info->count; n++)
-            ev.value.integer.value[n] = value;
+            ev->value.integer.value[n] = value;
         break;
     }
     case SNDRV_CTL_ELEM_TYPE_INTEGER64: {
@@ -344,21 +502,21 @@ int mixer_ctl_set(struct mixer_ctl *ctl, unsigned percent)
 	else
 		value = percent;
         for (n = 0; n < ctl->info->count; n++)
-            ev.value.integer64.value[n] = value;
+            ev->value.integer64.value[n] = value;
         break;
     }
     default:
         errno = EINVAL;
         return -1;
     }
-
-    return ioctl(ctl->mixer->fd, SNDRV_CTL_IOCTL_ELEM_WRITE, &ev);
+    return 0;
 }
 
-int mixer_ctl_select(struct mixer_ctl *ctl, const char *value)
+/* Fill ev with the enumerated item mixer_ctl_select() would write. */
+static int mixer_ctl_item(struct mixer_ctl *ctl, const char *value,
+                          struct snd_ctl_elem_value *ev)
 {
     unsigned n, max;
-    struct snd_ctl_elem_value ev;
 
     if (ctl->info->type != SNDRV_CTL_ELEM_TYPE_ENUMERATED) {
         errno = EINVAL;
@@ -368,11 +526,9 @@ int mixer_ctl_select(struct mixer_ctl *ctl, const char *value)
     max = ctl->info->value.enumerated.items;
     for (n = 0; n < max; n++) {
         if (!strcmp(value, ctl->ename[n])) {
-            memset(&ev, 0, sizeof(ev));
-            ev.value.enumerated.item[0] = n;
-            ev.id.numid = ctl->info->id.numid;
-            if (ioctl(ctl->mixer->fd, SNDRV_CTL_IOCTL_ELEM_WRITE, &ev) < 0)
-                return -1;
+            memset(ev, 0, sizeof(*ev));
+            ev->value.enumerated.item[0] = n;
+            ev->id.numid = ctl->info->id.numid;
             return 0;
         }
     }
@@ -380,3 +536,77 @@ int mixer_ctl_select(struct mixer_ctl *ctl, const char *value)
     errno = EINVAL;
     return -1;
 }
+
+static int mixer_ctl_write(struct mixer_ctl *ctl, struct snd_ctl_elem_value *ev)
+{
+    if (alsa_ioctl(ctl->mixer->fd, SNDRV_CTL_IOCTL_ELEM_WRITE, ev) < 0) {
+        ctl->shadow_valid = 0;
+        return -1;
+    }
+
+        /* the event of a change, ours or not, invalidates the shadow at the
+         * next read; a write of the value the control held sends none
+         */
+    if (ctl->shadow && mixer_ctl_cacheable(ctl)) {
+        memcpy(&ctl->shadow->value, &ev->value, sizeof(ev->value));
+        ctl->shadow_valid = 1;
+    }
+    return 0;
+}
+
+/* Write ev unless the control already holds that value.
+ * Returns 1 if the control was written, 0 if it was left alone.
+ */
+static int mixer_ctl_update_value(struct mixer_ctl *ctl,
+                                  struct snd_ctl_elem_value *ev)
+{
+    struct snd_ctl_elem_value *cur = mixer_ctl_read(ctl);
+
+    if (cur && !memcmp(&cur->value, &ev->value, sizeof(ev->value)))
+        return 0;
+
+    if (mixer_ctl_write(ctl, ev) < 0)
+        return -1;
+    return 1;
+}
+
+int mixer_ctl_set(struct mixer_ctl *ctl, unsigned percent)
+{
+    struct snd_ctl_elem_value ev;
+
+    if (mixer_ctl_value(ctl, percent, &ev))
+        return -1;
+
+    return mixer_ctl_write(ctl, &ev);
+}
+
+int mixer_ctl_update(struct mixer_ctl *ctl, unsigned percent)
+{
+    struct snd_ctl_elem_value ev;
+
+    if (mixer_ctl_value(ctl, percent, &ev))
+        return -1;
+
+    return mixer_ctl_update_value(ctl, &ev);
+}
+
+int mixer_ctl_select(struct mixer_ctl *ctl, const char *value)
+{
+    struct snd_ctl_elem_value ev;
+
+    if (mixer_ctl_item(ctl, value, &ev))
+        return -1;
+
+        /* always written: some drivers use enumerations as commands */
+    return mixer_ctl_write(ctl, &ev);
+}
+
+int mixer_ctl_update_select(struct mixer_ctl *ctl, const char *value)
+{
+    struct snd_ctl_elem_value ev;
+
+    if (mixer_ctl_item(ctl, value, &ev))
+        return -1;
+
+    return mixer_ctl_update_value(ctl, &ev);
+}
@@ -27,13 +27,16 @@
 #include <errno.h>
 #include <unistd.h>
 
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/time.h>
+#include <time.h>
 
 #include <linux/ioctl.h>
 
 #include "alsa_audio.h"
+#include "alsa_backend.h"
 
 #define __force
 #define __bitwise
@@ -106,6 +109,16 @@ static void param_set_int(struct snd_pcm_hw_params *p, int n, unsigned val)
     }
 }
 
+static unsigned param_get_int(struct snd_pcm_hw_params *p, int n)
+{
+    if (param_is_interval(n)) {
+        struct snd_interval *i = param_to_interval(p, n);
+        if (i->integer)
+            return i->max;
+    }
+    return 0;
+}
+
 static void param_init(struct snd_pcm_hw_params *p)
 {
     int n;
@@ -190,13 +203,27 @@ static void info_dump(struct snd_pcm_info *info) {}
 
 #define PCM_ERROR_MAX 128
 
+/* maximum time to wait for the hardware pointer to move in mmap mode */
+#define PCM_MMAP_WAIT_MS 1000
+
 struct pcm {
     int fd;
     unsigned flags;
     int running:1;
+    int prepared:1;
     int underruns;
     unsigned buffer_size;
+    unsigned period_size;
+    int tstamp_monotonic;
     char error[PCM_ERROR_MAX];
+
+    /* mmap access */
+    unsigned frame_size;
+    unsigned boundary;
+    void *mmap_buffer;
+    struct snd_pcm_mmap_status *mmap_status;
+    struct snd_pcm_mmap_control *mmap_control;
+    struct snd_pcm_sync_ptr *sync_ptr;
 };
 
 unsigned pcm_buffer_size(struct pcm *pcm)
@@ -204,6 +231,16 @@ unsigned pcm_buffer_size(struct pcm *pcm)
     return pcm->buffer_size;
 }
 
+unsigned pcm_period_size(struct pcm *pcm)
+{
+    return pcm->period_size;
+}
+
+unsigned pcm_get_xruns(struct pcm *pcm)
+{
+    return pcm->underruns;
+}
+
 const char* pcm_error(struct pcm *pcm)
 {
     return pcm->error;
@@ -225,6 +262,211 @@ static int oops(struct pcm *pcm, int e, const char *fmt, ...)
     return -1;
 }
 
+int pcm_get_delay(struct pcm *pcm, int *frames)
+{
+    snd_pcm_sframes_t delay;
+
+    if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_DELAY, &delay))
+        return oops(pcm, errno, "cannot get delay");
+    *frames = delay;
+    return 0;
+}
+
+int pcm_get_htimestamp(struct pcm *pcm, unsigned *avail,
+                       struct timespec *tstamp)
+{
+    struct snd_pcm_status status;
+
+    memset(&status, 0, sizeof(status));
+    if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_STATUS, &status))
+        return oops(pcm, errno, "cannot get status");
+
+    *avail = status.avail;
+    if (pcm->tstamp_monotonic &&
+        (status.tstamp.tv_sec != 0 || status.tstamp.tv_nsec != 0)) {
+        *tstamp = status.tstamp;
+    } else {
+            /* kernel time stamps are not monotonic: use the time of the
+             * status update instead.
+             */
+        clock_gettime(CLOCK_MONOTONIC, tstamp);
+    }
+    return 0;
+}
+
+int pcm_mmap_enabled(struct pcm *pcm)
+{
+    return pcm->mmap_buffer != NULL;
+}
+
+/* Exchange the application and hardware pointers with the kernel when the
+ * status and control pages could not be mapped.
+ */
+static int pcm_sync_ptr(struct pcm *pcm, int flags)
+{
+    if (pcm->sync_ptr) {
+        pcm->sync_ptr->flags = flags;
+        return alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_SYNC_PTR, pcm->sync_ptr);
+    }
+    if (flags & SNDRV_PCM_SYNC_PTR_HWSYNC)
+        return alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_HWSYNC, NULL);
+    return 0;
+}
+
+static unsigned pcm_mmap_avail(struct pcm *pcm)
+{
+    int avail;
+
+    if (pcm->flags & PCM_IN) {
+        avail = pcm->mmap_status->hw_ptr - pcm->mmap_control->appl_ptr;
+        if (avail < 0)
+            avail += pcm->boundary;
+    } else {
+        avail = pcm->mmap_status->hw_ptr + pcm->buffer_size -
+                pcm->mmap_control->appl_ptr;
+        if (avail < 0)
+            avail += pcm->boundary;
+        else if ((unsigned)avail >= pcm->boundary)
+            avail -= pcm->boundary;
+    }
+    return avail;
+}
+
+int pcm_mmap_begin(struct pcm *pcm, void **data, unsigned *frames)
+{
+    struct pollfd pfd;
+    snd_pcm_state_t state;
+    unsigned avail;
+    unsigned offset;
+
+    if (!pcm->mmap_buffer)
+        return -EINVAL;
+
+    for (;;) {
+        if (pcm_sync_ptr(pcm, SNDRV_PCM_SYNC_PTR_HWSYNC)) {
+            if (errno != EPIPE)
+                return oops(pcm, errno, "cannot sync stream pointers");
+            state = SNDRV_PCM_STATE_XRUN;
+        } else {
+            state = pcm->mmap_status->state;
+        }
+
+        switch (state) {
+        case SNDRV_PCM_STATE_XRUN:
+                /* we failed to make our window -- try to restart */
+            pcm->underruns++;
+            /* fall through */
+        case SNDRV_PCM_STATE_SETUP:
+            pcm->running = 0;
+            if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_PREPARE, NULL))
+                return oops(pcm, errno, "cannot prepare channel");
+                /* pick up the pointers reset by prepare */
+            if (pcm_sync_ptr(pcm, SNDRV_PCM_SYNC_PTR_APPL))
+                return oops(pcm, errno, "cannot sync stream pointers");
+            continue;
+        case SNDRV_PCM_STATE_PREPARED:
+            if (pcm->flags & PCM_IN) {
+                if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_START, NULL))
+                    return oops(pcm, errno, "cannot start channel");
+                pcm->running = 1;
+                continue;
+            }
+            break;
+        default:
+            break;
+        }
+
+        avail = pcm_mmap_avail(pcm);
+        if (avail)
+            break;
+
+        if (state == SNDRV_PCM_STATE_PREPARED) {
+                /* playback buffer is full: start the stream */
+            if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_START, NULL))
+                return oops(pcm, errno, "cannot start channel");
+            pcm->running = 1;
+            continue;
+        }
+
+        pfd.fd = pcm->fd;
+        pfd.events = (pcm->flags & PCM_IN) ? POLLIN : POLLOUT;
+        pfd.revents = 0;
+        if (alsa_poll(&pfd, 1, PCM_MMAP_WAIT_MS) == 0)
+            return oops(pcm, ETIMEDOUT, "timeout waiting for stream data");
+    }
+
+    offset = pcm->mmap_control->appl_ptr % pcm->buffer_size;
+    if (avail > pcm->buffer_size - offset)
+        avail = pcm->buffer_size - offset;
+    if (*frames > avail)
+        *frames = avail;
+    *data = (char *)pcm->mmap_buffer + offset * pcm->frame_size;
+    return 0;
+}
+
+int pcm_mmap_commit(struct pcm *pcm, unsigned frames)
+{
+    unsigned appl_ptr;
+
+    if (!pcm->mmap_buffer)
+        return -EINVAL;
+
+    appl_ptr = pcm->mmap_control->appl_ptr + frames;
+    if (appl_ptr >= pcm->boundary)
+        appl_ptr -= pcm->boundary;
+    pcm->mmap_control->appl_ptr = appl_ptr;
+
+    if (pcm_sync_ptr(pcm, 0))
+        return oops(pcm, errno, "cannot commit stream data");
+    return 0;
+}
+
+/* Copy data to or from the mmap buffer for the pcm_write() and pcm_read()
+ * compatibility paths.
+ */
+static int pcm_mmap_transfer(struct pcm *pcm, void *data, unsigned count)
+{
+    char *p = data;
+    unsigned frames = count / pcm->frame_size;
+
+    while (frames) {
+        void *buf;
+        unsigned n = frames;
+
+        if (pcm_mmap_begin(pcm, &buf, &n))
+            return -1;
+        if (pcm->flags & PCM_IN)
+            memcpy(p, buf, n * pcm->frame_size);
+        else
+            memcpy(buf, p, n * pcm->frame_size);
+        if (pcm_mmap_commit(pcm, n))
+            return -1;
+        p += n * pcm->frame_size;
+        frames -= n;
+    }
+    return 0;
+}
+
+int pcm_stop(struct pcm *pcm)
+{
+    pcm->running = 0;
+    pcm->prepared = 0;
+    if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_DROP, NULL))
+        return oops(pcm, errno, "cannot stop channel");
+    return 0;
+}
+
+int pcm_prepare(struct pcm *pcm)
+{
+    pcm->running = 0;
+    if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_PREPARE, NULL))
+        return oops(pcm, errno, "cannot prepare channel");
+    if (pcm->mmap_buffer && pcm_sync_ptr(pcm, SNDRV_PCM_SYNC_PTR_APPL))
+        return oops(pcm, errno, "cannot sync stream pointers");
+    pcm->prepared = 1;
+    return 0;
+}
+
 int pcm_write(struct pcm *pcm, void *data, unsigned count)
 {
     struct snd_xferi x;
@@ -232,19 +474,23 @@ int pcm_write(struct pcm *pcm, void *data, unsigned count)
     if (pcm->flags & PCM_IN)
         return -EINVAL;
 
+    if (pcm->mmap_buffer)
+        return pcm_mmap_transfer(pcm, data, count);
+
     x.buf = data;
     x.frames = (pcm->flags & PCM_MONO) ? (count / 2) : (count / 4);
 
     for (;;) {
         if (!pcm->running) {
-            if (ioctl(pcm->fd, SNDRV_PCM_IOCTL_PREPARE))
+            if (!pcm->prepared && alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_PREPARE, NULL))
                 return oops(pcm, errno, "cannot prepare channel");
-            if (ioctl(pcm->fd, SNDRV_PCM_IOCTL_WRITEI_FRAMES, &x))
+            pcm->prepared = 0;
+            if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_WRITEI_FRAMES, &x))
                 return oops(pcm, errno, "cannot write initial data");
             pcm->running = 1;
             return 0;
         }
-        if (ioctl(pcm->fd, SNDRV_PCM_IOCTL_WRITEI_FRAMES, &x)) {
+        if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_WRITEI_FRAMES, &x)) {
             pcm->running = 0;
             if (errno == EPIPE) {
                     /* we failed to make our window -- try to restart */
@@ -264,19 +510,23 @@ int pcm_read(struct pcm *pcm, void *data, unsigned count)
     if (!(pcm->flags & PCM_IN))
         return -EINVAL;
 
+    if (pcm->mmap_buffer)
+        return pcm_mmap_transfer(pcm, data, count);
+
     x.buf = data;
     x.frames = (pcm->flags & PCM_MONO) ? (count / 2) : (count / 4);
 
 //    LOGV("read() %d frames", x.frames);
     for (;;) {
         if (!pcm->running) {
-            if (ioctl(pcm->fd, SNDRV_PCM_IOCTL_PREPARE))
+            if (!pcm->prepared && alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_PREPARE, NULL))
                 return oops(pcm, errno, "cannot prepare channel");
-            if (ioctl(pcm->fd, SNDRV_PCM_IOCTL_START))
+            pcm->prepared = 0;
+            if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_START, NULL))
                 return oops(pcm, errno, "cannot start channel");
             pcm->running = 1;
         }
-        if (ioctl(pcm->fd, SNDRV_PCM_IOCTL_READI_FRAMES, &x)) {
+        if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_READI_FRAMES, &x)) {
             pcm->running = 0;
             if (errno == EPIPE) {
                     /* we failed to make our window -- try to restart */
@@ -290,18 +540,148 @@ int pcm_read(struct pcm *pcm, void *data, unsigned count)
     }
 }
 
+unsigned pcm_rate(unsigned flags)
+{
+    switch (flags & PCM_RATE_MASK) {
+    case PCM_48000HZ:
+        return 48000;
+    case PCM_8000HZ:
+        return 8000;
+    case PCM_11025HZ:
+        return 11025;
+    case PCM_16000HZ:
+        return 16000;
+    case PCM_22050HZ:
+        return 22050;
+    case PCM_44100HZ:
+    default:
+        return 44100;
+    }
+}
+
+static const char *pcm_device(unsigned flags)
+{
+    return (flags & PCM_IN) ? "/dev/snd/pcmC0D0c" : "/dev/snd/pcmC0D0p";
+}
+
+/* Restrict params to the sample format and channel layout in flags. */
+static void pcm_params_init(struct snd_pcm_hw_params *params, unsigned flags)
+{
+    param_init(params);
+    param_set_mask(params, SNDRV_PCM_HW_PARAM_FORMAT,
+                   SNDRV_PCM_FORMAT_S16_LE);
+    param_set_mask(params, SNDRV_PCM_HW_PARAM_SUBFORMAT,
+                   SNDRV_PCM_SUBFORMAT_STD);
+    param_set_int(params, SNDRV_PCM_HW_PARAM_SAMPLE_BITS, 16);
+    param_set_int(params, SNDRV_PCM_HW_PARAM_FRAME_BITS,
+                  (flags & PCM_MONO) ? 16 : 32);
+    param_set_int(params, SNDRV_PCM_HW_PARAM_CHANNELS,
+                  (flags & PCM_MONO) ? 1 : 2);
+}
+
+int pcm_rate_supported(unsigned flags)
+{
+    struct snd_pcm_hw_params params;
+    int fd;
+    int ret;
+
+        /* do not block if the device is in use */
+    fd = alsa_open(pcm_device(flags), O_RDWR | O_NONBLOCK);
+    if (fd < 0)
+        return 0;
+
+    pcm_params_init(&params, flags);
+    param_set_int(&params, SNDRV_PCM_HW_PARAM_RATE, pcm_rate(flags));
+    ret = alsa_ioctl(fd, SNDRV_PCM_IOCTL_HW_REFINE, &params) == 0;
+    alsa_close(fd);
+
+    LOGV("pcm_rate_supported(0x%08x) %d Hz: %s", flags, pcm_rate(flags),
+         ret ? "yes" : "no");
+    return ret;
+}
+
 static struct pcm bad_pcm = {
     .fd = -1,
 };
 
+static void pcm_mmap_close(struct pcm *pcm)
+{
+    long page_size = sysconf(_SC_PAGE_SIZE);
+
+    if (pcm->sync_ptr) {
+        free(pcm->sync_ptr);
+        pcm->sync_ptr = NULL;
+    } else {
+        if (pcm->mmap_status)
+            alsa_munmap(pcm->mmap_status, page_size);
+        if (pcm->mmap_control)
+            alsa_munmap(pcm->mmap_control, page_size);
+    }
+    pcm->mmap_status = NULL;
+    pcm->mmap_control = NULL;
+
+    if (pcm->mmap_buffer) {
+        alsa_munmap(pcm->mmap_buffer, pcm->buffer_size * pcm->frame_size);
+        pcm->mmap_buffer = NULL;
+    }
+}
+
+/* Map the DMA buffer, and the status and control pages if the platform
+ * allows it; fall back to SNDRV_PCM_IOCTL_SYNC_PTR otherwise.
+ */
+static int pcm_mmap_open(struct pcm *pcm)
+{
+    long page_size = sysconf(_SC_PAGE_SIZE);
+    void *p;
+
+    p = alsa_mmap(NULL, pcm->buffer_size * pcm->frame_size, PROT_READ | PROT_WRITE,
+             MAP_FILE | MAP_SHARED, pcm->fd, SNDRV_PCM_MMAP_OFFSET_DATA);
+    if (p == MAP_FAILED)
+        return oops(pcm, errno, "cannot map pcm buffer");
+    pcm->mmap_buffer = p;
+
+    p = alsa_mmap(NULL, page_size, PROT_READ, MAP_FILE | MAP_SHARED,
+             pcm->fd, SNDRV_PCM_MMAP_OFFSET_STATUS);
+    if (p != MAP_FAILED) {
+        pcm->mmap_status = p;
+        p = alsa_mmap(NULL, page_size, PROT_READ | PROT_WRITE, MAP_FILE | MAP_SHARED,
+                 pcm->fd, SNDRV_PCM_MMAP_OFFSET_CONTROL);
+        if (p != MAP_FAILED) {
+            pcm->mmap_control = p;
+            pcm->mmap_control->avail_min = 1;
+            return 0;
+        }
+        alsa_munmap(pcm->mmap_status, page_size);
+        pcm->mmap_status = NULL;
+    }
+
+    LOGV("pcm_open() status/control mmap not supported, using SYNC_PTR");
+    pcm->sync_ptr = calloc(1, sizeof(*pcm->sync_ptr));
+    if (!pcm->sync_ptr) {
+        pcm_mmap_close(pcm);
+        return oops(pcm, ENOMEM, "cannot allocate sync_ptr");
+    }
+    pcm->mmap_status = &pcm->sync_ptr->s.status;
+    pcm->mmap_control = &pcm->sync_ptr->c.control;
+    pcm->mmap_control->avail_min = 1;
+    if (pcm_sync_ptr(pcm, SNDRV_PCM_SYNC_PTR_APPL)) {
+        oops(pcm, errno, "cannot sync stream pointers");
+        pcm_mmap_close(pcm);
+        return -1;
+    }
+    return 0;
+}
+
 int pcm_close(struct pcm *pcm)
 {
     if (pcm == &bad_pcm)
         return 0;
 
+    pcm_mmap_close(pcm);
     if (pcm->fd >= 0)
-        close(pcm->fd);
+        alsa_close(pcm->fd);
     pcm->running = 0;
+    pcm->prepared = 0;
     pcm->buffer_size = 0;
     pcm->fd = -1;
     return 0;
@@ -314,8 +694,12 @@ struct pcm *pcm_open(unsigned flags)
     struct snd_pcm_info info;
     struct snd_pcm_hw_params params;
     struct snd_pcm_sw_params sparams;
+    struct snd_interval *rates;
     unsigned period_sz;
     unsigned period_cnt;
+    unsigned rate;
+    int exact;
+    int arg;
 
     LOGV("pcm_open(0x%08x)",flags);
 
@@ -323,11 +707,8 @@ struct pcm *pcm_open(unsigned flags)
     if (!pcm)
         return &bad_pcm;
 
-    if (flags & PCM_IN) {
-        dname = "/dev/snd/pcmC0D0c";
-    } else {
-        dname = "/dev/snd/pcmC0D0p";
-    }
+    dname = pcm_device(flags);
+    rate = pcm_rate(flags);
 
     LOGV("pcm_open() period sz multiplier %d",
          ((flags & PCM_PERIOD_SZ_MASK) >> PCM_PERIOD_SZ_SHIFT) + 1);
@@ -337,45 +718,74 @@ struct pcm *pcm_open(unsigned flags)
     period_cnt = ((flags & PCM_PERIOD_CNT_MASK) >> PCM_PERIOD_CNT_SHIFT) + PCM_PERIOD_CNT_MIN;
 
     pcm->flags = flags;
-    pcm->fd = open(dname, O_RDWR);
+    pcm->fd = alsa_open(dname, O_RDWR);
     if (pcm->fd < 0) {
         oops(pcm, errno, "cannot open device '%s'");
         return pcm;
     }
 
-    if (ioctl(pcm->fd, SNDRV_PCM_IOCTL_INFO, &info)) {
+    if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_INFO, &info)) {
         oops(pcm, errno, "cannot get info - %s");
         goto fail;
     }
     info_dump(&info);
 
-    LOGV("pcm_open() period_cnt %d period_sz %d channels %d",
-         period_cnt, period_sz, (flags & PCM_MONO) ? 1 : 2);
+        /* time stamp hardware pointer updates with CLOCK_MONOTONIC if the
+         * kernel can do it
+         */
+    arg = SNDRV_PCM_TSTAMP_TYPE_MONOTONIC;
+    pcm->tstamp_monotonic = alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_TTSTAMP, &arg) == 0;
 
-    param_init(&params);
-    param_set_mask(&params, SNDRV_PCM_HW_PARAM_ACCESS,
-                   SNDRV_PCM_ACCESS_RW_INTERLEAVED);
-    param_set_mask(&params, SNDRV_PCM_HW_PARAM_FORMAT,
-                   SNDRV_PCM_FORMAT_S16_LE);
-    param_set_mask(&params, SNDRV_PCM_HW_PARAM_SUBFORMAT,
-                   SNDRV_PCM_SUBFORMAT_STD);
-    param_set_min(&params, SNDRV_PCM_HW_PARAM_PERIOD_SIZE, period_sz);
-    param_set_int(&params, SNDRV_PCM_HW_PARAM_SAMPLE_BITS, 16);
-    param_set_int(&params, SNDRV_PCM_HW_PARAM_FRAME_BITS,
-                  (flags & PCM_MONO) ? 16 : 32);
-    param_set_int(&params, SNDRV_PCM_HW_PARAM_CHANNELS,
-                  (flags & PCM_MONO) ? 1 : 2);
-    param_set_int(&params, SNDRV_PCM_HW_PARAM_PERIODS, period_cnt);
-    param_set_int(&params, SNDRV_PCM_HW_PARAM_RATE, 44100);
+    LOGV("pcm_open() period_cnt %d period_sz %d channels %d rate %d",
+         period_cnt, period_sz, (flags & PCM_MONO) ? 1 : 2, rate);
 
-    if (ioctl(pcm->fd, SNDRV_PCM_IOCTL_HW_PARAMS, &params)) {
-        oops(pcm, errno, "cannot set hw params");
+        /* check the requested rate against what the hardware offers */
+    pcm_params_init(&params, flags);
+    if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_HW_REFINE, &params)) {
+        oops(pcm, errno, "cannot refine hw params");
+        goto fail;
+    }
+    rates = param_to_interval(&params, SNDRV_PCM_HW_PARAM_RATE);
+    if (rate < rates->min || rate > rates->max) {
+        oops(pcm, EINVAL, "rate %d outside of hardware range %d-%d",
+             rate, rates->min, rates->max);
         goto fail;
     }
+
+        /* ask for the exact period size first, then let the driver round
+         * it up if it cannot do that one.
+         */
+    for (exact = 1; ; exact = 0) {
+        pcm_params_init(&params, flags);
+        param_set_mask(&params, SNDRV_PCM_HW_PARAM_ACCESS,
+                       (flags & PCM_MMAP) ? SNDRV_PCM_ACCESS_MMAP_INTERLEAVED :
+                                            SNDRV_PCM_ACCESS_RW_INTERLEAVED);
+        if (exact)
+            param_set_int(&params, SNDRV_PCM_HW_PARAM_PERIOD_SIZE, period_sz);
+        else
+            param_set_min(&params, SNDRV_PCM_HW_PARAM_PERIOD_SIZE, period_sz);
+        param_set_int(&params, SNDRV_PCM_HW_PARAM_PERIODS, period_cnt);
+        param_set_int(&params, SNDRV_PCM_HW_PARAM_RATE, rate);
+
+        if (!alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_HW_PARAMS, &params))
+            break;
+        if (!exact) {
+            oops(pcm, errno, "cannot set hw params");
+            goto fail;
+        }
+        LOGV("pcm_open() period size %d not supported, rounding up", period_sz);
+    }
     param_dump(&params);
 
+        /* report the geometry the driver actually chose */
+    if (param_get_int(&params, SNDRV_PCM_HW_PARAM_PERIOD_SIZE))
+        period_sz = param_get_int(&params, SNDRV_PCM_HW_PARAM_PERIOD_SIZE);
+    if (param_get_int(&params, SNDRV_PCM_HW_PARAM_PERIODS))
+        period_cnt = param_get_int(&params, SNDRV_PCM_HW_PARAM_PERIODS);
+    LOGV("pcm_open() using period_cnt %d period_sz %d", period_cnt, period_sz);
+
     memset(&sparams, 0, sizeof(sparams));
-    sparams.tstamp_mode = SNDRV_PCM_TSTAMP_NONE;
+    sparams.tstamp_mode = SNDRV_PCM_TSTAMP_ENABLE;
     sparams.period_step = 1;
     sparams.avail_min = 1;
     sparams.start_threshold = period_cnt * period_sz;
@@ -384,17 +794,28 @@ struct pcm *pcm_open(unsigned flags)
     sparams.silence_size = 0;
     sparams.silence_threshold = 0;
 
-    if (ioctl(pcm->fd, SNDRV_PCM_IOCTL_SW_PARAMS, &sparams)) {
+    if (alsa_ioctl(pcm->fd, SNDRV_PCM_IOCTL_SW_PARAMS, &sparams)) {
         oops(pcm, errno, "cannot set sw params");
         goto fail;
     }
 
     pcm->buffer_size = period_cnt * period_sz;
+    pcm->period_size = period_sz;
+    pcm->frame_size = (flags & PCM_MONO) ? 2 : 4;
     pcm->underruns = 0;
+
+    if (flags & PCM_MMAP) {
+            /* same wrap point as the kernel uses for the stream pointers */
+        pcm->boundary = pcm->buffer_size;
+        while (pcm->boundary * 2 <= 0x7fffffffUL - pcm->buffer_size)
+            pcm->boundary *= 2;
+        if (pcm_mmap_open(pcm))
+            goto fail;
+    }
     return pcm;
 
 fail:
-    close(pcm->fd);
+    alsa_close(pcm->fd);
     pcm->fd = -1;
     return pcm;
 }
@@ -0,0 +1,969 @@
+/*
+** Copyright 2010, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+/* Simulated sound card for running the audio HAL without sound hardware,
+ * on a host or on a device with a broken codec driver.
+ *
+ * The playback and capture pcms are clocked by CLOCK_MONOTONIC at the
+ * configured rate: writes and reads block like they would on the real
+ * driver, the hardware pointer runs while the stream is started and
+ * underruns/overruns happen when the application does not keep up.
+ * Played frames are discarded, captured frames are a 1kHz tone.
+ *
+ * The control set is read from the file named by the ALSA_SIM_SCRIPT
+ * environment variable, or the built in script below. One line per
+ * statement, '#' starts a comment:
+ *
+ *   rates out|in <rate>...      rates the pcm accepts (default: all)
+ *   period_min <frames>         smallest period size, larger ones are
+ *                               rounded up to a multiple of it
+ *   bool <count> <name>
+ *   int <count> <min> <max> <name>
+ *   enum <count> <name>|<item>|<item>...
+ *
+ * Controls start at their minimum value or first item. Changing a value
+ * notifies subscribers like the kernel does, merging the events pending
+ * for a control.
+ */
+
+#define LOG_TAG "alsa_sim"
+//#define LOG_NDEBUG 0
+#include <cutils/log.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <sys/mman.h>
+#include <linux/ioctl.h>
+
+#include "alsa_audio.h"
+#include "alsa_backend.h"
+
+#define __force
+#define __bitwise
+#define __user
+#include "asound.h"
+
+#define SIM_SCRIPT_ENV "ALSA_SIM_SCRIPT"
+#define SIM_MAX_FILES 16
+#define SIM_MAX_EVENTS 256
+#define SIM_LINE_MAX 512
+/* capture tone, and its amplitude (-6dBFS) */
+#define SIM_TONE_HZ 1000
+#define SIM_TONE_LEVEL 16384
+
+static const char sim_default_script[] =
+    "# jet codec controls used by the HAL\n"
+    "period_min 128\n"
+    "int 2 0 231 Master Playback Volume\n"
+    "int 1 0 63 SDACA Attenuation\n"
+    "int 1 0 31 Line Input Gain\n"
+    "int 1 0 31 Microphone PGA\n"
+    "int 1 0 3 Microphone Pre-Amp\n"
+    "bool 1 Earpiece Switch\n"
+    "bool 1 Speaker Switch\n"
+    "bool 1 Headphones Switch\n"
+    "bool 1 Main Mic Switch\n"
+    "bool 1 Sub Mic Switch\n"
+    "bool 1 Ear Mic Switch\n"
+    "bool 1 Jack Mic Switch\n"
+    "bool 1 GSM Send Switch\n"
+    "bool 1 GSM Receive Switch\n"
+    "bool 1 FM Receive Switch\n"
+    "bool 1 Line Input 1 Differential\n"
+    "bool 1 Line Input 2 Differential\n"
+    "bool 1 Line Input 3 Differential\n"
+    "bool 1 Line Input 4 Differential\n"
+    "bool 1 Line Output 1 Differential\n"
+    "bool 1 Line Output 3 Differential\n"
+    "bool 1 LIN Mixer LIN3\n"
+    "bool 1 LIN Mixer LVOICEINP\n"
+    "bool 1 RIN Mixer RIN4\n"
+    "bool 1 RIN Mixer RVOICEINN\n"
+    "bool 1 LOUT Mixer DACL\n"
+    "bool 1 LOUT Mixer Left LIN\n"
+    "bool 1 ROUT Mixer DACR\n"
+    "bool 1 ROUT Mixer Right LIN\n"
+    "bool 1 LOUT3 Mixer LINS2\n"
+    "bool 1 LOUT3 Mixer LINS3\n"
+    "bool 1 ROUT3 Mixer RINS2\n"
+    "bool 1 ROUT3 Mixer RINS3\n"
+    "bool 1 LOUTP\n"
+    "enum 1 Input Mixer|None|Main Mic|Sub Mic|Ear Mic|Jack Mic\n"
+    "enum 1 Codec Status|FMR_OFF|FMR_ON|FMR_FLAG_CLEAR\n";
+
+static const unsigned sim_all_rates[] = {
+    8000, 11025, 16000, 22050, 44100, 48000
+};
+#define SIM_NUM_RATES (sizeof(sim_all_rates) / sizeof(sim_all_rates[0]))
+
+enum {
+    SIM_PCM_OUT,
+    SIM_PCM_IN,
+    SIM_CONTROL,
+};
+
+struct sim_ctl {
+    struct snd_ctl_elem_info info;
+    char **items;
+    long value[2];
+};
+
+struct sim_file {
+    int fd;
+    int type;
+
+    /* pcm, serializes ioctls like the driver does */
+    pthread_mutex_t lock;
+    int state;
+    unsigned rate;
+    unsigned channels;
+    unsigned period_size;
+    unsigned buffer_size;
+    unsigned start_threshold;
+    unsigned long hw_ptr;
+    unsigned long appl_ptr;
+    unsigned long start_hw_ptr;
+    long long start_time;
+    /* tone oscillator */
+    int tone_sin;
+    int tone_cos;
+
+    /* control */
+    int subscribed;
+    unsigned events[SIM_MAX_EVENTS];
+    unsigned event_head;
+    unsigned event_count;
+};
+
+static struct {
+    pthread_mutex_t lock;
+    int loaded;
+    /* bit n set if sim_all_rates[n] is accepted */
+    unsigned rates[2];
+    unsigned period_min;
+    struct sim_ctl *ctls;
+    unsigned count;
+    struct sim_file *files[SIM_MAX_FILES];
+} card = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static long long sim_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* script parsing */
+
+static int sim_add_ctl(int type, unsigned count, long min, long max,
+                       char *name)
+{
+    struct sim_ctl *ctls;
+    struct sim_ctl *ctl;
+    char *items = NULL;
+    unsigned n;
+
+    if (count < 1 || count > 2)
+        return -1;
+    if (type == SNDRV_CTL_ELEM_TYPE_ENUMERATED) {
+        items = strchr(name, '|');
+        if (!items)
+            return -1;
+        *items++ = 0;
+    }
+
+    ctls = realloc(card.ctls, (card.count + 1) * sizeof(*ctls));
+    if (!ctls)
+        return -1;
+    card.ctls = ctls;
+    ctl = ctls + card.count;
+    memset(ctl, 0, sizeof(*ctl));
+
+    ctl->info.id.numid = card.count + 1;
+    ctl->info.id.iface = SNDRV_CTL_ELEM_IFACE_MIXER;
+    strncpy((char *)ctl->info.id.name, name, sizeof(ctl->info.id.name) - 1);
+    ctl->info.type = type;
+    ctl->info.access = SNDRV_CTL_ELEM_ACCESS_READWRITE;
+    ctl->info.count = count;
+
+    switch (type) {
+    case SNDRV_CTL_ELEM_TYPE_BOOLEAN:
+        ctl->info.value.integer.min = 0;
+        ctl->info.value.integer.max = 1;
+        break;
+    case SNDRV_CTL_ELEM_TYPE_INTEGER:
+        ctl->info.value.integer.min = min;
+        ctl->info.value.integer.max = max;
+        for (n = 0; n < count; n++)
+            ctl->value[n] = min;
+        break;
+    case SNDRV_CTL_ELEM_TYPE_ENUMERATED:
+        for (n = 1; (items = strtok(n == 1 ? items : NULL, "|")); n++) {
+            char **list = realloc(ctl->items, n * sizeof(char *));
+            if (!list)
+                return -1;
+            ctl->items = list;
+            ctl->items[n - 1] = strdup(items);
+            ctl->info.value.enumerated.items = n;
+        }
+        if (!ctl->info.value.enumerated.items)
+            return -1;
+        break;
+    }
+    card.count++;
+    return 0;
+}
+
+static int sim_parse_line(char *line)
+{
+    char *cmd, *arg, *end;
+    unsigned count;
+    long min, max;
+    unsigned dir;
+
+    line[strcspn(line, "#\r\n")] = 0;
+    cmd = strtok(line, " \t");
+    if (!cmd)
+        return 0;
+
+    if (!strcmp(cmd, "rates")) {
+        arg = strtok(NULL, " \t");
+        if (!arg || (strcmp(arg, "out") && strcmp(arg, "in")))
+            return -1;
+        dir = !strcmp(arg, "in");
+        card.rates[dir] = 0;
+        while ((arg = strtok(NULL, " \t"))) {
+            unsigned rate = strtoul(arg, NULL, 10);
+            unsigned n;
+            for (n = 0; n < SIM_NUM_RATES; n++)
+                if (sim_all_rates[n] == rate)
+                    break;
+            if (n == SIM_NUM_RATES)
+                return -1;
+            card.rates[dir] |= 1 << n;
+        }
+        return 0;
+    }
+    if (!strcmp(cmd, "period_min")) {
+        arg = strtok(NULL, " \t");
+        card.period_min = arg ? strtoul(arg, NULL, 10) : 0;
+        return card.period_min ? 0 : -1;
+    }
+
+    arg = strtok(NULL, " \t");
+    if (!arg)
+        return -1;
+    count = strtoul(arg, NULL, 10);
+    min = max = 0;
+    if (!strcmp(cmd, "int")) {
+        arg = strtok(NULL, " \t");
+        if (!arg)
+            return -1;
+        min = strtol(arg, NULL, 10);
+        arg = strtok(NULL, " \t");
+        if (!arg)
+            return -1;
+        max = strtol(arg, NULL, 10);
+    }
+        /* the name is the rest of the line */
+    arg = strtok(NULL, "");
+    if (!arg)
+        return -1;
+    arg += strspn(arg, " \t");
+    end = arg + strlen(arg);
+    while (end > arg && (end[-1] == ' ' || end[-1] == '\t'))
+        *--end = 0;
+
+    if (!strcmp(cmd, "bool"))
+        return sim_add_ctl(SNDRV_CTL_ELEM_TYPE_BOOLEAN, count, 0, 1, arg);
+    if (!strcmp(cmd, "int"))
+        return sim_add_ctl(SNDRV_CTL_ELEM_TYPE_INTEGER, count, min, max, arg);
+    if (!strcmp(cmd, "enum"))
+        return sim_add_ctl(SNDRV_CTL_ELEM_TYPE_ENUMERATED, count, 0, 0, arg);
+    return -1;
+}
+
+/* Called with card.lock held. */
+static void sim_load(void)
+{
+    const char *path = getenv(SIM_SCRIPT_ENV);
+    const char *p = sim_default_script;
+    char line[SIM_LINE_MAX];
+    FILE *f = NULL;
+    int lineno = 0;
+
+    if (card.loaded)
+        return;
+    card.loaded = 1;
+    card.rates[0] = card.rates[1] = (1 << SIM_NUM_RATES) - 1;
+    card.period_min = 1;
+
+    if (path && path[0]) {
+        f = fopen(path, "r");
+        if (!f)
+            LOGE("cannot open %s, using the default controls", path);
+    }
+
+    for (;;) {
+        if (f) {
+            if (!fgets(line, sizeof(line), f))
+                break;
+        } else {
+            size_t len = strcspn(p, "\n");
+            if (!*p)
+                break;
+            if (len >= sizeof(line))
+                len = sizeof(line) - 1;
+            memcpy(line, p, len);
+            line[len] = 0;
+            p += len + (p[len] == '\n');
+        }
+        lineno++;
+        if (sim_parse_line(line))
+            LOGW("%s:%d: bad line ignored", f ? path : "default", lineno);
+    }
+    if (f)
+        fclose(f);
+
+    LOGI("simulated card: %u controls, rates out 0x%02x in 0x%02x",
+         card.count, card.rates[0], card.rates[1]);
+}
+
+/* file table */
+
+static struct sim_file *sim_file(int fd)
+{
+    struct sim_file *file = NULL;
+    unsigned n;
+
+    pthread_mutex_lock(&card.lock);
+    for (n = 0; n < SIM_MAX_FILES; n++) {
+        if (card.files[n] && card.files[n]->fd == fd) {
+            file = card.files[n];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&card.lock);
+    if (!file)
+        errno = EBADF;
+    return file;
+}
+
+static int sim_open(const char *path, int flags)
+{
+    struct sim_file *file;
+    unsigned n, slot = SIM_MAX_FILES;
+    int type;
+
+    if (!strcmp(path, "/dev/snd/pcmC0D0p"))
+        type = SIM_PCM_OUT;
+    else if (!strcmp(path, "/dev/snd/pcmC0D0c"))
+        type = SIM_PCM_IN;
+    else if (!strcmp(path, "/dev/snd/controlC0"))
+        type = SIM_CONTROL;
+    else {
+        errno = ENOENT;
+        return -1;
+    }
+
+    file = calloc(1, sizeof(*file));
+    if (!file)
+        return -1;
+    file->type = type;
+    pthread_mutex_init(&file->lock, NULL);
+    file->state = SNDRV_PCM_STATE_OPEN;
+        /* a real descriptor keeps fcntl() and the numbering sane */
+    file->fd = open("/dev/null", O_RDWR);
+    if (file->fd < 0) {
+        free(file);
+        return -1;
+    }
+
+    pthread_mutex_lock(&card.lock);
+    sim_load();
+    for (n = 0; n < SIM_MAX_FILES; n++) {
+        if (!card.files[n]) {
+            if (slot == SIM_MAX_FILES)
+                slot = n;
+        } else if (type != SIM_CONTROL && card.files[n]->type == type) {
+                /* one substream per direction */
+            slot = SIM_MAX_FILES;
+            errno = EBUSY;
+            break;
+        }
+    }
+    if (slot < SIM_MAX_FILES)
+        card.files[slot] = file;
+    else if (n == SIM_MAX_FILES)
+        errno = EMFILE;
+    pthread_mutex_unlock(&card.lock);
+
+    if (slot == SIM_MAX_FILES) {
+        close(file->fd);
+        pthread_mutex_destroy(&file->lock);
+        free(file);
+        return -1;
+    }
+    return file->fd;
+}
+
+static int sim_close(int fd)
+{
+    struct sim_file *file = NULL;
+    unsigned n;
+
+    pthread_mutex_lock(&card.lock);
+    for (n = 0; n < SIM_MAX_FILES; n++) {
+        if (card.files[n] && card.files[n]->fd == fd) {
+            file = card.files[n];
+            card.files[n] = NULL;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&card.lock);
+
+    if (!file) {
+        errno = EBADF;
+        return -1;
+    }
+    pthread_mutex_destroy(&file->lock);
+    free(file);
+    return close(fd);
+}
+
+/* pcm */
+
+static int sim_rate_index(unsigned rate)
+{
+    unsigned n;
+
+    for (n = 0; n < SIM_NUM_RATES; n++)
+        if (sim_all_rates[n] == rate)
+            return n;
+    return -1;
+}
+
+static struct snd_interval *sim_interval(struct snd_pcm_hw_params *p, int n)
+{
+    return &p->intervals[n - SNDRV_PCM_HW_PARAM_FIRST_INTERVAL];
+}
+
+static void sim_set_interval(struct snd_pcm_hw_params *p, int n, unsigned val)
+{
+    struct snd_interval *i = sim_interval(p, n);
+
+    i->min = val;
+    i->max = val;
+    i->integer = 1;
+}
+
+static int sim_hw_refine(struct sim_file *file, struct snd_pcm_hw_params *p)
+{
+    unsigned rates = card.rates[file->type == SIM_PCM_IN];
+    struct snd_interval *i = sim_interval(p, SNDRV_PCM_HW_PARAM_RATE);
+    unsigned n, min = 0, max = 0;
+    int idx;
+
+    if (i->min == i->max) {
+        idx = sim_rate_index(i->min);
+        if (idx < 0 || !(rates & (1 << idx))) {
+            errno = EINVAL;
+            return -1;
+        }
+        return 0;
+    }
+    for (n = 0; n < SIM_NUM_RATES; n++) {
+        if (rates & (1 << n)) {
+            if (!min || sim_all_rates[n] < min)
+                min = sim_all_rates[n];
+            if (sim_all_rates[n] > max)
+                max = sim_all_rates[n];
+        }
+    }
+    i->min = min;
+    i->max = max;
+    return 0;
+}
+
+static int sim_hw_params(struct sim_file *file, struct snd_pcm_hw_params *p)
+{
+    struct snd_interval *period = sim_interval(p, SNDRV_PCM_HW_PARAM_PERIOD_SIZE);
+    unsigned periods = sim_interval(p, SNDRV_PCM_HW_PARAM_PERIODS)->min;
+    unsigned channels = sim_interval(p, SNDRV_PCM_HW_PARAM_CHANNELS)->min;
+    unsigned rate = sim_interval(p, SNDRV_PCM_HW_PARAM_RATE)->min;
+    unsigned period_size = period->min;
+
+    if (file->state == SNDRV_PCM_STATE_RUNNING ||
+        sim_hw_refine(file, p) || (channels != 1 && channels != 2) ||
+        periods < 2 || !period_size) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (period_size % card.period_min) {
+            /* round up, unless the exact size was required */
+        period_size += card.period_min - period_size % card.period_min;
+        if (period_size > period->max) {
+            errno = EINVAL;
+            return -1;
+        }
+    }
+
+    file->rate = rate;
+    file->channels = channels;
+    file->period_size = period_size;
+    file->buffer_size = period_size * periods;
+    file->start_threshold = file->buffer_size;
+    file->state = SNDRV_PCM_STATE_SETUP;
+
+    sim_set_interval(p, SNDRV_PCM_HW_PARAM_RATE, rate);
+    sim_set_interval(p, SNDRV_PCM_HW_PARAM_CHANNELS, channels);
+    sim_set_interval(p, SNDRV_PCM_HW_PARAM_PERIOD_SIZE, period_size);
+    sim_set_interval(p, SNDRV_PCM_HW_PARAM_PERIODS, periods);
+    sim_set_interval(p, SNDRV_PCM_HW_PARAM_BUFFER_SIZE, file->buffer_size);
+    LOGV("%s: %u Hz, %u channels, %u x %u frames",
+         file->type == SIM_PCM_IN ? "capture" : "playback",
+         rate, channels, periods, period_size);
+    return 0;
+}
+
+static void sim_pcm_start(struct sim_file *file)
+{
+    file->state = SNDRV_PCM_STATE_RUNNING;
+    file->start_time = sim_now();
+    file->start_hw_ptr = file->hw_ptr;
+}
+
+/* Moves the hardware pointer to where the clock says it is. */
+static void sim_pcm_update(struct sim_file *file)
+{
+    unsigned long hw;
+
+    if (file->state != SNDRV_PCM_STATE_RUNNING)
+        return;
+
+    hw = file->start_hw_ptr +
+        (sim_now() - file->start_time) * file->rate / 1000000000LL;
+    if (file->type == SIM_PCM_OUT) {
+        if (hw >= file->appl_ptr) {
+            hw = file->appl_ptr;
+            file->state = SNDRV_PCM_STATE_XRUN;
+        }
+    } else if (hw - file->appl_ptr > file->buffer_size) {
+        hw = file->appl_ptr + file->buffer_size;
+        file->state = SNDRV_PCM_STATE_XRUN;
+    }
+    file->hw_ptr = hw;
+}
+
+static unsigned sim_pcm_avail(struct sim_file *file)
+{
+    if (file->type == SIM_PCM_OUT)
+        return file->buffer_size - (file->appl_ptr - file->hw_ptr);
+    return file->hw_ptr - file->appl_ptr;
+}
+
+/* Sleeps until the hardware pointer has moved by frames, letting other
+ * threads query the stream meanwhile.
+ */
+static void sim_pcm_wait(struct sim_file *file, unsigned frames)
+{
+    long long ns = frames * 1000000000LL / file->rate + 1;
+    struct timespec ts;
+
+    ts.tv_sec = ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+    pthread_mutex_unlock(&file->lock);
+    nanosleep(&ts, NULL);
+    pthread_mutex_lock(&file->lock);
+}
+
+static void sim_pcm_tone(struct sim_file *file, int16_t *buf, unsigned frames)
+{
+        /* magic circle oscillator, the amplitude stays bounded */
+    int k = 2 * 3.14159265 * SIM_TONE_HZ / file->rate * 32768;
+    unsigned n, c;
+
+    if (!file->tone_sin && !file->tone_cos)
+        file->tone_cos = SIM_TONE_LEVEL;
+    for (n = 0; n < frames; n++) {
+        file->tone_sin += (file->tone_cos * k) >> 15;
+        file->tone_cos -= (file->tone_sin * k) >> 15;
+        for (c = 0; c < file->channels; c++)
+            *buf++ = file->tone_sin;
+    }
+}
+
+static int sim_pcm_transfer(struct sim_file *file, struct snd_xferi *x)
+{
+    unsigned long left = x->frames;
+    char *buf = x->buf;
+
+    x->result = 0;
+    if (file->state == SNDRV_PCM_STATE_XRUN) {
+        errno = EPIPE;
+        return -1;
+    }
+    if (file->state != SNDRV_PCM_STATE_PREPARED &&
+        file->state != SNDRV_PCM_STATE_RUNNING) {
+        errno = EBADFD;
+        return -1;
+    }
+
+    while (left) {
+        unsigned avail;
+
+        sim_pcm_update(file);
+        if (file->state == SNDRV_PCM_STATE_XRUN) {
+            errno = EPIPE;
+            return -1;
+        }
+        avail = sim_pcm_avail(file);
+        if (avail > left)
+            avail = left;
+        if (!avail) {
+            if (file->state != SNDRV_PCM_STATE_RUNNING)
+                sim_pcm_start(file);
+            sim_pcm_wait(file, left < file->period_size ?
+                               left : file->period_size);
+            continue;
+        }
+        if (file->type == SIM_PCM_IN)
+            sim_pcm_tone(file, (int16_t *)buf, avail);
+        buf += avail * file->channels * sizeof(int16_t);
+        file->appl_ptr += avail;
+        left -= avail;
+        x->result += avail;
+
+        if (file->state == SNDRV_PCM_STATE_PREPARED &&
+            file->appl_ptr - file->hw_ptr >= file->start_threshold)
+            sim_pcm_start(file);
+    }
+    return 0;
+}
+
+static int sim_pcm_ioctl(struct sim_file *file, unsigned request, void *arg)
+{
+    switch (request) {
+    case SNDRV_PCM_IOCTL_INFO: {
+        struct snd_pcm_info *info = arg;
+        memset(info, 0, sizeof(*info));
+        info->stream = file->type == SIM_PCM_IN ?
+                SNDRV_PCM_STREAM_CAPTURE : SNDRV_PCM_STREAM_PLAYBACK;
+        strcpy((char *)info->id, "sim");
+        strcpy((char *)info->name, "Simulated PCM");
+        info->subdevices_count = 1;
+        return 0;
+    }
+    case SNDRV_PCM_IOCTL_TTSTAMP:
+        return 0;
+    case SNDRV_PCM_IOCTL_HW_REFINE:
+        return sim_hw_refine(file, arg);
+    case SNDRV_PCM_IOCTL_HW_PARAMS:
+        return sim_hw_params(file, arg);
+    case SNDRV_PCM_IOCTL_SW_PARAMS: {
+        struct snd_pcm_sw_params *sparams = arg;
+        if (file->state == SNDRV_PCM_STATE_OPEN)
+            break;
+        if (sparams->start_threshold &&
+            sparams->start_threshold < file->buffer_size)
+            file->start_threshold = sparams->start_threshold;
+        return 0;
+    }
+    case SNDRV_PCM_IOCTL_PREPARE:
+        if (file->state == SNDRV_PCM_STATE_OPEN)
+            break;
+        file->state = SNDRV_PCM_STATE_PREPARED;
+        file->hw_ptr = 0;
+        file->appl_ptr = 0;
+        return 0;
+    case SNDRV_PCM_IOCTL_START:
+        if (file->state != SNDRV_PCM_STATE_PREPARED)
+            break;
+        sim_pcm_start(file);
+        return 0;
+    case SNDRV_PCM_IOCTL_DROP:
+        if (file->state == SNDRV_PCM_STATE_OPEN)
+            break;
+        file->state = SNDRV_PCM_STATE_SETUP;
+        return 0;
+    case SNDRV_PCM_IOCTL_HWSYNC:
+    case SNDRV_PCM_IOCTL_DELAY:
+        sim_pcm_update(file);
+        if (file->state == SNDRV_PCM_STATE_XRUN) {
+            errno = EPIPE;
+            return -1;
+        }
+        if (request == SNDRV_PCM_IOCTL_DELAY)
+            *(snd_pcm_sframes_t *)arg = file->type == SIM_PCM_IN ?
+                    file->hw_ptr - file->appl_ptr :
+                    file->appl_ptr - file->hw_ptr;
+        return 0;
+    case SNDRV_PCM_IOCTL_STATUS: {
+        struct snd_pcm_status *status = arg;
+        long long now;
+        sim_pcm_update(file);
+        now = sim_now();
+        memset(status, 0, sizeof(*status));
+        status->state = file->state;
+        status->hw_ptr = file->hw_ptr;
+        status->appl_ptr = file->appl_ptr;
+        status->avail = status->avail_max = sim_pcm_avail(file);
+        status->tstamp.tv_sec = now / 1000000000LL;
+        status->tstamp.tv_nsec = now % 1000000000LL;
+        return 0;
+    }
+    case SNDRV_PCM_IOCTL_WRITEI_FRAMES:
+        if (file->type != SIM_PCM_OUT)
+            break;
+        return sim_pcm_transfer(file, arg);
+    case SNDRV_PCM_IOCTL_READI_FRAMES:
+        if (file->type != SIM_PCM_IN)
+            break;
+        return sim_pcm_transfer(file, arg);
+    default:
+            /* no mmap support: the stream pointers are not shared */
+        errno = ENOTTY;
+        return -1;
+    }
+    errno = EBADFD;
+    return -1;
+}
+
+/* control */
+
+static struct sim_ctl *sim_find_ctl(struct snd_ctl_elem_id *id)
+{
+    if (id->numid < 1 || id->numid > card.count) {
+        errno = ENOENT;
+        return NULL;
+    }
+    return card.ctls + id->numid - 1;
+}
+
+/* Queues a change event of numid on the subscribed control files. Like the
+ * kernel, an event still pending for the same control is not repeated.
+ * Called with card.lock held.
+ */
+static void sim_notify(unsigned numid)
+{
+    unsigned n, m;
+
+    for (n = 0; n < SIM_MAX_FILES; n++) {
+        struct sim_file *file = card.files[n];
+
+        if (!file || file->type != SIM_CONTROL || !file->subscribed)
+            continue;
+        for (m = 0; m < file->event_count; m++)
+            if (file->events[(file->event_head + m) % SIM_MAX_EVENTS] == numid)
+                break;
+        if (m < file->event_count)
+            continue;
+        if (file->event_count == SIM_MAX_EVENTS) {
+            LOGW("control event queue full, event dropped");
+            file->event_head = (file->event_head + 1) % SIM_MAX_EVENTS;
+            file->event_count--;
+        }
+        file->events[(file->event_head + file->event_count++) %
+                     SIM_MAX_EVENTS] = numid;
+    }
+}
+
+static int sim_ctl_write(struct sim_ctl *ctl, struct snd_ctl_elem_value *ev)
+{
+    int changed = 0;
+    unsigned n;
+
+    for (n = 0; n < ctl->info.count; n++) {
+        long v;
+
+        if (ctl->info.type == SNDRV_CTL_ELEM_TYPE_ENUMERATED) {
+            v = ev->value.enumerated.item[n];
+            if ((unsigned long)v >= ctl->info.value.enumerated.items)
+                goto inval;
+        } else {
+            v = ev->value.integer.value[n];
+            if (v < ctl->info.value.integer.min ||
+                v > ctl->info.value.integer.max)
+                goto inval;
+        }
+        if (ctl->value[n] != v) {
+            ctl->value[n] = v;
+            changed = 1;
+        }
+    }
+    if (changed)
+        sim_notify(ctl->info.id.numid);
+    return 0;
+
+inval:
+    errno = EINVAL;
+    return -1;
+}
+
+static int sim_control_ioctl(struct sim_file *file, unsigned request, void *arg)
+{
+    struct sim_ctl *ctl;
+    unsigned n;
+
+    switch (request) {
+    case SNDRV_CTL_IOCTL_ELEM_LIST: {
+        struct snd_ctl_elem_list *list = arg;
+        list->count = card.count;
+        list->used = 0;
+        for (n = list->offset; n < card.count && list->used < list->space; n++)
+            list->pids[list->used++] = card.ctls[n].info.id;
+        return 0;
+    }
+    case SNDRV_CTL_IOCTL_ELEM_INFO: {
+        struct snd_ctl_elem_info *info = arg;
+        unsigned item = info->value.enumerated.item;
+        ctl = sim_find_ctl(&info->id);
+        if (!ctl)
+            return -1;
+        *info = ctl->info;
+        if (ctl->info.type == SNDRV_CTL_ELEM_TYPE_ENUMERATED) {
+            if (item >= ctl->info.value.enumerated.items)
+                item = ctl->info.value.enumerated.items - 1;
+            info->value.enumerated.item = item;
+            strncpy(info->value.enumerated.name, ctl->items[item],
+                    sizeof(info->value.enumerated.name) - 1);
+        }
+        return 0;
+    }
+    case SNDRV_CTL_IOCTL_ELEM_READ: {
+        struct snd_ctl_elem_value *ev = arg;
+        ctl = sim_find_ctl(&ev->id);
+        if (!ctl)
+            return -1;
+        for (n = 0; n < ctl->info.count; n++) {
+            if (ctl->info.type == SNDRV_CTL_ELEM_TYPE_ENUMERATED)
+                ev->value.enumerated.item[n] = ctl->value[n];
+            else
+                ev->value.integer.value[n] = ctl->value[n];
+        }
+        return 0;
+    }
+    case SNDRV_CTL_IOCTL_ELEM_WRITE:
+        ctl = sim_find_ctl(&((struct snd_ctl_elem_value *)arg)->id);
+        if (!ctl)
+            return -1;
+        return sim_ctl_write(ctl, arg);
+    case SNDRV_CTL_IOCTL_SUBSCRIBE_EVENTS:
+        file->subscribed = *(int *)arg != 0;
+        return 0;
+    }
+    errno = ENOTTY;
+    return -1;
+}
+
+static int sim_ioctl(int fd, unsigned request, void *arg)
+{
+    struct sim_file *file = sim_file(fd);
+    int ret;
+
+    if (!file)
+        return -1;
+    if (file->type != SIM_CONTROL) {
+        pthread_mutex_lock(&file->lock);
+        ret = sim_pcm_ioctl(file, request, arg);
+        pthread_mutex_unlock(&file->lock);
+        return ret;
+    }
+
+        /* the control set is shared by all control files */
+    pthread_mutex_lock(&card.lock);
+    ret = sim_control_ioctl(file, request, arg);
+    pthread_mutex_unlock(&card.lock);
+    return ret;
+}
+
+/* Returns the pending change notifications of a control file, without
+ * blocking.
+ */
+static ssize_t sim_read(int fd, void *buf, size_t count)
+{
+    struct sim_file *file = sim_file(fd);
+    struct snd_ctl_event ev;
+    ssize_t ret = -1;
+
+    if (!file)
+        return -1;
+    if (file->type != SIM_CONTROL || count < sizeof(ev)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    pthread_mutex_lock(&card.lock);
+    if (!file->subscribed || !file->event_count) {
+        errno = EAGAIN;
+    } else {
+        memset(&ev, 0, sizeof(ev));
+        ev.type = SNDRV_CTL_EVENT_ELEM;
+        ev.data.elem.mask = SNDRV_CTL_EVENT_MASK_VALUE;
+        ev.data.elem.id = card.ctls[file->events[file->event_head] - 1].info.id;
+        file->event_head = (file->event_head + 1) % SIM_MAX_EVENTS;
+        file->event_count--;
+        memcpy(buf, &ev, sizeof(ev));
+        ret = sizeof(ev);
+    }
+    pthread_mutex_unlock(&card.lock);
+    return ret;
+}
+
+static void *sim_mmap(void *addr, size_t length, int prot, int flags,
+                      int fd, off_t offset)
+{
+        /* pcm_open() falls back to read/write transfers */
+    errno = ENODEV;
+    return MAP_FAILED;
+}
+
+static int sim_munmap(void *addr, size_t length)
+{
+    errno = EINVAL;
+    return -1;
+}
+
+static int sim_poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+    nfds_t n;
+
+    for (n = 0; n < nfds; n++)
+        fds[n].revents = fds[n].events & (POLLIN | POLLOUT);
+    return nfds;
+}
+
+const struct alsa_backend alsa_sim_backend = {
+    .name = "sim",
+    .open = sim_open,
+    .close = sim_close,
+    .ioctl = sim_ioctl,
+    .read = sim_read,
+    .mmap = sim_mmap,
+    .munmap = sim_munmap,
+    .poll = sim_poll,
+};
@@ -0,0 +1,63 @@
+LOCAL_PATH:= $(call my-dir)
+
+# Host tests and benchmarks of the DSP code of libaudio. audio_dsp_test
+# exits with 0 if all tests pass. The ARMv6 kernels are built on the host
+# with emulated instructions to be checked against the portable ones.
+
+dsp_test_ldlibs := -lpthread -lm
+ifeq ($(HOST_OS),linux)
+  dsp_test_ldlibs += -lrt
+endif
+
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES:= audio_dsp_test.cpp ../AudioDsp.cpp
+LOCAL_C_INCLUDES:= $(LOCAL_PATH)/..
+LOCAL_MODULE:= audio_dsp_test
+LOCAL_MODULE_TAGS:= tests
+LOCAL_CFLAGS:= -DAUDIO_ARMV6_DSP=1
+LOCAL_STATIC_LIBRARIES:= libutils libcutils liblog
+LOCAL_LDLIBS:= $(dsp_test_ldlibs)
+include $(BUILD_HOST_EXECUTABLE)
+
+# the same tests on the device, with the ARMv6 instructions
+ifeq ($(TARGET_ARCH_VARIANT),armv6-vfp)
+include $(CLEAR_VARS)
+LOCAL_ARM_MODE:= arm
+LOCAL_SRC_FILES:= audio_dsp_test.cpp ../AudioDsp.cpp
+LOCAL_C_INCLUDES:= $(LOCAL_PATH)/..
+LOCAL_MODULE:= audio_dsp_test
+LOCAL_MODULE_TAGS:= tests
+LOCAL_CFLAGS:= -DAUDIO_ARMV6_DSP=1
+LOCAL_SHARED_LIBRARIES:= libc libcutils libutils
+include $(BUILD_EXECUTABLE)
+endif
+
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES:= audio_dsp_bench.cpp ../AudioDsp.cpp
+LOCAL_C_INCLUDES:= $(LOCAL_PATH)/..
+LOCAL_MODULE:= audio_dsp_bench
+LOCAL_MODULE_TAGS:= tests
+LOCAL_STATIC_LIBRARIES:= libutils libcutils liblog
+LOCAL_LDLIBS:= $(dsp_test_ldlibs)
+include $(BUILD_HOST_EXECUTABLE)
+
+# Tests of the mixer and the HAL on the simulated sound card, on the device
+# or in simulator builds. audio_hal_test exits with 0 if all tests pass.
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES:= audio_hal_test.cpp
+LOCAL_C_INCLUDES:= $(LOCAL_PATH)/..
+LOCAL_MODULE:= audio_hal_test
+LOCAL_MODULE_TAGS:= tests
+LOCAL_SHARED_LIBRARIES:= libaudio libmedia libcutils libutils
+include $(BUILD_EXECUTABLE)
+
+# Benchmark of the HAL on the simulated sound card: per period CPU, output
+# latency, standby resume and route switch times. It needs no sound card, on
+# the device or in simulator builds, and exits with 0 if all measurements ran.
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES:= audio_hal_bench.cpp
+LOCAL_C_INCLUDES:= $(LOCAL_PATH)/..
+LOCAL_MODULE:= audio_hal_bench
+LOCAL_MODULE_TAGS:= tests
+LOCAL_SHARED_LIBRARIES:= libaudio libmedia libcutils libutils
+include $(BUILD_EXECUTABLE)
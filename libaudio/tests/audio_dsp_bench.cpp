@@ -0,0 +1,320 @@
+/*
+** Copyright 2010, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+/*
+ * Cost of the DSP code of the capture and playback paths.
+ *
+ * usage: audio_dsp_bench [seconds]
+ *
+ * Converts seconds (default 10) of audio for every capture rate and channel
+ * count, through the same stages as AudioStreamInALSA and through the
+ * downsampling chain the polyphase filter bank replaced (legacy_downsampler.h),
+ * and runs the output gain and mixing kernels on as many 44.1kHz stereo
+ * frames. Reports the thread CPU time per output frame and the share of one
+ * CPU used in real time.
+ *
+ * The stereo filter stage of the DownSampler is also timed alone, on the
+ * interleaved history it keeps and on the separate left and right histories
+ * it used to deinterleave the capture data into.
+ *
+ * Then reports, for both capture chains, the worst attenuation of the sines
+ * from the stopband edge of the polyphase filters up to 22kHz: the power of
+ * the whole output, aliases included, relative to the input sine.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dsp_test_util.h"
+#include "legacy_downsampler.h"
+
+using namespace android;
+
+// output frames asked to the DownSampler per call, 20ms at 8kHz
+#define READ_FRAMES 160
+
+static void report(const char *name, uint32_t rate, uint32_t channels,
+                   nsecs_t time, uint64_t frames)
+{
+    double nsPerFrame = (double)time / frames;
+    printf("%-16s %6u %8u %10.1f %8.2f\n", name, rate, channels, nsPerFrame,
+           nsPerFrame * rate / 1e7);
+}
+
+// Converts seconds of the looped 44.1kHz stereo input with a Chain
+template <class Chain>
+static void bench_chain(const char *name, uint32_t rate, uint32_t channels,
+                        const int16_t *in, uint32_t seconds)
+{
+    int16_t out[READ_FRAMES * 2];
+    TestSource source(in, AUDIO_HW_IN_SAMPLERATE, 2, AUDIO_HW_IN_PERIOD_SZ, true);
+    Chain chain(rate, channels, &source);
+
+    uint64_t frames = 0;
+    nsecs_t start = test_cpu_time();
+    while (frames < (uint64_t)seconds * rate) {
+        size_t count = READ_FRAMES;
+        chain.read(out, &count);
+        frames += count;
+    }
+    report(name, rate, channels, test_cpu_time() - start, frames);
+}
+
+static void bench_capture(uint32_t seconds)
+{
+    int16_t *in = new int16_t[AUDIO_HW_IN_SAMPLERATE * 2];
+
+    test_signal(in, AUDIO_HW_IN_SAMPLERATE, 2, 1);
+
+    for (size_t r = 0; r < NUM_TEST_RATES; r++) {
+        for (size_t c = 0; c < NUM_TEST_CHANNELS; c++) {
+            const uint32_t rate = kTestRates[r];
+            const uint32_t channels = kTestChannels[c];
+            if (rate == AUDIO_HW_IN_SAMPLERATE && channels == 2) {
+                printf("%-16s %6u %8u %10s %8s\n", "capture", rate, channels, "-", "-");
+                continue;
+            }
+            bench_chain<TestCaptureChain>("capture", rate, channels, in, seconds);
+            // the legacy chain did not convert 44.1kHz inputs
+            if (rate != AUDIO_HW_IN_SAMPLERATE) {
+                bench_chain<LegacyCaptureChain>("capture legacy", rate, channels, in, seconds);
+            }
+        }
+    }
+
+    delete[] in;
+}
+
+// Filter bank geometry of the capture rates, as in AudioDsp.cpp
+struct FilterGeometry {
+    uint32_t rate;
+    uint32_t up;
+    uint32_t down;
+    int taps;
+};
+
+static const FilterGeometry kFilterGeometry[] = {
+    { 22050,   1,   2, 24 },
+    { 16000, 160, 441, 48 },
+    { 11025,   1,   4, 64 },
+    {  8000,  80, 441, 96 },
+};
+#define NUM_FILTER_GEOMETRY (sizeof(kFilterGeometry) / sizeof(kFilterGeometry[0]))
+
+/*
+ * Stereo filtering of seconds of capture periods at the rate of geometry,
+ * the coefficient values do not matter. Each period is either deinterleaved
+ * into a left and a right history and filtered one channel at a time,
+ * taking the shifted copy of the coefficients for windows starting on an
+ * odd sample, or copied as is and filtered by fir_convolve_stereo().
+ */
+static void bench_stereo_filter(const FilterGeometry *geometry, bool interleaved,
+                                const int16_t *in, uint32_t seconds)
+{
+    const uint32_t period = AUDIO_HW_IN_PERIOD_SZ;
+    const int taps = (geometry->taps + 1) & ~1;
+    const int stride = (geometry->taps + 2) & ~1;
+    // fir_convolve() may read up to two frames past the filter window
+    int16_t *history = new int16_t[(period + geometry->taps + 2) * 2];
+    int16_t *left = history;
+    int16_t *right = history + period + geometry->taps + 2;
+    int16_t *coeffs = new int16_t[stride * 2];
+    int16_t *out = new int16_t[period * 2];
+
+    memset(history, 0, (period + geometry->taps + 2) * 2 * sizeof(*history));
+    test_signal(coeffs, stride * 2, 1, 3);
+    for (int i = 0; i < stride * 2; i++) {
+        coeffs[i] >>= 6;
+    }
+
+    uint64_t frames = 0;
+    nsecs_t start = test_cpu_time();
+    while (frames < (uint64_t)seconds * geometry->rate) {
+        if (interleaved) {
+            memcpy(history, in, period * 2 * sizeof(*history));
+        } else {
+            for (uint32_t i = 0; i < period; ++i) {
+                left[i] = in[i * 2];
+                right[i] = in[i * 2 + 1];
+            }
+        }
+
+        // the windows that fit in the period
+        const uint32_t count = (period - geometry->taps) * geometry->up / geometry->down;
+        for (uint32_t n = 0; n < count; ++n) {
+            int first = n * geometry->down / geometry->up;
+            if (interleaved) {
+                int32_t l, r;
+                fir_convolve_stereo(history + first * 2, coeffs, taps, &l, &r);
+                out[n * 2] = clip(l);
+                out[n * 2 + 1] = clip(r);
+            } else {
+                const int16_t *c = coeffs;
+                int t = taps;
+                if (first & 1) {
+                    c += stride;
+                    first--;
+                    t = stride;
+                }
+                out[n * 2] = clip(fir_convolve(left + first, c, t));
+                out[n * 2 + 1] = clip(fir_convolve(right + first, c, t));
+            }
+        }
+        frames += count;
+    }
+    report(interleaved ? "fir interleaved" : "fir deinterleave", geometry->rate, 2,
+           test_cpu_time() - start, frames);
+
+    delete[] history;
+    delete[] coeffs;
+    delete[] out;
+}
+
+static void bench_filter(uint32_t seconds)
+{
+    int16_t *in = new int16_t[AUDIO_HW_IN_PERIOD_SZ * 2];
+
+    test_signal(in, AUDIO_HW_IN_PERIOD_SZ, 2, 1);
+    for (size_t g = 0; g < NUM_FILTER_GEOMETRY; g++) {
+        bench_stereo_filter(&kFilterGeometry[g], false, in, seconds);
+        bench_stereo_filter(&kFilterGeometry[g], true, in, seconds);
+    }
+
+    delete[] in;
+}
+
+// 0.5 full scale input sines, half a second each
+#define SINE_AMPLITUDE 16384.0
+#define SINE_FRAMES (AUDIO_HW_IN_SAMPLERATE / 2)
+#define STOPBAND_STEP_HZ 250
+
+/*
+ * Power of the mono output of a Chain for a 44.1kHz sine at f Hz, after the
+ * filter settles, relative to the sine, in dB.
+ */
+template <class Chain>
+static double attenuation(uint32_t rate, uint32_t f)
+{
+    int16_t *in = new int16_t[SINE_FRAMES * 2];
+    int16_t *out = new int16_t[SINE_FRAMES];
+
+    for (uint32_t n = 0; n < SINE_FRAMES; n++) {
+        double s = SINE_AMPLITUDE * sin(2 * M_PI * f * n / AUDIO_HW_IN_SAMPLERATE);
+        in[n * 2] = in[n * 2 + 1] = (int16_t)floor(s + 0.5);
+    }
+    TestSource source(in, SINE_FRAMES, 2, AUDIO_HW_IN_PERIOD_SZ);
+    Chain chain(rate, 1, &source);
+    size_t frames = 0;
+    while (true) {
+        size_t count = READ_FRAMES;
+        chain.read(out + frames, &count);
+        frames += count;
+        if (count < READ_FRAMES) {
+            break;
+        }
+    }
+
+    size_t skip = rate / 50;
+    double power = 0;
+    for (size_t n = skip; n < frames - skip; n++) {
+        power += (double)out[n] * out[n];
+    }
+    power /= frames - 2 * skip;
+
+    delete[] in;
+    delete[] out;
+    return 10 * log10(SINE_AMPLITUDE * SINE_AMPLITUDE / 2 / (power + 1e-9));
+}
+
+template <class Chain>
+static double worst_stopband(uint32_t rate, uint32_t edge)
+{
+    double worst = HUGE_VAL;
+    for (uint32_t f = edge; f < AUDIO_HW_IN_SAMPLERATE / 2; f += STOPBAND_STEP_HZ) {
+        double att = attenuation<Chain>(rate, f);
+        if (att < worst) {
+            worst = att;
+        }
+    }
+    return worst;
+}
+
+static void bench_stopband()
+{
+    printf("\n%-16s %6s %8s %10s %10s\n", "stopband", "rate", "from Hz", "polyphase", "legacy");
+    for (size_t r = 0; r < NUM_RESPONSE_BOUNDS; r++) {
+        const ResponseBound *bound = &kResponseBounds[r];
+        printf("%-16s %6u %8u %7.1f dB %7.1f dB\n", "stopband", bound->rate, bound->stopband,
+               worst_stopband<TestCaptureChain>(bound->rate, bound->stopband),
+               worst_stopband<LegacyCaptureChain>(bound->rate, bound->stopband));
+    }
+}
+
+static void bench_output(uint32_t seconds)
+{
+    const uint32_t period = AUDIO_HW_OUT_PERIOD_SZ;
+    int16_t *in = new int16_t[period * 2];
+    int16_t *out = new int16_t[period * 2];
+    const uint64_t total = (uint64_t)seconds * AUDIO_HW_OUT_SAMPLERATE;
+    uint64_t frames;
+    nsecs_t start;
+
+    test_signal(in, period, 2, 2);
+    memcpy(out, in, period * 2 * sizeof(int16_t));
+
+    start = test_cpu_time();
+    for (frames = 0; frames < total; frames += period) {
+        gain_stereo(in, out, period, AudioHardware::ChannelMixer::UNITY_GAIN / 2);
+    }
+    report("gain_stereo", AUDIO_HW_OUT_SAMPLERATE, 2, test_cpu_time() - start, frames);
+
+    start = test_cpu_time();
+    for (frames = 0; frames < total; frames += period) {
+        gain_ramp_stereo(in, out, period, 1 << 30, -(1 << 30) / (int32_t)period);
+    }
+    report("gain_ramp_stereo", AUDIO_HW_OUT_SAMPLERATE, 2, test_cpu_time() - start, frames);
+
+    start = test_cpu_time();
+    for (frames = 0; frames < total; frames += period) {
+        mix_stereo(out, in, period);
+    }
+    report("mix_stereo", AUDIO_HW_OUT_SAMPLERATE, 2, test_cpu_time() - start, frames);
+
+    delete[] in;
+    delete[] out;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = 10;
+
+    if (argc > 1) {
+        seconds = atoi(argv[1]);
+        if (seconds == 0) {
+            fprintf(stderr, "usage: audio_dsp_bench [seconds]\n");
+            return 1;
+        }
+    }
+
+    printf("audio_dsp_bench: %u s of audio per case\n", seconds);
+    printf("%-16s %6s %8s %10s %8s\n", "stage", "rate", "channels", "ns/frame", "cpu %");
+    bench_capture(seconds);
+    bench_filter(seconds);
+    bench_output(seconds);
+    bench_stopband();
+    return 0;
+}
@@ -0,0 +1,622 @@
+/*
+** Copyright 2010, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+/*
+ * Regression tests of the capture DSP stages: fir_convolve(), ChannelMixer
+ * and DownSampler.
+ *
+ * The fixed-point outputs are compared bit for bit with an exact reference
+ * or with the golden vectors of dsp_golden.h. The frequency response of the
+ * DownSampler, which has no exact reference, is bounded in SNR and stopband
+ * attenuation against double precision sine waves.
+ *
+ * Built with AUDIO_ARMV6_DSP, it also checks that the ARMv6 kernels give the
+ * same results as the portable ones.
+ *
+ * Exits with 0 if all tests pass. "audio_dsp_test --golden" prints a new
+ * dsp_golden.h: only regenerate it for an intended change of the output.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dsp_test_util.h"
+
+using namespace android;
+
+static int sFailures;
+
+#define EXPECT(cond, ...) do {                                      \
+    if (!(cond)) {                                                  \
+        fprintf(stderr, "%s:%d: FAILED: ", __FILE__, __LINE__);     \
+        fprintf(stderr, __VA_ARGS__);                               \
+        fprintf(stderr, "\n");                                      \
+        sFailures++;                                                \
+    }                                                               \
+} while (0)
+
+struct GoldenVector {
+    const char *name;
+    const int16_t *data;
+    size_t size;
+};
+
+#include "dsp_golden.h"
+
+#define NUM_GOLDEN_VECTORS (sizeof(goldenVectors) / sizeof(goldenVectors[0]))
+
+// frames of the 44.1kHz stereo input of the DownSampler golden vectors: a
+// bit more than two periods so that the filter history ring wraps
+#define GOLDEN_INPUT_FRAMES (AUDIO_HW_IN_PERIOD_SZ * 2 + 152)
+// frames of the ChannelMixer golden vectors
+#define GOLDEN_MIXER_FRAMES 64
+// output frames asked to the DownSampler per call
+#define READ_FRAMES 160
+
+static bool sGenerate;
+static const char *sGenerated[32];
+static size_t sNumGenerated;
+
+/*
+ * Compare an output, described by what, with the golden vector name.
+ */
+static void check_golden_as(const char *name, const char *what,
+                            const int16_t *data, size_t size)
+{
+    for (size_t i = 0; i < NUM_GOLDEN_VECTORS; i++) {
+        const GoldenVector *golden = &goldenVectors[i];
+        if (strcmp(golden->name, name) != 0) {
+            continue;
+        }
+        EXPECT(golden->size == size, "%s: %zu samples, expected %zu",
+               what, size, golden->size);
+        for (size_t j = 0; j < size && j < golden->size; j++) {
+            if (data[j] != golden->data[j]) {
+                EXPECT(false, "%s: sample %zu is %d, expected %d",
+                       what, j, data[j], golden->data[j]);
+                break;
+            }
+        }
+        return;
+    }
+    EXPECT(false, "%s: no golden vector", name);
+}
+
+/*
+ * Compare an output with its golden vector, or print it as one when the
+ * golden vectors are generated.
+ */
+static void check_golden(const char *name, const int16_t *data, size_t size)
+{
+    if (sGenerate) {
+        printf("static const int16_t golden_%s[] = {", name);
+        for (size_t i = 0; i < size; i++) {
+            printf("%s%d,", (i % 12) ? " " : "\n   ", data[i]);
+        }
+        printf("\n};\n\n");
+        sGenerated[sNumGenerated++] = strdup(name);
+        return;
+    }
+    check_golden_as(name, name, data, size);
+}
+
+//------------------------------------------------------------------------------
+//  fir_convolve
+//------------------------------------------------------------------------------
+
+/*
+ * fir_convolve() and fir_convolve_stereo() against a 64-bit sum of products,
+ * for random samples and coefficients small enough not to overflow the
+ * 32-bit accumulator, on every even tap count up to the longest filter.
+ */
+static void test_fir_convolve()
+{
+    uint32_t seed = 1;
+    int16_t a[2 * 128];
+    int16_t left[128];
+    int16_t right[128];
+    int16_t b[128];
+
+    for (int taps = 2; taps <= 128; taps += 2) {
+        const int32_t range = 65536 / taps;
+        for (int i = 0; i < taps; i++) {
+            left[i] = a[i * 2] = (int16_t)(test_random(&seed) - 32768);
+            right[i] = a[i * 2 + 1] = (int16_t)(test_random(&seed) - 32768);
+            b[i] = (int16_t)((int32_t)(test_random(&seed) % range) - range / 2);
+        }
+        int64_t suml = 1 << 13;
+        int64_t sumr = 1 << 13;
+        for (int i = 0; i < taps; i++) {
+            suml += (int64_t)left[i] * b[i];
+            sumr += (int64_t)right[i] * b[i];
+        }
+
+        int32_t l = fir_convolve(left, b, taps);
+        EXPECT(l == (int32_t)(suml >> 14), "fir_convolve %d taps: %d, expected %d",
+               taps, l, (int32_t)(suml >> 14));
+        int32_t r = 0;
+        fir_convolve_stereo(a, b, taps, &l, &r);
+        EXPECT(l == (int32_t)(suml >> 14) && r == (int32_t)(sumr >> 14),
+               "fir_convolve_stereo %d taps: %d %d, expected %d %d",
+               taps, l, r, (int32_t)(suml >> 14), (int32_t)(sumr >> 14));
+    }
+
+    EXPECT(clip(32768) == 32767 && clip(-32769) == -32768 && clip(-5) == -5,
+           "clip");
+}
+
+#ifdef AUDIO_ARMV6_DSP
+//------------------------------------------------------------------------------
+//  ARMv6 kernels
+//------------------------------------------------------------------------------
+
+#define ARMV6_TEST_FRAMES 257
+
+static void expect_same(const char *name, const int16_t *out, const int16_t *ref,
+                        size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        if (out[i] != ref[i]) {
+            EXPECT(false, "%s: sample %zu is %d, expected %d", name, i, out[i], ref[i]);
+            return;
+        }
+    }
+}
+
+/*
+ * The ARMv6 kernels must be bit-exact with the portable ones, saturation
+ * included. Off ARM this checks them with emulated instructions; on an
+ * ARMv6 target with the real ones.
+ */
+static void test_armv6_kernels()
+{
+    uint32_t seed = 3;
+    int16_t a[2 * 128] __attribute__((aligned(4)));
+    int16_t b[128] __attribute__((aligned(4)));
+
+    for (int taps = 2; taps <= 128; taps += 2) {
+        const int32_t range = 65536 / taps;
+        for (int i = 0; i < taps; i++) {
+            a[i * 2] = (int16_t)(test_random(&seed) - 32768);
+            a[i * 2 + 1] = (int16_t)(test_random(&seed) - 32768);
+            b[i] = (int16_t)((int32_t)(test_random(&seed) % range) - range / 2);
+        }
+        int32_t c = fir_convolve_c(a, b, taps);
+        int32_t v = fir_convolve_armv6(a, b, taps);
+        EXPECT(v == c, "fir_convolve_armv6 %d taps: %d, expected %d", taps, v, c);
+
+        int32_t cl, cr, vl, vr;
+        fir_convolve_stereo_c(a, b, taps, &cl, &cr);
+        fir_convolve_stereo_armv6(a, b, taps, &vl, &vr);
+        EXPECT(vl == cl && vr == cr, "fir_convolve_stereo_armv6 %d taps: %d %d, expected %d %d",
+               taps, vl, vr, cl, cr);
+    }
+
+    int16_t in[ARMV6_TEST_FRAMES * 2] __attribute__((aligned(4)));
+    int16_t in2[ARMV6_TEST_FRAMES * 2] __attribute__((aligned(4)));
+    int16_t ref[ARMV6_TEST_FRAMES * 2] __attribute__((aligned(4)));
+    int16_t out[ARMV6_TEST_FRAMES * 2] __attribute__((aligned(4)));
+    for (size_t i = 0; i < ARMV6_TEST_FRAMES * 2; i++) {
+        in[i] = (int16_t)(test_random(&seed) - 32768);
+        in2[i] = (int16_t)(test_random(&seed) - 32768);
+    }
+
+    static const int16_t kGains[][2] = {
+        { 8192, 8192 }, { 16384, 0 }, { -16384, 12288 }, { 24576, 24576 }, { 32767, -32768 },
+    };
+    for (size_t i = 0; i < sizeof(kGains) / sizeof(kGains[0]); i++) {
+        // full scale frames with both gains at -32768 would overflow
+        if (kGains[i][0] != -32768 || kGains[i][1] != -32768) {
+            stereo_to_mono_c(in, ref, ARMV6_TEST_FRAMES, kGains[i]);
+            stereo_to_mono_armv6(in, out, ARMV6_TEST_FRAMES, kGains[i]);
+            expect_same("stereo_to_mono_armv6", out, ref, ARMV6_TEST_FRAMES);
+        }
+        mono_to_stereo_c(in, ref, ARMV6_TEST_FRAMES, kGains[i]);
+        mono_to_stereo_armv6(in, out, ARMV6_TEST_FRAMES, kGains[i]);
+        expect_same("mono_to_stereo_armv6", out, ref, ARMV6_TEST_FRAMES * 2);
+    }
+
+    static const int32_t kStereoGains[] = { 0, 1, 8192, 16384, 24576, 32767 };
+    for (size_t i = 0; i < sizeof(kStereoGains) / sizeof(kStereoGains[0]); i++) {
+        gain_stereo_c(in, ref, ARMV6_TEST_FRAMES, kStereoGains[i]);
+        gain_stereo_armv6(in, out, ARMV6_TEST_FRAMES, kStereoGains[i]);
+        expect_same("gain_stereo_armv6", out, ref, ARMV6_TEST_FRAMES * 2);
+    }
+
+    // ramps up to and down from a 2.30 gain close to 2
+    const int32_t step = 0x7fff0000 / ARMV6_TEST_FRAMES;
+    gain_ramp_stereo_c(in, ref, ARMV6_TEST_FRAMES, 0, step);
+    gain_ramp_stereo_armv6(in, out, ARMV6_TEST_FRAMES, 0, step);
+    expect_same("gain_ramp_stereo_armv6", out, ref, ARMV6_TEST_FRAMES * 2);
+    gain_ramp_stereo_c(in, ref, ARMV6_TEST_FRAMES, step * ARMV6_TEST_FRAMES, -step);
+    gain_ramp_stereo_armv6(in, out, ARMV6_TEST_FRAMES, step * ARMV6_TEST_FRAMES, -step);
+    expect_same("gain_ramp_stereo_armv6", out, ref, ARMV6_TEST_FRAMES * 2);
+
+    // in place, as the output mixes into its buffer
+    memcpy(ref, in2, sizeof(ref));
+    memcpy(out, in2, sizeof(out));
+    mix_stereo_c(ref, in, ARMV6_TEST_FRAMES);
+    mix_stereo_armv6(out, in, ARMV6_TEST_FRAMES);
+    expect_same("mix_stereo_armv6", out, ref, ARMV6_TEST_FRAMES * 2);
+}
+#endif
+
+//------------------------------------------------------------------------------
+//  ChannelMixer
+//------------------------------------------------------------------------------
+
+struct MixerCase {
+    const char *name;
+    uint32_t outChannels;
+    uint32_t channels;
+    // NULL for the default matrix
+    const int16_t *gains;
+};
+
+// 2.14 fixed-point gains, including some large enough to saturate
+static const int16_t kSwapGains[] = { 12288, -8192, 24576, 20480 };
+static const int16_t kQuadGains[] = { 8192, 0, 8192, -4096,  0, 16384, 8192, 4096 };
+static const int16_t kLoudMonoGains[] = { 24576, 24576 };
+
+static const MixerCase kMixerCases[] = {
+    { "mixer_2_1", 1, 2, NULL },
+    { "mixer_1_2", 2, 1, NULL },
+    { "mixer_2_2", 2, 2, kSwapGains },
+    { "mixer_4_2", 2, 4, kQuadGains },
+    { "mixer_2_1_loud", 1, 2, kLoudMonoGains },
+};
+#define NUM_MIXER_CASES (sizeof(kMixerCases) / sizeof(kMixerCases[0]))
+
+/*
+ * ChannelMixer outputs for the default and custom matrices, with process()
+ * and through mix() in uneven chunks, which must give the same frames.
+ */
+static void test_channel_mixer()
+{
+    for (size_t i = 0; i < NUM_MIXER_CASES; i++) {
+        const MixerCase *mc = &kMixerCases[i];
+        int16_t in[GOLDEN_MIXER_FRAMES * 4];
+        int16_t out[GOLDEN_MIXER_FRAMES * 2];
+        int16_t mixed[GOLDEN_MIXER_FRAMES * 2];
+
+        test_signal(in, GOLDEN_MIXER_FRAMES, mc->channels, 7 + i);
+
+        TestSource source(in, GOLDEN_MIXER_FRAMES, mc->channels, 13);
+        AudioHardware::ChannelMixer mixer(mc->outChannels, mc->channels,
+                                          GOLDEN_MIXER_FRAMES, &source);
+        EXPECT(mixer.initCheck() == NO_ERROR, "%s: initCheck", mc->name);
+        if (mc->gains) {
+            EXPECT(mixer.setMatrix(mc->gains) == NO_ERROR, "%s: setMatrix", mc->name);
+        }
+
+        mixer.process(in, out, GOLDEN_MIXER_FRAMES);
+        check_golden(mc->name, out, GOLDEN_MIXER_FRAMES * mc->outChannels);
+
+        size_t frames = GOLDEN_MIXER_FRAMES;
+        EXPECT(mixer.mix(mixed, &frames) == 0 && frames == GOLDEN_MIXER_FRAMES,
+               "%s: mix() returned %zu frames", mc->name, frames);
+        EXPECT(memcmp(out, mixed, sizeof(int16_t) * frames * mc->outChannels) == 0,
+               "%s: mix() differs from process()", mc->name);
+    }
+
+    AudioHardware::ChannelMixer bad(3, 9, 16, NULL);
+    EXPECT(bad.initCheck() != NO_ERROR, "9 channel mixer accepted");
+}
+
+//------------------------------------------------------------------------------
+//  DownSampler
+//------------------------------------------------------------------------------
+
+/*
+ * Provider of chunks of random sizes, like a capture source after an
+ * overrun, a reopen or a short read.
+ */
+class RandomChunkSource : public TestSource {
+public:
+    RandomChunkSource(const int16_t *data, uint32_t frames, uint32_t channels,
+                      uint32_t seed)
+        : TestSource(data, frames, channels, 1), mSeed(seed) {}
+
+    virtual status_t getNextBuffer(Buffer* buffer) {
+        mChunk = 1 + test_random(&mSeed) % AUDIO_HW_IN_PERIOD_SZ;
+        return TestSource::getNextBuffer(buffer);
+    }
+
+private:
+    uint32_t mSeed;
+};
+
+/*
+ * Down sample frames of 44.1kHz input with inChannels channels to rate and
+ * channels, through a channel mixer if the channel counts differ, and return
+ * the output frames. out must hold all the output. With a seed of 0 the
+ * input comes in pcm periods and the output is read in fixed blocks, like
+ * in an input stream; otherwise the input chunks and the reads have random
+ * sizes, which must not change the output.
+ */
+static size_t run_downsampler(uint32_t rate, uint32_t channels, uint32_t inChannels,
+                              const int16_t *in, uint32_t frames, int16_t *out,
+                              uint32_t seed)
+{
+    TestSource periods(in, frames, inChannels, AUDIO_HW_IN_PERIOD_SZ);
+    RandomChunkSource chunks(in, frames, inChannels, seed);
+    AudioHardware::BufferProvider *source = seed ? (TestSource *)&chunks : &periods;
+    AudioHardware::ChannelMixer *mixer = NULL;
+    if (channels != inChannels) {
+        mixer = new AudioHardware::ChannelMixer(channels, inChannels,
+                                                AUDIO_HW_IN_PERIOD_SZ, source);
+    }
+    AudioHardware::DownSampler downSampler(rate, channels, AUDIO_HW_IN_PERIOD_SZ,
+                                           source, mixer);
+    size_t total = 0;
+
+    while (true) {
+        size_t wanted = seed ? 1 + test_random(&seed) % (READ_FRAMES * 2) : READ_FRAMES;
+        size_t count = wanted;
+        downSampler.resample(out + total * channels, &count);
+        total += count;
+        if (count < wanted) {
+            break;
+        }
+    }
+    delete mixer;
+    return total;
+}
+
+struct DownSamplerCase {
+    const char *name;
+    uint32_t channels;
+    uint32_t inChannels;
+};
+
+// the stereo pcm to a stereo or mono input, and a mono pcm
+static const DownSamplerCase kDownSamplerCases[] = {
+    { "downsampler_%u_1", 1, 2 },
+    { "downsampler_%u_2", 2, 2 },
+    { "downsampler_%u_1_nomix", 1, 1 },
+};
+#define NUM_DOWNSAMPLER_CASES (sizeof(kDownSamplerCases) / sizeof(kDownSamplerCases[0]))
+
+// runs with random chunk and read sizes per rate and case
+#define STREAMING_RUNS 16
+
+/*
+ * DownSampler outputs for every rate and case over a wide band signal. Each
+ * is checked in pcm periods, then, unless the golden vectors are generated,
+ * in random chunks.
+ *
+ * The vectors were first recorded with the resampler that kept its history
+ * in a linear buffer (before "Keep the DownSampler filter history in a
+ * mirrored ring buffer"), except for the mono outputs of the stereo pcm,
+ * which changed with the rounding of the channel mixer matrix.
+ */
+static void test_downsampler_golden()
+{
+    int16_t in[GOLDEN_INPUT_FRAMES * 2];
+    int16_t out[GOLDEN_INPUT_FRAMES * 2];
+
+    for (size_t r = 0; r < NUM_TEST_RATES; r++) {
+        if (kTestRates[r] == AUDIO_HW_IN_SAMPLERATE) {
+            continue;
+        }
+        for (size_t i = 0; i < NUM_DOWNSAMPLER_CASES; i++) {
+            const DownSamplerCase *dc = &kDownSamplerCases[i];
+            char name[32];
+            snprintf(name, sizeof(name), dc->name, kTestRates[r]);
+            test_signal(in, GOLDEN_INPUT_FRAMES, dc->inChannels, 1);
+
+            size_t frames = run_downsampler(kTestRates[r], dc->channels, dc->inChannels,
+                                            in, GOLDEN_INPUT_FRAMES, out, 0);
+            check_golden(name, out, frames * dc->channels);
+            for (uint32_t seed = 1; seed <= STREAMING_RUNS && !sGenerate; seed++) {
+                char run[48];
+                snprintf(run, sizeof(run), "%s random chunks %u", name, seed);
+                memset(out, 0, sizeof(out));
+                frames = run_downsampler(kTestRates[r], dc->channels, dc->inChannels,
+                                         in, GOLDEN_INPUT_FRAMES, out, seed);
+                check_golden_as(name, run, out, frames * dc->channels);
+            }
+        }
+    }
+
+    int16_t dummy;
+    AudioHardware::DownSampler bad(12345, 2, 1024, NULL);
+    EXPECT(bad.initCheck() != NO_ERROR, "12345 Hz down sampler accepted");
+    size_t frames = 1;
+    EXPECT(bad.resample(&dummy, &frames) != 0, "12345 Hz down sampler ran");
+}
+
+/*
+ * Least squares fit of a sine of frequency f (in cycles per sample) and a DC
+ * offset to the samples of a channel. Returns the power of the sine and the
+ * power of the residual.
+ */
+static void fit_sine(const int16_t *data, size_t frames, uint32_t channels,
+                     double f, double *signal, double *noise)
+{
+    // normal equations of the basis sin, cos, 1
+    double m[3][3] = { { 0 } };
+    double v[3] = { 0 };
+    for (size_t n = 0; n < frames; n++) {
+        double basis[3] = { sin(2 * M_PI * f * n), cos(2 * M_PI * f * n), 1.0 };
+        double y = data[n * channels];
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                m[i][j] += basis[i] * basis[j];
+            }
+            v[i] += basis[i] * y;
+        }
+    }
+
+    // Cramer's rule
+    double det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+                 m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                 m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    double x[3];
+    for (int k = 0; k < 3; k++) {
+        double t[3][3];
+        memcpy(t, m, sizeof(t));
+        for (int i = 0; i < 3; i++) {
+            t[i][k] = v[i];
+        }
+        x[k] = (t[0][0] * (t[1][1] * t[2][2] - t[1][2] * t[2][1]) -
+                t[0][1] * (t[1][0] * t[2][2] - t[1][2] * t[2][0]) +
+                t[0][2] * (t[1][0] * t[2][1] - t[1][1] * t[2][0])) / det;
+    }
+
+    *signal = 0;
+    *noise = 0;
+    for (size_t n = 0; n < frames; n++) {
+        double s = x[0] * sin(2 * M_PI * f * n) + x[1] * cos(2 * M_PI * f * n);
+        double e = data[n * channels] - s - x[2];
+        *signal += s * s;
+        *noise += e * e;
+    }
+}
+
+// 0.5 full scale input sine
+#define SINE_AMPLITUDE 16384.0
+#define SINE_FRAMES (AUDIO_HW_IN_SAMPLERATE / 2)
+// minimum SNR of a passband sine, and attenuation of a stopband one, in dB
+#define MIN_PASSBAND_SNR_DB 70.0
+#define MIN_STOPBAND_ATTENUATION_DB 60.0
+// maximum passband gain error in dB: the highest frequency tested is the
+// -1 dB edge, with some room for the measurement
+#define MAX_PASSBAND_ERROR_DB 1.1
+
+/*
+ * Convert a 44.1kHz stereo sine at f Hz. Returns the power of the output
+ * fitted sine relative to the input sine, and the SNR of the output, in dB,
+ * over the output after the filter settles.
+ */
+static void sine_response(uint32_t rate, uint32_t channels, uint32_t f,
+                          double *gainDb, double *snrDb)
+{
+    int16_t *in = new int16_t[SINE_FRAMES * 2];
+    int16_t *out = new int16_t[SINE_FRAMES * 2];
+
+    for (uint32_t n = 0; n < SINE_FRAMES; n++) {
+        double s = SINE_AMPLITUDE * sin(2 * M_PI * f * n / AUDIO_HW_IN_SAMPLERATE);
+        in[n * 2] = in[n * 2 + 1] = (int16_t)floor(s + 0.5);
+    }
+    size_t frames = run_downsampler(rate, channels, 2, in, SINE_FRAMES, out, 0);
+    // skip the filter start and end
+    size_t skip = rate / 50;
+    double signal, noise;
+    fit_sine(out + skip * channels, frames - 2 * skip, channels,
+             (double)f / rate, &signal, &noise);
+    for (uint32_t c = 1; c < channels; c++) {
+        double s, n;
+        fit_sine(out + skip * channels + c, frames - 2 * skip, channels,
+                 (double)f / rate, &s, &n);
+        if (s / n < signal / noise) {
+            signal = s;
+            noise = n;
+        }
+    }
+    double inPower = SINE_AMPLITUDE * SINE_AMPLITUDE / 2 * (frames - 2 * skip);
+    *gainDb = 10 * log10(signal / inPower);
+    *snrDb = 10 * log10(signal / noise);
+
+    delete[] in;
+    delete[] out;
+}
+
+/*
+ * Stopband: the power of the whole output, aliases included, relative to
+ * the input sine.
+ */
+static double stopband_attenuation(uint32_t rate, uint32_t channels, uint32_t f)
+{
+    int16_t *in = new int16_t[SINE_FRAMES * 2];
+    int16_t *out = new int16_t[SINE_FRAMES * 2];
+
+    for (uint32_t n = 0; n < SINE_FRAMES; n++) {
+        double s = SINE_AMPLITUDE * sin(2 * M_PI * f * n / AUDIO_HW_IN_SAMPLERATE);
+        in[n * 2] = in[n * 2 + 1] = (int16_t)floor(s + 0.5);
+    }
+    size_t frames = run_downsampler(rate, channels, 2, in, SINE_FRAMES, out, 0);
+    size_t skip = rate / 50;
+    double power = 0;
+    for (size_t n = skip * channels; n < (frames - skip) * channels; n++) {
+        power += (double)out[n] * out[n];
+    }
+    power /= (frames - 2 * skip) * channels;
+
+    delete[] in;
+    delete[] out;
+    return 10 * log10(SINE_AMPLITUDE * SINE_AMPLITUDE / 2 / (power + 1e-9));
+}
+
+static void test_downsampler_response()
+{
+    for (size_t r = 0; r < NUM_RESPONSE_BOUNDS; r++) {
+        const ResponseBound *bound = &kResponseBounds[r];
+        const uint32_t freqs[] = { 100, 1000, bound->passband };
+        for (size_t c = 0; c < NUM_TEST_CHANNELS; c++) {
+            uint32_t channels = kTestChannels[c];
+            for (size_t i = 0; i < sizeof(freqs) / sizeof(freqs[0]); i++) {
+                double gain, snr;
+                sine_response(bound->rate, channels, freqs[i], &gain, &snr);
+                EXPECT(snr >= MIN_PASSBAND_SNR_DB, "%u Hz %u channels: %u Hz SNR %.1f dB",
+                       bound->rate, channels, freqs[i], snr);
+                EXPECT(fabs(gain) <= MAX_PASSBAND_ERROR_DB,
+                       "%u Hz %u channels: %u Hz gain %.2f dB",
+                       bound->rate, channels, freqs[i], gain);
+            }
+            double att = stopband_attenuation(bound->rate, channels, bound->stopband);
+            EXPECT(att >= MIN_STOPBAND_ATTENUATION_DB,
+                   "%u Hz %u channels: %u Hz attenuated by %.1f dB",
+                   bound->rate, channels, bound->stopband, att);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--golden") == 0) {
+        sGenerate = true;
+        printf("// Generated by \"audio_dsp_test --golden\", do not edit.\n\n");
+    }
+
+    test_channel_mixer();
+    test_downsampler_golden();
+    if (sGenerate) {
+        printf("static const GoldenVector goldenVectors[] = {\n");
+        for (size_t i = 0; i < sNumGenerated; i++) {
+            const char *name = sGenerated[i];
+            printf("    { \"%s\", golden_%s, sizeof(golden_%s) / sizeof(int16_t) },\n",
+                   name, name, name);
+        }
+        printf("};\n");
+        return 0;
+    }
+
+    test_fir_convolve();
+#ifdef AUDIO_ARMV6_DSP
+    test_armv6_kernels();
+#endif
+    test_downsampler_response();
+
+    if (sFailures) {
+        fprintf(stderr, "audio_dsp_test: %d failures\n", sFailures);
+        return 1;
+    }
+    printf("audio_dsp_test: all tests passed\n");
+    return 0;
+}
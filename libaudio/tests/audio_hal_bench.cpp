@@ -0,0 +1,429 @@
+/*
+** Copyright 2010, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+/*
+ * Benchmark of the audio HAL on the simulated sound card of alsa_sim.c, so
+ * that builds can be compared without sound hardware, in continuous
+ * integration for instance.
+ *
+ * usage: audio_hal_bench [-k] [-t seconds] [-n iterations]
+ *   -k  run on the real sound card instead of the simulated one
+ *   -t  seconds of playback and of capture for the CPU and latency figures
+ *       (default 2)
+ *   -n  iterations of the standby and route switch measurements (default 10)
+ *
+ * Measures:
+ * - the CPU time per period of playback and capture, all the HAL threads
+ *   included, and the longest write() or read() in CPU time
+ * - the wall time histogram of write(), for playback without and with the
+ *   writer thread (AUDIO_HW_OUT_WRITER_PROPERTY)
+ * - the output latency: time a written frame takes to reach the DAC, from
+ *   the render position after each write()
+ * - the time of the first write() after a warm standby, and after a cold
+ *   one: the pcm and mixer are then closed, as for a new output
+ * - the time of a route switch on a playing output, up to the first write()
+ *   on the new device
+ *
+ * Exits with 0 if all the measurements could be done.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cutils/properties.h>
+#include <utils/Timers.h>
+#include <utils/String8.h>
+#include <media/AudioSystem.h>
+#include <hardware_legacy/AudioHardwareInterface.h>
+
+#include "AudioHardware.h"
+
+extern "C" {
+#include "alsa_audio.h"
+}
+
+using namespace android;
+
+#define DEFAULT_SECONDS 2
+#define DEFAULT_ITERATIONS 10
+// idle time before each resume, long enough for the pcm to drain
+#define STANDBY_IDLE_MS 50
+
+struct Stats {
+    char name[40];
+    uint32_t count;
+    double sum;
+    double min;
+    double max;
+
+    Stats(const char *n) : count(0), sum(0), min(0), max(0) {
+        strncpy(name, n, sizeof(name) - 1);
+        name[sizeof(name) - 1] = '\0';
+    }
+
+    void add(double value) {
+        if (count == 0 || value < min) {
+            min = value;
+        }
+        if (count == 0 || value > max) {
+            max = value;
+        }
+        sum += value;
+        count++;
+    }
+
+    // values are in ns, printed in us
+    void print() {
+        if (count == 0) {
+            printf("%-32s -\n", name);
+            return;
+        }
+        printf("%-32s mean %9.1f us  min %9.1f us  max %9.1f us  (%u)\n", name,
+               sum / count / 1000, min / 1000, max / 1000, count);
+    }
+};
+
+static nsecs_t cpu_time(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (nsecs_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void fill_tone(int16_t *buffer, size_t frames, uint32_t channels)
+{
+    for (size_t i = 0; i < frames; i++) {
+        int16_t s = ((i / 50) & 1) ? 8192 : -8192;
+        for (uint32_t c = 0; c < channels; c++) {
+            *buffer++ = s;
+        }
+    }
+}
+
+static AudioStreamOut *open_output(AudioHardwareInterface *hw)
+{
+    int format = AudioSystem::PCM_16_BIT;
+    uint32_t channels = AudioSystem::CHANNEL_OUT_STEREO;
+    uint32_t rate = 44100;
+    status_t status;
+
+    AudioStreamOut *out = hw->openOutputStream(AudioSystem::DEVICE_OUT_SPEAKER,
+                                               &format, &channels, &rate, &status);
+    if (out == NULL) {
+        fprintf(stderr, "audio_hal_bench: cannot open output: %d\n", status);
+    }
+    return out;
+}
+
+/*
+ * Playback CPU per period, write() wall time and output latency, over
+ * duration seconds of playback from standby, with or without the writer
+ * thread.
+ */
+static bool bench_playback(AudioHardwareInterface *hw, uint32_t duration,
+                           bool writer)
+{
+    const char *label = writer ? "playback+writer" : "playback";
+    char name[40];
+    char value[PROPERTY_VALUE_MAX];
+
+    // read when the output is opened
+    property_get(AUDIO_HW_OUT_WRITER_PROPERTY, value, "");
+    property_set(AUDIO_HW_OUT_WRITER_PROPERTY, writer ? "1" : "0");
+    AudioStreamOut *out = open_output(hw);
+    property_set(AUDIO_HW_OUT_WRITER_PROPERTY, value);
+    if (out == NULL) {
+        return false;
+    }
+
+    const size_t frames = out->bufferSize() / out->frameSize();
+    const uint32_t rate = out->sampleRate();
+    int16_t *buffer = new int16_t[out->bufferSize() / sizeof(int16_t)];
+    fill_tone(buffer, frames, 2);
+
+    snprintf(name, sizeof(name), "%s write() cpu", label);
+    Stats writeCpu(name);
+    snprintf(name, sizeof(name), "%s latency", label);
+    Stats latency(name);
+    AudioHardware::TimingHistogram writeTime;
+    uint64_t written = 0;
+    uint32_t writes = 0;
+    bool ok = true;
+    nsecs_t start = systemTime();
+    nsecs_t cpu = cpu_time(CLOCK_PROCESS_CPUTIME_ID);
+
+    while (systemTime() - start < seconds(duration)) {
+        nsecs_t t = cpu_time(CLOCK_THREAD_CPUTIME_ID);
+        nsecs_t wall = systemTime();
+        if (out->write(buffer, out->bufferSize()) != (ssize_t)out->bufferSize()) {
+            fprintf(stderr, "audio_hal_bench: write failed\n");
+            ok = false;
+            break;
+        }
+        writeTime.add(systemTime() - wall);
+        writeCpu.add(cpu_time(CLOCK_THREAD_CPUTIME_ID) - t);
+        written += frames;
+        writes++;
+
+        // the render position runs from the exit of standby, like written
+        uint32_t rendered;
+        if (out->getRenderPosition(&rendered) == NO_ERROR && rendered != 0) {
+            latency.add((double)(written - rendered) * 1000000000LL / rate);
+        }
+    }
+    cpu = cpu_time(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+
+    if (writes) {
+        double perPeriod = (double)cpu / writes;
+        snprintf(name, sizeof(name), "%s cpu", label);
+        printf("%-32s %9.1f us per %u frames (%.2f%% cpu)\n", name,
+               perPeriod / 1000, (uint32_t)frames, perPeriod * rate / frames / 1e7);
+    }
+    writeCpu.print();
+    String8 result;
+    snprintf(name, sizeof(name), "%s write() time", label);
+    writeTime.dump(result, name);
+    printf("%s", result.string());
+    latency.print();
+    snprintf(name, sizeof(name), "%s reported latency", label);
+    printf("%-32s %9u ms\n", name, out->latency());
+
+    hw->closeOutputStream(out);
+    delete[] buffer;
+    return ok;
+}
+
+/*
+ * Time of the first write() after a warm standby, then after a cold one.
+ */
+static bool bench_standby(AudioHardwareInterface *hw, uint32_t iterations)
+{
+    AudioStreamOut *out = open_output(hw);
+    if (out == NULL) {
+        return false;
+    }
+
+    const size_t bytes = out->bufferSize();
+    int16_t *buffer = new int16_t[bytes / sizeof(int16_t)];
+    fill_tone(buffer, bytes / out->frameSize(), 2);
+
+    Stats warm("resume from warm standby");
+    Stats cold("resume from cold standby");
+    bool ok = true;
+
+    for (uint32_t i = 0; i < iterations && ok; i++) {
+        ok = out->write(buffer, bytes) == (ssize_t)bytes;
+        out->standby();
+        usleep(STANDBY_IDLE_MS * 1000);
+
+        nsecs_t t = systemTime();
+        ok = ok && out->write(buffer, bytes) == (ssize_t)bytes;
+        warm.add(systemTime() - t);
+    }
+
+    for (uint32_t i = 0; i < iterations && ok; i++) {
+        // closed from warm standby like AudioFlinger does, and a new output
+        // starts in the state of a cold standby
+        out->standby();
+        hw->closeOutputStream(out);
+        usleep(STANDBY_IDLE_MS * 1000);
+        out = open_output(hw);
+        if (out == NULL) {
+            ok = false;
+            break;
+        }
+
+        nsecs_t t = systemTime();
+        ok = out->write(buffer, bytes) == (ssize_t)bytes;
+        cold.add(systemTime() - t);
+    }
+
+    if (!ok) {
+        fprintf(stderr, "audio_hal_bench: write failed\n");
+    }
+    warm.print();
+    cold.print();
+
+    if (out != NULL) {
+        hw->closeOutputStream(out);
+    }
+    delete[] buffer;
+    return ok;
+}
+
+/*
+ * Time of a switch of a playing output between the speaker and the headset:
+ * from setParameters() to the end of the first write() on the new device,
+ * as the output only enters standby in setParameters().
+ */
+static bool bench_route(AudioHardwareInterface *hw, uint32_t iterations)
+{
+    AudioStreamOut *out = open_output(hw);
+    if (out == NULL) {
+        return false;
+    }
+
+    const size_t bytes = out->bufferSize();
+    int16_t *buffer = new int16_t[bytes / sizeof(int16_t)];
+    fill_tone(buffer, bytes / out->frameSize(), 2);
+
+    Stats route("route switch");
+    bool ok = true;
+
+    for (uint32_t i = 0; i < iterations * 2 && ok; i++) {
+        ok = out->write(buffer, bytes) == (ssize_t)bytes;
+
+        AudioParameter param;
+        param.addInt(String8(AudioParameter::keyRouting),
+                     (i & 1) ? AudioSystem::DEVICE_OUT_SPEAKER :
+                               AudioSystem::DEVICE_OUT_WIRED_HEADSET);
+        nsecs_t t = systemTime();
+        ok = ok && out->setParameters(param.toString()) == NO_ERROR &&
+             out->write(buffer, bytes) == (ssize_t)bytes;
+        route.add(systemTime() - t);
+    }
+
+    if (!ok) {
+        fprintf(stderr, "audio_hal_bench: route switch failed\n");
+    }
+    route.print();
+
+    hw->closeOutputStream(out);
+    delete[] buffer;
+    return ok;
+}
+
+/*
+ * Capture CPU per period and start time, over duration seconds of capture
+ * at rate.
+ */
+static bool bench_capture(AudioHardwareInterface *hw, uint32_t rate,
+                          uint32_t channelMask, uint32_t duration)
+{
+    int format = AudioSystem::PCM_16_BIT;
+    uint32_t channels = channelMask;
+    uint32_t sampleRate = rate;
+    status_t status;
+    char name[40];
+
+    AudioStreamIn *in = hw->openInputStream(AudioSystem::DEVICE_IN_BUILTIN_MIC,
+                                            &format, &channels, &sampleRate, &status,
+                                            (AudioSystem::audio_in_acoustics)0);
+    if (in == NULL) {
+        fprintf(stderr, "audio_hal_bench: cannot open %u Hz input: %d\n", rate, status);
+        return false;
+    }
+
+    const size_t bytes = in->bufferSize();
+    const size_t frames = bytes / in->frameSize();
+    int16_t *buffer = new int16_t[bytes / sizeof(int16_t)];
+
+    snprintf(name, sizeof(name), "capture %u/%u start", rate,
+             AudioSystem::popCount(channels));
+    Stats startTime(name);
+    snprintf(name, sizeof(name), "capture %u/%u read() cpu", rate,
+             AudioSystem::popCount(channels));
+    Stats readCpu(name);
+    uint32_t reads = 0;
+    bool ok = true;
+
+    nsecs_t start = systemTime();
+    ok = in->read(buffer, bytes) == (ssize_t)bytes;
+    startTime.add(systemTime() - start);
+
+    nsecs_t cpu = cpu_time(CLOCK_PROCESS_CPUTIME_ID);
+    start = systemTime();
+    while (ok && systemTime() - start < seconds(duration)) {
+        nsecs_t t = cpu_time(CLOCK_THREAD_CPUTIME_ID);
+        ok = in->read(buffer, bytes) == (ssize_t)bytes;
+        readCpu.add(cpu_time(CLOCK_THREAD_CPUTIME_ID) - t);
+        reads++;
+    }
+    cpu = cpu_time(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+
+    if (!ok) {
+        fprintf(stderr, "audio_hal_bench: %u Hz read failed\n", rate);
+    }
+    startTime.print();
+    if (reads) {
+        double perPeriod = (double)cpu / reads;
+        snprintf(name, sizeof(name), "capture %u/%u cpu", rate,
+                 AudioSystem::popCount(channels));
+        printf("%-32s %9.1f us per %u frames (%.2f%% cpu)\n", name,
+               perPeriod / 1000, (uint32_t)frames, perPeriod * rate / frames / 1e7);
+    }
+    readCpu.print();
+
+    hw->closeInputStream(in);
+    delete[] buffer;
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    bool kernel = false;
+    uint32_t duration = DEFAULT_SECONDS;
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "kt:n:")) != -1) {
+        switch (opt) {
+        case 'k':
+            kernel = true;
+            break;
+        case 't':
+            duration = atoi(optarg);
+            break;
+        case 'n':
+            iterations = atoi(optarg);
+            break;
+        default:
+            duration = 0;
+            break;
+        }
+    }
+    if (duration == 0 || iterations == 0) {
+        fprintf(stderr, "usage: audio_hal_bench [-k] [-t seconds] [-n iterations]\n");
+        return 1;
+    }
+
+    // before the HAL opens anything
+    if (!kernel && alsa_select_backend("sim") != 0) {
+        fprintf(stderr, "audio_hal_bench: no simulated sound card\n");
+        return 1;
+    }
+
+    AudioHardwareInterface *hw = createAudioHardware();
+    if (hw == NULL || hw->initCheck() != NO_ERROR) {
+        fprintf(stderr, "audio_hal_bench: audio hardware init failed\n");
+        return 1;
+    }
+    printf("audio_hal_bench: %s sound card, %u s per stream, %u iterations\n",
+           alsa_backend_name(), duration, iterations);
+
+    bool ok = bench_playback(hw, duration, false);
+    ok = bench_playback(hw, duration, true) && ok;
+    ok = bench_standby(hw, iterations) && ok;
+    ok = bench_route(hw, iterations) && ok;
+    ok = bench_capture(hw, 8000, AudioSystem::CHANNEL_IN_MONO, duration) && ok;
+    ok = bench_capture(hw, 44100, AudioSystem::CHANNEL_IN_STEREO, duration) && ok;
+
+    delete hw;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,333 @@
+/*
+** Copyright 2010, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+/*
+ * Regression tests of the mixer and the HAL on the simulated sound card of
+ * alsa_sim.c, so that they run without sound hardware.
+ *
+ * The mixer tests check that the shadow copies of the control values follow
+ * the changes of another client, the sim merging change events like the
+ * kernel does.
+ *
+ * The route tests check the control writes issued by an output route switch,
+ * as counted in the dump of the HAL: only the controls changing value are
+ * written.
+ *
+ * The render position tests check that the position of a playing output
+ * never goes back nor past the frames written, and trails them by no more
+ * than the latency the output reports.
+ *
+ * Exits with 0 if all tests pass.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <utils/String8.h>
+#include <media/AudioSystem.h>
+#include <hardware_legacy/AudioHardwareInterface.h>
+
+extern "C" {
+#include "alsa_audio.h"
+}
+
+using namespace android;
+
+static int sFailures;
+
+#define EXPECT(cond, ...) do {                                      \
+    if (!(cond)) {                                                  \
+        fprintf(stderr, "%s:%d: FAILED: ", __FILE__, __LINE__);     \
+        fprintf(stderr, __VA_ARGS__);                               \
+        fprintf(stderr, "\n");                                      \
+        sFailures++;                                                \
+    }                                                               \
+} while (0)
+
+// an integer control the HAL does not drive outside FM radio
+#define TEST_CTL "Line Input Gain"
+
+static long ctl_value(struct mixer_ctl *ctl)
+{
+    long value = -1;
+    mixer_ctl_get(ctl, 0, &value);
+    return value;
+}
+
+/*
+ * Two clients of the mixer: ours, whose shadow copies are checked, and
+ * theirs, changing the control behind our back.
+ */
+static void test_mixer_shadow()
+{
+    struct mixer *ours = mixer_open();
+    struct mixer *theirs = mixer_open();
+    if (ours == NULL || theirs == NULL) {
+        EXPECT(false, "cannot open the mixer");
+        return;
+    }
+    struct mixer_ctl *ctl = mixer_get_control(ours, TEST_CTL, 0);
+    struct mixer_ctl *other = mixer_get_control(theirs, TEST_CTL, 0);
+    if (ctl == NULL || other == NULL) {
+        EXPECT(false, "no %s control", TEST_CTL);
+        return;
+    }
+    mixer_ctl_set(other, CTL_VALUE_RAW | 0);
+
+    // change by another client
+    EXPECT(mixer_ctl_update(ctl, CTL_VALUE_RAW | 10) == 1, "first write skipped");
+    EXPECT(mixer_ctl_update(ctl, CTL_VALUE_RAW | 10) == 0, "same value written again");
+    mixer_ctl_set(other, CTL_VALUE_RAW | 20);
+    EXPECT(ctl_value(ctl) == 20, "foreign change not seen: %ld", ctl_value(ctl));
+    EXPECT(mixer_ctl_update(ctl, CTL_VALUE_RAW | 10) == 1, "write after foreign change skipped");
+    EXPECT(ctl_value(other) == 10, "control holds %ld, not 10", ctl_value(other));
+
+    // rewrite of the value the control holds: the driver sends no event
+    mixer_ctl_set(ctl, CTL_VALUE_RAW | 10);
+    mixer_ctl_set(other, CTL_VALUE_RAW | 5);
+    EXPECT(ctl_value(ctl) == 5, "foreign change after rewrite not seen: %ld", ctl_value(ctl));
+    EXPECT(mixer_ctl_update(ctl, CTL_VALUE_RAW | 5) == 0, "held value written again");
+
+    // our change and another client's before we read the events: both
+    // come as a single event
+    EXPECT(mixer_ctl_update(ctl, CTL_VALUE_RAW | 10) == 1, "write skipped");
+    mixer_ctl_set(other, CTL_VALUE_RAW | 20);
+    EXPECT(ctl_value(ctl) == 20, "change merged with our own not seen: %ld", ctl_value(ctl));
+    EXPECT(mixer_ctl_update(ctl, CTL_VALUE_RAW | 10) == 1, "write after merged change skipped");
+    EXPECT(ctl_value(other) == 10, "control holds %ld, not 10", ctl_value(other));
+
+    mixer_close(ours);
+    mixer_close(theirs);
+}
+
+static AudioStreamOut *open_output(AudioHardwareInterface *hw, uint32_t device)
+{
+    int format = AudioSystem::PCM_16_BIT;
+    uint32_t channels = AudioSystem::CHANNEL_OUT_STEREO;
+    uint32_t rate = 44100;
+    status_t status;
+
+    AudioStreamOut *out = hw->openOutputStream(device, &format, &channels, &rate, &status);
+    EXPECT(out != NULL, "cannot open output: %d", status);
+    return out;
+}
+
+#define RENDER_WRITES 40
+// pause in the writes, shorter than the buffered audio
+#define RENDER_PAUSE_MS 20
+
+// writes a buffer of silence, which applies any pending route change
+static bool write_output(AudioStreamOut *out)
+{
+    const size_t bytes = out->bufferSize();
+    int16_t *buffer = new int16_t[bytes / sizeof(int16_t)];
+    memset(buffer, 0, bytes);
+    bool ok = out->write(buffer, bytes) == (ssize_t)bytes;
+    delete[] buffer;
+    EXPECT(ok, "write failed");
+    return ok;
+}
+
+struct DumpReader {
+    int fd;
+    String8 text;
+};
+
+static void *read_dump(void *arg)
+{
+    DumpReader *reader = (DumpReader *)arg;
+    char buffer[1024];
+    ssize_t count;
+
+    while ((count = read(reader->fd, buffer, sizeof(buffer))) > 0) {
+        reader->text.append(buffer, count);
+    }
+    return NULL;
+}
+
+// the dump of the HAL, read while it is written so that it cannot fill the pipe
+static String8 dump_hw(AudioHardwareInterface *hw)
+{
+    DumpReader reader;
+    pthread_t thread;
+    int fds[2];
+
+    if (pipe(fds) != 0) {
+        EXPECT(false, "cannot create the dump pipe");
+        return reader.text;
+    }
+    reader.fd = fds[0];
+    pthread_create(&thread, NULL, read_dump, &reader);
+    hw->dumpState(fds[1], Vector<String16>());
+    close(fds[1]);
+    pthread_join(thread, NULL);
+    close(fds[0]);
+    return reader.text;
+}
+
+struct RouteCounts {
+    unsigned writes;
+    unsigned skips;
+};
+
+static RouteCounts route_counts(AudioHardwareInterface *hw)
+{
+    RouteCounts counts = { 0, 0 };
+    String8 dump = dump_hw(hw);
+    const char *line = strstr(dump.string(), "Route control writes:");
+
+    EXPECT(line != NULL && sscanf(line, "Route control writes: %u, skipped: %u",
+                                  &counts.writes, &counts.skips) == 2,
+           "no route control counts in the dump");
+    return counts;
+}
+
+static void switch_output(AudioHardwareInterface *hw, AudioStreamOut *out, uint32_t device)
+{
+    AudioParameter param;
+    param.addInt(String8(AudioParameter::keyRouting), device);
+    EXPECT(out->setParameters(param.toString()) == NO_ERROR, "cannot route to 0x%x", device);
+    write_output(out);
+}
+
+/*
+ * Switches of a playing output between the speaker and the headset. The two
+ * routes share the DAC mixer switches and the master volume is left to
+ * applyMasterVolume_l(): a switch turns one output switch off and the other
+ * on, and skips the 4 mixer switches already on.
+ */
+static void test_route_plan(AudioHardwareInterface *hw)
+{
+    AudioStreamOut *out = open_output(hw, AudioSystem::DEVICE_OUT_SPEAKER);
+    if (out == NULL || !write_output(out)) {
+        return;
+    }
+    struct mixer *theirs = mixer_open();
+    struct mixer_ctl *dacl = theirs ? mixer_get_control(theirs, "LOUT Mixer DACL", 0) : NULL;
+    EXPECT(dacl != NULL, "no LOUT Mixer DACL control");
+
+    RouteCounts before = route_counts(hw);
+    switch_output(hw, out, AudioSystem::DEVICE_OUT_WIRED_HEADSET);
+    RouteCounts after = route_counts(hw);
+    EXPECT(after.writes - before.writes == 2 && after.skips - before.skips == 4,
+           "speaker to headset: %u writes, %u skipped, expected 2 and 4",
+           after.writes - before.writes, after.skips - before.skips);
+
+    before = after;
+    switch_output(hw, out, AudioSystem::DEVICE_OUT_SPEAKER);
+    after = route_counts(hw);
+    EXPECT(after.writes - before.writes == 2 && after.skips - before.skips == 4,
+           "headset to speaker: %u writes, %u skipped, expected 2 and 4",
+           after.writes - before.writes, after.skips - before.skips);
+
+    // no switch to the current route
+    before = after;
+    switch_output(hw, out, AudioSystem::DEVICE_OUT_SPEAKER);
+    after = route_counts(hw);
+    EXPECT(after.writes == before.writes && after.skips == before.skips,
+           "unchanged route: %u writes, %u skipped",
+           after.writes - before.writes, after.skips - before.skips);
+
+    // a shared switch turned off by another client is written again
+    if (dacl != NULL) {
+        mixer_ctl_set(dacl, 0);
+        before = after;
+        switch_output(hw, out, AudioSystem::DEVICE_OUT_WIRED_HEADSET);
+        after = route_counts(hw);
+        EXPECT(after.writes - before.writes == 3 && after.skips - before.skips == 3,
+               "switch after foreign change: %u writes, %u skipped, expected 3 and 3",
+               after.writes - before.writes, after.skips - before.skips);
+        EXPECT(ctl_value(dacl) == 1, "LOUT Mixer DACL left off");
+    }
+
+    if (theirs != NULL) {
+        mixer_close(theirs);
+    }
+    out->standby();
+    hw->closeOutputStream(out);
+}
+
+static void test_render_position(AudioHardwareInterface *hw)
+{
+    AudioStreamOut *out = open_output(hw, AudioSystem::DEVICE_OUT_SPEAKER);
+    if (out == NULL) {
+        return;
+    }
+    const uint32_t frames = out->bufferSize() / out->frameSize();
+    const uint32_t rate = out->sampleRate();
+    uint32_t position = 1;
+    uint32_t last = 0;
+    uint32_t written = 0;
+
+    EXPECT(out->getRenderPosition(&position) == NO_ERROR && position == 0,
+           "position %u in standby", position);
+
+    for (int i = 0; i < RENDER_WRITES && write_output(out); i++) {
+        written += frames;
+        EXPECT(out->getRenderPosition(&position) == NO_ERROR, "no render position");
+        EXPECT(position >= last, "position went back from %u to %u", last, position);
+        EXPECT(position <= written, "position %u past the %u frames written",
+               position, written);
+        // latency() is rounded down to the ms
+        uint32_t maxDelay = (out->latency() + 1) * rate / 1000;
+        EXPECT(written - position <= maxDelay,
+               "position %u trails %u frames written by more than %u", position,
+               written, maxDelay);
+        last = position;
+    }
+    EXPECT(written > last, "no frames in flight after %u written", written);
+
+    // the position moves on while the buffered frames play
+    usleep(RENDER_PAUSE_MS * 1000);
+    EXPECT(out->getRenderPosition(&position) == NO_ERROR && position > last &&
+           position <= written,
+           "position %u after a pause, was %u with %u written", position, last, written);
+
+    out->standby();
+    EXPECT(out->getRenderPosition(&position) == NO_ERROR && position == 0,
+           "position %u after standby", position);
+    hw->closeOutputStream(out);
+}
+
+int main(int argc, char **argv)
+{
+    // before anything opens the sound card
+    if (alsa_select_backend("sim") != 0) {
+        fprintf(stderr, "audio_hal_test: no simulated sound card\n");
+        return 1;
+    }
+
+    test_mixer_shadow();
+
+    AudioHardwareInterface *hw = createAudioHardware();
+    if (hw == NULL || hw->initCheck() != NO_ERROR) {
+        fprintf(stderr, "audio_hal_test: audio hardware init failed\n");
+        return 1;
+    }
+    test_route_plan(hw);
+    test_render_position(hw);
+    delete hw;
+
+    if (sFailures) {
+        fprintf(stderr, "audio_hal_test: %d failures\n", sFailures);
+        return 1;
+    }
+    printf("audio_hal_test: all tests passed\n");
+    return 0;
+}
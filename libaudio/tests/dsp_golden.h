@@ -0,0 +1,1052 @@
+// Generated by "audio_dsp_test --golden", do not edit.
+
+static const int16_t golden_mixer_2_1[] = {
+   -15376, -11237, -11281, -10737, -6710, -6592, -10390, -10554, -10756, -7675, -7096, -5696,
+   -3989, -5850, -9973, -9470, -8213, -5160, -986, -3485, -3997, -3440, -5984, -1203,
+   -1157, -2665, -300, -416, -2080, -3280, 2481, -94, 3156, -43, 3048, 1343,
+   7000, 5369, 2954, 7200, -280, 3506, 3163, 6926, 7357, 7136, 8668, 8178,
+   3704, 4594, 5615, 10923, 14717, 10713, 7457, 8954, 6132, 5707, 10354, 11109,
+   12137, 12663, 7117, 5486,
+};
+
+static const int16_t golden_mixer_1_2[] = {
+   -18137, -18137, -17302, -17302, -12141, -12141, -3917, -3917, -5475, -5475, -8205, -8205,
+   -8471, -8471, -8830, -8830, -9280, -9280, -10909, -10909, -4993, -4993, -6242, -6242,
+   -6310, -6310, -7539, -7539, -6617, -6617, -8689, -8689, -280, -280, -1611, -1611,
+   1645, 1645, -442, -442, -7868, -7868, -9753, -9753, -1113, -1113, 2129, 2129,
+   5961, 5961, 5195, 5195, 3206, 3206, 1155, 1155, 844, 844, -3439, -3439,
+   -909, -909, 3648, 3648, 2602, 2602, 2026, 2026, -258, -258, -3404, -3404,
+   3082, 3082, 8189, 8189, 6164, 6164, 11333, 11333, 4183, 4183, 3332, 3332,
+   454, 454, 4821, 4821, 12869, 12869, 9435, 9435, 10844, 10844, 9822, 9822,
+   10548, 10548, 6061, 6061, 11496, 11496, 8549, 8549, 12540, 12540, 15327, 15327,
+   9931, 9931, 11456, 11456, 2438, 2438, 11279, 11279, 8876, 8876, 12023, 12023,
+   9022, 9022, 6097, 6097, 1906, 1906, 3685, 3685,
+};
+
+static const int16_t golden_mixer_2_2[] = {
+   -3941, -32768, 1901, -32768, -2321, -32768, -4590, -22230, -3026, -28318, -1964, -15128,
+   -3572, -30345, -7274, -32768, -3158, -32768, -3078, -28299, 2032, -13137, -1872, -10402,
+   -3971, -21314, -3730, -19496, -2735, -18025, 594, -20081, -1844, -21003, 1899, -6473,
+   1027, -9566, -4362, -9287, 988, -7896, -3688, -7458, 1245, -13628, 5259, -10183,
+   7604, 1757, 5346, 6086, 1347, -4257, -1606, -7992, -5573, -6073, 2637, 1639,
+   4342, 12115, 2164, 3605, 7546, -1409, 4951, 10960, 1338, -3796, 1509, 8125,
+   1095, 8449, 7339, 12230, 1854, 15436, 10651, 17940, 9348, 8656, 6182, 5278,
+   3575, 5517, 783, 7733, 3517, 26817, 7197, 23307, 3362, 21167, 8393, 23773,
+   7941, 16372, 3101, 9039, 7339, 25341, 5233, 22663, 8177, 29919, 9682, 32361,
+   505, 22608, 6655, 19787, 2758, 12883, 6146, 20424, 4884, 20544, 2772, 32767,
+   -360, 26835, 1576, 19881, -4547, 21175, -674, 12987,
+};
+
+static const int16_t golden_mixer_4_2[] = {
+   -11437, -30840, -11886, -26208, -8568, -23662, -6829, -18827, -6970, -13485, -9410, -17118,
+   -6769, -13473, -10285, -21816, -9074, -19839, -5731, -20683, -5318, -15259, -7745, -17749,
+   -7284, -14921, -3309, -9753, -9904, -15077, -5331, -16200, -2522, -13648, -513, -12767,
+   -3968, -11128, -204, -6292, -2472, -7983, -1058, -9231, -3596, -10979, -2449, -8613,
+   199, -16884, -1030, -4389, -3377, -7837, -5905, -4000, -2327, -2514, -2595, -9839,
+   808, -5270, 5648, -4793, 5736, -8681, 3637, -7156, 1780, -1543, -1375, -172,
+   1353, 4920, 3582, -1823, 5815, 2816, 9101, -5681, 4028, -944, 1586, -3268,
+   1524, 3005, 4360, 6009, 1115, 8145, 3098, 825, 6115, 4934, 5711, 2812,
+   4908, 2358, 8066, 4540, 7043, 5030, 9068, 6608, 11522, 14704, 8163, 9251,
+   4512, 2844, 3173, 9120, 2374, 3232, 4107, 9108, 6610, 15023, 11246, 20119,
+   6620, 16390, 6412, 17447, 176, 14301, -100, 11724,
+};
+
+static const int16_t golden_mixer_2_1_loud[] = {
+   -32768, -32768, -25774, -27436, -29166, -25257, -32768, -32768, -32768, -26203, -21096, -17484,
+   -21346, -24117, -21210, -16480, -21216, -12033, -18756, -8244, -5989, -4612, -12886, -9069,
+   -8292, -5431, -9156, -3513, -4780, 23, 5264, -4957, -3663, -2292, 6402, 1068,
+   9578, 7811, 12326, 13535, 3635, 10752, 13470, 20637, 23673, 27186, 19542, 24567,
+   21741, 17214, 23919, 27555, 30990, 32767, 27645, 26439, 9006, 25533, 24708, 29472,
+   23385, 17778, 27726, 12705,
+};
+
+static const int16_t golden_downsampler_8000_1[] = {
+   7446, 7923, 9012, 7367, 8153, 4462, 2305, 1272, -1105, -4614, -5993, -4761,
+   -5404, -4176, -3089, -3891, -3366, -1284, 714, 2228, 2545, 1612, 1840, 902,
+   1100, 219, -580, 478, -1228, 836, 2982, 2292, 3189, 3890, 2093, 4539,
+   4499, 5156, 2953, 370, -2461, -4293, -5280, -5706, -7764, -6287, -8750, -5188,
+   -3845, -2489, 2230, 2908, 5139, 7325, 8566, 9780, 9433, 7360, 5310, 1588,
+   823, -2312, -4401, -7988, -9127, -10066, -10701, -8964, -6197, -4809, -297, 1288,
+   2977, 4708, 6952, 8163, 7816, 5696, 4519, 4492, 3032, 1158, -1074, -3667,
+   -4393, -2049, -3291, -2902, -1095, -1517, -2078, -616, 310, -541, -258, 206,
+   114, -1582, -618, -2450, -2045, -1519, -2102, 813, 3029, 3796, 4151, 4085,
+   4975, 5579, 5553, 5000, 2895, -888, -2293, -3511, -8321, -6497, -8244, -10187,
+   -8118, -5493, -3378, -1360, 739, 3363, 5975, 7568, 8732, 12140, 9105, 7237,
+   4989, 3459, 1075, -2877, -3717, -5887, -9110, -8935, -7489, -6493, -7166, -4803,
+   -3011, -365, 2923, 4156, 5206, 3442, 3300, 4505, 3059, 2706, 3359, 1370,
+   -868, -1856, -556, -747, -2031, 160, -1443, -601, 649, 1905, -727, -2470,
+   -2610, -2454, -3053, -3104, -4038, -4639, -5987, -4358, -1022, 1326, 3973, 4911,
+   5968, 6090, 5776, 7469, 8189, 4361, 3091, -77, -1489, -4686, -6893, -7950,
+   -8970, -10613, -7830, -6413, -4385, -3716, 336, 3261, 4975, 6372, 9579, 9814,
+   8313, 7836, 4579, 2774, 1210, -1609, -3305, -5679, -6534, -7063, -6324, -4218,
+   -5823, -4224, -1625, 243, 2331, 2950, 2436, 3451, 2408, 2672, 2088, 1062,
+   1082, 1307, 2044, -543, 520, 636, -121, 1342, 1329, 2723, 3128, 1618,
+   44, -1610, -4323, -3851, -4408, -5174, -5383, -6892, -6179, -4883, -246, 1329,
+   2916, 7203, 7676, 9349, 8043, 9585, 7236, 5357, 1859, -497, -1659, -3503,
+   -5944, -9184, -9932, -12425, -8898, -7559, -4959, -2847, 422, 1819, 2988, 7399,
+   8036, 7783, 7074, 6057, 5621, 3905, 1178, -1834, -3893, -5626, -5261, -4835,
+   -4349, -3026, -2555, -3870, -2201, 627, 916, 1469, 15, 600, 537, 369,
+   188, -1628, -1044, -1070, 1185, 1562, 1570, 2515, 1764, 3631, 4254, 4678,
+   4418, 2665, 432, -1003, -4939, -6332, -7499, -7744, -6520, -6993, -6596, -3887,
+   -2483, 493, 2265, 5392, 6577, 9176, 10861, 9081, 7702, 5949, 3445, 1948,
+   -1281, -5570, -7099, -7890, -10036, -8865, -7523, -6906, -4768, -2622, 525, 3894,
+   5443, 7032, 5637, 5606, 4650, 4174, 4568, 2858, 2287, -1474, -3319, -2389,
+   -2580, -2108, -1345, -1288, -1589, -2144, -1606, -1000, -808, -1053, -176, -1858,
+   -2575, -1403, -2837, -2852, -2571, 813, -217, 1896, 5197, 4404,
+};
+
+static const int16_t golden_downsampler_8000_2[] = {
+   11243, 3649, 10070, 5776, 9579, 8445, 5402, 9331, 3940, 12365, -335, 9258,
+   -2342, 6952, -2852, 5396, -8233, 6022, -10262, 1034, -10722, -1264, -9335, -187,
+   -7588, -3221, -4100, -4252, 78, -6256, 2660, -10442, 4347, -11080, 8901, -11471,
+   10404, -8977, 11847, -7392, 9694, -4605, 7903, -4680, 4567, -888, 628, 1175,
+   -871, 3071, -4380, 4818, -6722, 5562, -8630, 9585, -12455, 10000, -11295, 12968,
+   -6362, 12326, -4970, 9553, -1140, 7518, 1682, 6097, 1915, 2272, 8114, 964,
+   7917, 1080, 11687, -1375, 11146, -5239, 7864, -7124, 4642, -9564, 1929, -10516,
+   419, -10979, -1891, -9521, -7112, -8416, -7011, -5563, -11801, -5699, -10036, -341,
+   -8041, 350, -6323, 1345, -454, 4914, -549, 6364, 1906, 8371, 3500, 11149,
+   6844, 10287, 9691, 9868, 10546, 8320, 8530, 6188, 6216, 4403, 582, 2593,
+   -209, 1854, -3160, -1465, -5677, -3125, -9649, -6327, -12391, -5864, -11214, -8919,
+   -8191, -13212, -6916, -11014, -3434, -8961, -1302, -8317, 3253, -3847, 5292, -2717,
+   8758, -2805, 8514, 902, 11404, 2499, 11395, 4930, 8289, 7343, 4048, 7343,
+   454, 8583, -336, 9320, -4425, 10488, -7542, 9856, -9244, 7096, -10787, 3452,
+   -10003, 1216, -6191, 2092, -5191, -1393, -4049, -1755, 3706, -5896, 3498, -6532,
+   4987, -9144, 11163, -12396, 11224, -10603, 8959, -10041, 5668, -6183, 5146, -4734,
+   3427, -3200, -1247, -1917, -2382, 1145, -7227, 2326, -8495, 4404, -9404, 6365,
+   -11624, 7419, -8215, 9841, -4329, 10386, -3753, 11344, -1054, 9355, 1384, 6785,
+   4545, 5405, 8652, 2506, 9889, 1216, 11274, -1275, 9375, -3585, 4272, -6049,
+   3525, -8112, 1560, -8583, -5689, -10953, -4227, -8767, -7502, -8987, -12611, -7764,
+   -11516, -4720, -7374, -3613, -6039, -717, -2830, 110, -237, 1714, 2010, 4715,
+   5382, 6568, 6054, 9082, 8064, 9399, 13314, 10965, 8144, 10064, 6193, 8281,
+   4093, 5886, 2281, 4636, -725, 2874, -5143, -613, -7773, 339, -9245, -2530,
+   -13486, -4735, -8767, -9104, -6368, -8611, -3823, -9164, -3316, -11017, -285, -9321,
+   1633, -7655, 5558, -6289, 9411, -3566, 9225, -912, 10255, 156, 5730, 1154,
+   4553, 2046, 3633, 5377, -1352, 7469, -4051, 9462, -4997, 11714, -6950, 9689,
+   -11706, 9970, -10369, 6657, -6728, 5615, -4351, 2857, -3877, -187, 1142, -823,
+   1234, -4120, 2372, -3574, 8498, -7200, 11275, -7466, 9124, -10579, 7166, -12107,
+   5579, -10799, 1373, -6282, -1068, -5039, -2700, -3507, -3673, -4404, -8696, -583,
+   -11303, -671, -11498, 2782, -8312, 6269, -5815, 8467, -3385, 11332, -1300, 11122,
+   1693, 10242, 3237, 8943, 5540, 6012, 9796, 5142, 11734, 4644, 9323, -601,
+   6452, -271, 2092, -2247, 1769, -4749, -1101, -8272, -4861, -8926, -5536, -10364,
+   -9019, -8922, -11608, -9617, -9053, -6608, -6562, -6264, -4736, -4035, -3581, -3851,
+   973, -301, 3632, 2890, 7373, 2577, 7388, 5356, 10479, 8678, 10201, 9426,
+   6977, 9649, 5075, 10598, 1687, 7471, -995, 6542, -3632, 6052, -5415, 2196,
+   -7509, 899, -11690, 333, -10645, -2424, -9071, -5056, -6371, -6278, -2073, -6363,
+   -606, -11041, 2612, -11060, 5835, -9084, 7464, -6980, 11163, -6501, 9708, -3810,
+   8460, -3588, 6119, 782, 1792, 3023, 1117, 4226, -1938, 6113, -5468, 7590,
+   -8007, 10170, -9277, 11890, -8566, 12654, -8725, 7638, -5497, 6536, -2979, 4249,
+   -1712, 1469, 1343, 1341, 4727, -2069, 8304, -2858, 10164, -3908, 10316, -7081,
+   8307, -8219, 6813, -10033, 3100, -11747, 1389, -9093, -483, -8333, -3359, -6990,
+   -5789, -4977, -11249, -2536, -12918, 559, -11017, 1250, -5493, 5001, -3440, 6097,
+   -2236, 8068, 3878, 10528, 3757, 11595, 7209, 11488, 7724, 8362, 11849, 7320,
+   8736, 5734, 6228, 4485, 2297, 1421, 325, -1320, -1292, -2027, -2148, -4858,
+   -4604, -7284, -9791, -8577, -9799, -10066, -11935, -12916, -9136, -8661, -5891, -9227,
+   -2718, -7200, -1341, -4353, 1356, -511, 3817, -179, 6479, -503, 10741, 4057,
+   10645, 5427, 8579, 6987, 5680, 8467, 914, 11199, 186, 11056, -1609, 9420,
+   -5467, 7823, -9091, 5423, -11758, 3971, -12498, 1245, -8351, -2172, -6915, -2756,
+   -3502, -5196, 976, -7029, 2615, -7726, 4497, -12237, 6683, -11085, 10377, -9123,
+   10509, -8678, 9109, -6171, 5744, -5714, 2836, -1636, 2627, -1554, -1910, 2649,
+   -4058, 4433, -7630, 4374, -10011, 7923, -11612, 9472, -9818, 12188, -7336, 10460,
+   -4805, 7944, -1469, 6499, -1023, 4551, 3132, 4129, 6062, 2445, 9919, -562,
+   11562, -2727, 10664, -5334, 7831, -6968, 5400, -7406, 1300, -11179, -877, -11787,
+   -3677, -11322, -5525, -9963, -7035, -6005, -10750, -3236, -11557, -1636, -8304, 530,
+   -5500, 534, -2099, 3085, 320, 4210, 2893, 7889, 5612, 7542, 8067, 10284,
+   10934, 10787, 9671, 8489, 7437, 7966, 5211, 6686, 2323, 4567, 1316, 2580,
+   -1039, -1524, -5592, -5549, -7541, -6659, -10826, -4956, -10792, -9279, -7431, -10299,
+   -5887, -9160, -2613, -11199, -2032, -7503, 1525, -6771, 5668, -4619, 9951, -2164,
+   11036, -151, 11130, 2934, 8174, 3100, 5398, 5813, 3049, 6250, 735, 7612,
+   -1407, 10544, -3904, 9619, -6486, 11060, -9183, 6236, -10963, 4324, -7779, 3002,
+   -5764, 604, -4665, 449, -808, -1883, 1291, -3867, 4307, -7485, 4666, -8955,
+   7315, -10527, 11673, -13674, 7688, -9304, 5827, -7933, 6247, -6599, 650, -4368,
+   -1149, -4000, -3477, 670, -7557, 1883, -8055, 2350, -11792, 6650, -7959, 9584,
+   -7667, 7231, -6495, 10287, -1590, 11983, 1127, 7681,
+};
+
+static const int16_t golden_downsampler_8000_1_nomix[] = {
+   9576, 10840, 6534, 6057, 3548, 1714, -2164, -4183, -6738, -10251, -12467, -10048,
+   -4780, -2947, -1837, 551, 5539, 7581, 8586, 10428, 8741, 5868, 4278, 1258,
+   745, -5254, -6499, -8952, -13498, -9716, -7155, -3529, -3022, 150, 4205, 5272,
+   9931, 13193, 9138, 7593, 4482, 2988, -464, -1716, -4868, -7792, -11738, -10104,
+   -6625, -6245, -1623, -189, 2416, 6279, 7555, 9960, 12502, 8065, 5852, 3454,
+   -565, -2171, -4370, -6700, -9021, -13608, -8579, -6048, -2344, 768, 1939, 4701,
+   8107, 10235, 12853, 10912, 5175, 3691, 1559, 241, -2848, -5638, -9004, -9522,
+   -8479, -7895, -3466, -1926, 1098, 2732, 5540, 9086, 12299, 10989, 5848, 7022,
+   852, -3149, -2136, -4963, -9508, -12765, -11420, -5425, -4882, -3132, -1807, 1826,
+   7878, 8088, 10618, 11258, 7900, 5366, 2354, 69, -2144, -7064, -8317, -10586,
+   -11185, -9433, -6264, -2672, -995, 1928, 3528, 5129, 10355, 11557, 8534, 6684,
+   1589, 2459, -3209, -6784, -7156, -9566, -10828, -10790, -6019, -6638, -1220, 81,
+   4236, 6038, 8336, 10592, 10904, 8858, 6585, 2287, -572, -2414, -5936, -9267,
+   -11517, -9396, -7006, -3208, -1766, 2448, 3102, 3452, 7859, 10210, 8603, 8795,
+   4299, 3510, -740, -1192, -4471, -7854, -10116, -11303, -9364, -7733, -1633, -186,
+   2307, 3469, 6243, 9331, 13173, 9699, 6432, 3446, 1696, -3141, -3700, -6396,
+   -7888, -12534, -10101, -7558, -4917, -1719, 1579, 3997, 7881, 8976, 10976, 9896,
+   7251, 4927, 3012, -2331, -4501, -3865, -8775, -9356, -11584, -8672, -4613, -3357,
+   500, 2465, 5030, 8525, 9643, 11522, 7622, 4651, 2583, 45, -1012, -5460,
+   -8059, -10486, -10612, -8650, -5992, -2366, -1918, 1562, 1863, 8486, 11380, 10260,
+   8155, 3977, 4986, 2729, -657, -4283, -8694, -10559, -11364, -9027, -6006, -4112,
+   240, 487, 4386, 6839, 8797, 11895, 9455, 7762, 5546, 3004, -1699, -2877,
+   -5885, -10839, -10757, -9250, -7547, -6412, -3399, 1440, 2270, 5317, 7590, 12867,
+   10650, 7826, 4798, 1354, -691, -2501, -3361, -8401, -11684, -11921, -8203, -6972,
+   -4181, 969, 2957, 5305, 6949, 9346, 10914, 7779, 5540, 2370, 93, -2082,
+   -4426, -6133, -10054, -13286, -7863, -7084, -5011, -2719, -4, 3341, 5975, 10141,
+   11544, 7833, 7129, 3806, 1840, 13, -3120, -5889, -8819, -10349, -10031, -7920,
+   -3765, -1094, 679, 3510, 4412, 7165, 10604, 11830, 7482, 2800, 1149, -32,
+   -2577, -5080, -7756, -9239, -11146, -9986, -6797, -2914, -1478, 1174, 4400, 7805,
+   9319, 11404, 7883, 6772, 3130, -620, -1898, -6179, -7779, -12352, -11877, -10294,
+   -6540, -2170, -2832, 2552, 5368, 6452, 9224, 11007, 9035, 6940, 3486, 1138,
+   -1271, -5430, -6387, -8034, -10468, -9438, -7004, -6058, -1953, 988,
+};
+
+static const int16_t golden_downsampler_11025_1[] = {
+   46, 4257, 3765, 7162, 6966, 8173, 8148, 9729, 5866, 9678, 5766, 4540,
+   2074, 1874, 578, -1140, -4386, -5036, -6911, -3244, -6871, -3521, -5478, -1629,
+   -4740, -3141, -3713, -1661, -260, 1361, 1512, 3697, 955, 2661, 950, 2165,
+   -97, 2157, -523, 614, -1336, 1262, -1145, -736, 848, 3634, 1597, 3504,
+   2004, 5164, 1991, 3018, 3505, 5867, 3323, 6288, 2757, 1846, -750, -1701,
+   -5154, -3334, -6722, -4602, -7619, -7420, -6311, -7923, -8616, -3106, -4459, -3438,
+   -238, 3004, 1814, 5392, 4731, 8294, 7916, 9344, 9717, 10016, 7171, 7521,
+   4111, 2525, 426, 908, -3280, -3237, -6426, -8400, -9267, -9282, -11072, -9959,
+   -10096, -6506, -6473, -4035, -2345, 2060, 270, 3812, 3420, 6043, 6492, 9013,
+   6967, 8710, 4354, 5785, 3598, 5100, 2677, 2211, 91, -818, -3903, -3626,
+   -4933, -953, -3683, -2761, -3527, 28, -2511, -595, -3011, -407, -256, 654,
+   -1273, 504, -1047, 1189, -525, -357, -2076, -144, -2129, -2742, -1837, -880,
+   -3229, -70, 183, 3670, 2855, 4682, 3223, 5169, 3305, 5952, 5276, 5552,
+   5379, 5454, 2149, 2420, -3249, -1233, -3203, -5618, -9024, -5946, -7698, -8757,
+   -10909, -7698, -7637, -3900, -4234, -1202, -1213, 2153, 1733, 6575, 5335, 8524,
+   7937, 10576, 12345, 9275, 6694, 7939, 3005, 4987, 1386, 324, -3404, -3423,
+   -4657, -6114, -10244, -7648, -10034, -5983, -7263, -6540, -7265, -3955, -4321, -880,
+   -810, 4062, 2648, 5574, 4626, 4016, 2785, 3919, 4230, 4021, 1820, 3795,
+   2394, 3400, -764, 192, -3026, -275, -1032, -248, -2292, -1008, 56, -753,
+   -2345, 1267, -396, 2531, 712, -1475, -2706, -1982, -3462, -1473, -3914, -2369,
+   -3873, -3560, -5085, -4636, -6743, -3815, -2520, 652, 772, 4896, 3397, 6271,
+   5267, 6626, 5500, 6322, 6754, 9265, 6126, 4618, 2699, 2160, -1629, -700,
+   -4306, -5807, -7264, -7635, -9017, -8869, -11732, -7150, -7802, -5259, -4888, -3440,
+   -3006, 1958, 2363, 4923, 5059, 6896, 8549, 11031, 8272, 9602, 6730, 8041,
+   2922, 3545, 1818, 217, -1750, -2799, -4915, -5337, -7698, -5332, -8758, -4512,
+   -5390, -4139, -6832, -2960, -3194, 228, 111, 2496, 2934, 2922, 1682, 4802,
+   1257, 3889, 1420, 3274, 886, 1421, 705, 1580, 1092, 2820, -1201, 464,
+   289, 1159, -700, 1067, 813, 2160, 1024, 4277, 2125, 2553, 276, 104,
+   -2218, -2798, -5750, -2253, -5727, -3779, -6242, -4531, -7449, -6095, -6630, -3998,
+   -2962, 2458, 165, 3149, 5482, 7862, 7447, 9361, 8743, 8065, 9457, 8884,
+   5198, 6269, 1351, 880, -1432, -1076, -3754, -3889, -7077, -8956, -9694, -10622,
+   -13071, -8742, -8425, -6516, -5659, -2209, -2890, 2421, 655, 2951, 3918, 8322,
+   7559, 8358, 7077, 7896, 5222, 6950, 4526, 4806, 1734, 627, -2807, -2538,
+   -6056, -4644, -6299, -3913, -5632, -3349, -3916, -1830, -3484, -3466, -3311, 79,
+   125, 1871, 168, 2422, -1469, 1544, 1, 1041, -473, 1511, -1906, -759,
+   -1785, -498, -1100, 2218, 859, 2181, 899, 3829, 345, 3864, 2659, 5443,
+   3331, 5876, 3248, 3975, 521, 679, -1549, -3294, -6820, -5432, -8445, -6928,
+   -8234, -5561, -7690, -6326, -6778, -3072, -3632, -742, 455, 2554, 3521, 6770,
+   6102, 8756, 10448, 10897, 8435, 9073, 5984, 6497, 3136, 2742, 1159, -1403,
+   -5096, -6163, -7950, -6831, -10499, -9224, -8984, -7519, -7189, -6442, -4861, -2641,
+   -2069, 2200, 2903, 5778, 5286, 8006, 4936, 6176, 5018, 5007, 3727, 4907,
+   3923, 3518, 1835, 2182, -2689, -2727, -3276, -1697, -3559, -1029, -3181, 152,
+   -2538, -307, -2945, -846, -3319, 447, -2494, 506, -2049, 41, -881, -796,
+   -3610, -1387, -1768, -2420, -3174, -2352, -3589, 1038, -181, 597, 402, 5310,
+   4230, 5230, 5193, 7403, 3589, 5848, 6116,
+};
+
+static const int16_t golden_downsampler_11025_2[] = {
+   2659, -2568, 5713, 2801, 7954, -424, 10169, 4155, 11171, 2760, 10627, 5718,
+   9241, 7054, 9711, 9748, 4567, 7165, 4629, 14726, 2769, 8763, -1804, 10884,
+   -1478, 5625, -3071, 6817, -3390, 4546, -9590, 7309, -9370, 597, -10793, 721,
+   -11000, -2823, -8359, 1871, -9539, -4205, -4913, -2130, -4792, -6165, 733, -3992,
+   1138, -10618, 3435, -9717, 4597, -12024, 7406, -10729, 10906, -11427, 9865, -7144,
+   12150, -9126, 11040, -3647, 7936, -6028, 8397, -3076, 4877, -2977, 1943, 2386,
+   3, -198, -492, 4805, -4233, 3185, -4987, 6213, -7627, 4955, -8146, 10670,
+   -11190, 8898, -13242, 11769, -10402, 12097, -7104, 14372, -5426, 8620, -3993, 11000,
+   -1660, 5667, 2349, 7979, 538, 3444, 3295, 2742, 7534, -525, 8631, 3103,
+   8140, -1494, 12460, 116, 11724, -6210, 8832, -5140, 7413, -8914, 4725, -8128,
+   1923, -12231, 1886, -8554, -104, -13341, -1963, -7241, -4207, -11031, -8996, -5845,
+   -6040, -6582, -10915, -4932, -12811, -4422, -8188, 1976, -7957, -963, -8481, 1605,
+   -2535, 2060, -258, 6265, -1431, 5058, 2044, 8741, 1617, 7845, 3649, 12937,
+   6908, 8923, 7216, 11472, 11179, 8254, 10151, 9881, 9076, 5265, 8103, 6939,
+   5429, 2793, 1108, 3941, -229, 1081, -616, 2433, -3318, -3242, -5432, -1043,
+   -6730, -6122, -11308, -5492, -11715, -6820, -12380, -6185, -9725, -12420, -8165, -11753,
+   -6824, -13370, -5628, -7384, -1982, -10965, -1700, -6369, 2094, -6784, 4961, -840,
+   5274, -4735, 8785, -1162, 9029, -2190, 8730, 3357, 11469, 1514, 13011, 5015,
+   7831, 6103, 9082, 8337, 2986, 5721, 1080, 10489, 780, 6415, -1721, 11921,
+   -3045, 8399, -7521, 11943, -7747, 7928, -9224, 7589, -11321, 3514, -9774, 2521,
+   -10093, 227, -5715, 3808, -5030, -2335, -5639, 115, -3086, -3969, 3451, -3394,
+   4042, -9065, 3272, -4463, 5312, -11335, 10091, -10906, 12182, -12695, 10429, -9123,
+   9193, -11739, 6621, -5613, 4822, -6916, 5421, -3045, 3774, -4824, 464, -1178,
+   -1884, -2269, -2490, 2203, -5802, 1543, -9138, 3652, -7734, 4060, -9734, 7974,
+   -11097, 4640, -11015, 10875, -7421, 7787, -4812, 12152, -3769, 9478, -3190, 12554,
+   -1425, 7871, 1695, 8642, 1954, 4656, 5268, 6635, 9812, 739, 7510, 3593,
+   12346, -1587, 10338, 570, 9770, -5472, 7594, -2755, 2020, -8518, 4562, -7027,
+   2504, -8910, -2029, -9207, -6239, -11809, -4209, -7683, -5319, -10078, -10113, -7401,
+   -12490, -9329, -12338, -3058, -9054, -6220, -6765, -1036, -5973, -2496, -4141, 1738,
+   -1232, -1195, 363, 3943, 757, 2709, 5520, 7629, 4899, 5770, 6397, 10651,
+   7683, 8190, 10025, 11128, 14816, 9874, 6610, 11940, 7029, 6358, 5924, 9954,
+   2668, 3343, 3770, 6203, -253, 3024, -1842, 2490, -4760, -2048, -8839, 1992,
+   -6711, -2603, -10947, -1281, -13915, -6573, -9636, -5660, -8227, -11842, -5557, -6409,
+   -4247, -10280, -3494, -9587, -2714, -11816, -88, -7822, 1202, -9845, 3067, -4828,
+   6604, -8226, 9574, -1450, 8949, -3653, 9913, 1235, 10047, -796, 6500, 1530,
+   4214, 1356, 4906, 2931, 3530, 4930, -197, 8239, -2901, 6540, -4364, 11952,
+   -4936, 9723, -5783, 12582, -8794, 7266, -11872, 12255, -11253, 5201, -7867, 7317,
+   -6174, 4111, -4361, 3865, -3823, -762, -2724, 707, 2515, -2403, 1127, -2633,
+   820, -5511, 4857, -2324, 8694, -9485, 11024, -5962, 10930, -9507, 7937, -10887,
+   7407, -12820, 6329, -10294, 3806, -10731, 734, -3681, -679, -7149, -2352, -2387,
+   -2893, -4854, -3668, -3454, -7723, -2449, -10618, 1345, -11162, -2323, -12076, 4446,
+   -8993, 3953, -7226, 8530, -5736, 7280, -3157, 12947, -2773, 9567, -72, 12615,
+   1894, 8639, 2570, 10681, 4493, 6505, 6217, 6427, 9317, 4191, 12243, 6287,
+   10439, 1812, 9326, -91, 6998, -1599, 3538, 782, 1921, -5180, 1307, -2707,
+   668, -9281, -4001, -7614, -4595, -9933, -5652, -9619, -7520, -10515, -10335, -7403,
+   -11815, -11650, -9422, -4878, -7486, -8119, -6200, -4319, -4362, -5415, -4497, -2383,
+   -1461, -4552, 1486, 2430, 3685, 1040, 5508, 4337, 8674, 1444, 6435, 7356,
+   10452, 6645, 11133, 10928, 8744, 7800, 7923, 11280, 4643, 8816, 4468, 11613,
+   1074, 4769, -1585, 8675, -1059, 4694, -6103, 6537, -4248, 749, -7360, 1762,
+   -9823, -8, -11906, 1233, -10755, -4642, -9362, -1304, -8419, -9097, -5589, -3436,
+   -2569, -8212, -938, -7340, -41, -13624, 2922, -8843, 5352, -11740, 6429, -5973,
+   8346, -8124, 10882, -5890, 10936, -5070, 8569, -2725, 8318, -4955, 7257, 2346,
+   2504, 9, 1914, 5863, 998, 1841, -1304, 7851, -3305, 5076, -6393, 9235,
+   -7887, 9296, -8728, 11886, -9623, 11807, -8031, 13672, -9085, 6682, -7292, 8219,
+   -4336, 4913, -2910, 5227, -2486, 1084, 7, 2125, 1494, 132, 4855, -535,
+   6817, -4770, 9314, -759, 10458, -6208, 9935, -4829, 10057, -9505, 7096, -6889,
+   7336, -11772, 4149, -9746, 1457, -12958, 2068, -6574, -1152, -10301, -1514, -6043,
+   -4709, -7777, -5803, -3260, -10059, -4839, -13240, 1050, -12420, -840, -10841, 2843,
+   -7975, 2051, -2993, 7908, -3756, 4085, -3380, 9678, 2823, 8140, 3599, 12125,
+   3913, 10981, 6711, 12011, 7435, 10050, 8287, 7843, 11940, 6973, 10513, 7254,
+   6583, 3811, 6833, 5704, 2117, 585, 987, 771, 280, -3144, -2110, -43,
+   -1066, -6443, -3816, -3963, -4727, -9429, -10488, -7425, -9564, -9824, -10150, -11093,
+   -12751, -13392, -8944, -8540, -7805, -9045, -4361, -8672, -3331, -7988, -763, -3656,
+   -1373, -4407, 3000, 1842, 2858, -1549, 5766, 135, 7889, -54, 11044, 5599,
+   11097, 4021, 9241, 7473, 8073, 6080, 5895, 9896, 1564, 8880, 396, 13503,
+   297, 8754, -1896, 11508, -3190, 6657, -7507, 8761, -9134, 3520, -11011, 5935,
+   -13235, 1122, -11322, 2034, -8459, -4139, -7207, -620, -6014, -5251, -2339, -4359,
+   53, -7885, 2705, -6366, 3049, -10018, 3875, -10809, 7693, -14316, 6632, -6475,
+   12453, -12203, 9977, -6235, 9024, -8688, 9237, -4393, 4013, -6951, 3531, -443,
+   2826, -2823, 1594, 486, -2260, 1313, -3559, 6581, -5464, 1652, -8736, 7217,
+   -9472, 5901, -11643, 10646, -11045, 8845, -9784, 14219, -7161, 8878, -6550, 10912,
+   -3470, 5268, -1186, 8844, -1752, 2441, 1030, 6696, 3671, 1646, 6042, 4843,
+   8365, -1703, 11044, 709, 11815, -5319, 10309, -2360, 9991, -8951, 6498, -5140,
+   5361, -8459, 3138, -9728, -1228, -12413, -55, -10808, -4086, -12803, -5089, -8768,
+   -5466, -11001, -7756, -3366, -9724, -5656, -12168, -485, -10499, -3058, -8880, 2736,
+   -5610, -1655, -4532, 3046, -1624, 2533, 825, 4282, 645, 6396, 4934, 8606,
+   5421, 6783, 6972, 10540, 10835, 10059, 9965, 11828, 10529, 6341, 7498, 10648,
+   7014, 4953, 4259, 8734, 3293, 2980, 706, 4777, 1794, 524, -1961, -845,
+   -4300, -5892, -6858, -5468, -8452, -7449, -9820, -3843, -12653, -8346, -8436, -10012,
+   -7230, -10738, -7063, -7975, -2506, -11873, -3484, -9401, -1235, -8486, 184, -5467,
+   3523, -7662, 6766, -2366, 9549, -3743, 11265, 290, 10649, -78, 11647, 4365,
+   8130, 1741, 6726, 5625, 4899, 5136, 2366, 7648, 2235, 5218, -1139, 10951,
+   -1402, 9248, -3502, 10538, -6268, 9938, -6652, 11014, -9889, 4511, -11040, 5585,
+   -9277, 2726, -7105, 3711, -5786, -1334, -4904, 2846, -3656, -2706, 468, -165,
+   414, -5491, 3669, -4283, 4499, -10389, 4957, -6650, 5893, -12531, 10854, -9961,
+   10767, -15757, 8443, -7432, 4875, -8973, 7297, -7216, 4987, -6750, 1836, -3429,
+   -1417, -5803, -1394, -1380, -3158, -379, -8130, 3290, -6648, 300, -9330, 4626,
+   -11918, 4739, -9064, 11140, -7481, 7117, -7378, 8571, -7518, 8321, -3084, 13703,
+   -648, 9109, 909, 9552, 4523, 5863, 3970, 10836, 5123, 2054, 7062, 4633,
+   11370, 861,
+};
+
+static const int16_t golden_downsampler_11025_1_nomix[] = {
+   3241, 5762, 9671, 7703, 10046, 11706, 7616, 6616, 6099, 3837, 3470, 336,
+   -800, -4642, -4041, -7227, -9933, -10997, -13120, -9818, -6120, -3734, -2805, -1806,
+   -1028, 2266, 5767, 7251, 8210, 8525, 11127, 8926, 7901, 5608, 4039, 3409,
+   -170, 1545, -3881, -7260, -5741, -8964, -12697, -12783, -8822, -8176, -4471, -3438,
+   -2752, -1360, 2749, 4260, 5254, 7809, 11753, 13515, 9251, 8481, 6825, 4438,
+   3339, 1976, -1561, -891, -3930, -5822, -7974, -11299, -11611, -9193, -6151, -7245,
+   -3875, -1821, 754, -185, 4655, 6407, 6590, 9533, 9975, 12730, 10413, 5374,
+   6776, 3553, 611, -541, -3180, -2730, -6614, -6235, -9400, -12038, -13440, -7011,
+   -6762, -4379, -670, 456, 1674, 3145, 5151, 8203, 9217, 11506, 12683, 12082,
+   7209, 4468, 3727, 2115, 956, -329, -2071, -5369, -6075, -9656, -9696, -8594,
+   -8472, -8384, -3994, -3008, -1508, 1053, 1788, 3867, 5417, 8592, 10829, 12502,
+   11482, 6474, 6277, 6741, 2019, -2865, -2762, -1738, -4883, -6236, -11135, -12609,
+   -12059, -9849, -4248, -4992, -4628, -1881, -2157, 357, 5410, 8223, 7926, 9641,
+   11465, 10810, 8830, 5996, 4647, 2810, -446, 275, -3316, -7200, -7132, -9969,
+   -9937, -11858, -10112, -8868, -6207, -3506, -1983, -141, 769, 4180, 3203, 5068,
+   10597, 10069, 12640, 7338, 7912, 4877, 460, 3165, -333, -5452, -6696, -6693,
+   -8561, -10051, -10234, -12065, -8537, -5391, -7555, -3185, -342, -98, 3232, 5799,
+   5825, 8607, 9810, 10895, 11118, 8696, 8218, 5036, 2624, -532, -837, -3466,
+   -5088, -8798, -9634, -12318, -9211, -8522, -5879, -3224, -2123, -286, 3051, 3606,
+   1867, 6070, 6718, 11559, 8549, 8402, 10022, 4011, 4818, 2807, -726, -659,
+   -2227, -4523, -7331, -9165, -10303, -11759, -9659, -8744, -7903, -1138, -1229, 360,
+   3381, 1647, 6074, 6194, 8758, 13510, 11239, 10303, 5827, 5529, 2135, 2168,
+   -2146, -4311, -3185, -6704, -7412, -8636, -13968, -9865, -8671, -7241, -4309, -3238,
+   364, 1838, 3653, 6657, 8680, 8670, 11176, 10465, 9445, 7161, 5458, 4398,
+   2069, -1250, -5129, -3365, -4433, -7585, -9819, -9338, -11574, -10693, -5640, -5254,
+   -2946, -1566, 1539, 2872, 3470, 7980, 7983, 10268, 10650, 11169, 6488, 5163,
+   3630, 1495, 253, -838, -2647, -6307, -8344, -8842, -11840, -9984, -8800, -7956,
+   -4276, -2544, -2213, -367, 1908, 1691, 5279, 11179, 10798, 10557, 9754, 6564,
+   4305, 4136, 5307, 1180, 515, -3405, -5541, -8938, -10651, -10684, -11410, -9274,
+   -6007, -6210, -2799, -616, 1037, 574, 5360, 6070, 7683, 9810, 11408, 11217,
+   7889, 7548, 6766, 2661, 3257, -2856, -2795, -2884, -8135, -9853, -11702, -9871,
+   -9192, -7721, -6853, -5991, -3134, 280, 2422, 2270, 5199, 6818, 9218, 12948,
+   12463, 6988, 8898, 3892, 2056, 866, -1300, -2805, -2043, -5131, -9273, -10081,
+   -13836, -9875, -8945, -6947, -6145, -3630, 791, 2220, 3856, 5004, 7282, 7433,
+   10028, 11747, 7519, 8075, 4220, 3129, 985, -855, -1890, -4180, -5031, -7048,
+   -9239, -13675, -11412, -7172, -7270, -6269, -3950, -2964, -507, 1331, 4382, 5058,
+   9444, 10555, 12063, 7770, 7468, 6639, 3651, 2009, 1575, -945, -2500, -5174,
+   -6691, -9325, -9956, -10497, -9793, -7516, -5632, -1559, -1247, 406, 2769, 3945,
+   4039, 7292, 8139, 11788, 11988, 8518, 6034, 1558, 1763, 446, -945, -2278,
+   -5188, -5579, -9278, -8025, -11553, -10722, -9456, -7963, -3561, -2888, -1132, 377,
+   2628, 5180, 7723, 8762, 10067, 11862, 7851, 7339, 6117, 3021, -56, -1055,
+   -2577, -5755, -7659, -8460, -13416, -11883, -10834, -9942, -6411, -2813, -2189, -3149,
+   2987, 3994, 6214, 6381, 8470, 10993, 10247, 9636, 7043, 5976, 2954, 858,
+   691, -3176, -5723, -5646, -7723, -8244, -10211, -10963, -7309, -7402, -6356, -3427,
+   -1280, 1594, 1836, 4084, 5645, 8209, 10479,
+};
+
+static const int16_t golden_downsampler_16000_1[] = {
+   -4342, -1330, -1739, 1215, 1329, 5724, 3660, 4569, 9998, 5010, 8204, 9477,
+   6292, 11435, 7475, 4594, 11613, 6558, 5131, 5203, 2190, 2147, 1872, 774,
+   438, -2132, -2908, -5748, -4994, -6096, -7074, -654, -8677, -5301, -1390, -8155,
+   -1340, -1679, -6424, -2198, -4030, -3146, -2668, -269, -140, 727, 2531, 698,
+   4452, 2431, -529, 4493, 636, 432, 4287, -2162, 1997, 2669, -2017, 1844,
+   -794, -942, 425, 175, 924, -4118, 2169, 441, 1444, 6063, -747, 3288,
+   4932, -443, 6412, 4448, -473, 5151, 1965, 4416, 6410, 3393, 4363, 5820,
+   5147, 168, 2670, 309, -3087, -649, -5062, -5861, -1540, -7640, -6700, -2333,
+   -9983, -7216, -5988, -7691, -6128, -9692, -7935, -3342, -3454, -4550, -4101, -973,
+   531, 2668, 3407, 742, 7089, 4714, 4489, 10563, 6707, 8389, 10753, 7890,
+   11734, 8676, 7130, 8000, 6180, 4776, 2105, 2253, 552, -119, 921, -4527,
+   -4139, -1914, -9991, -6550, -8941, -11009, -6459, -13459, -8819, -10886, -10249, -8386,
+   -6970, -5531, -6473, -3533, -1646, -1822, 4043, -25, 347, 7159, 1104, 5541,
+   7658, 4762, 9799, 8450, 5799, 10008, 6059, 4197, 5455, 5495, 2632, 5450,
+   4333, 1519, 1951, 2430, -2749, 909, -3659, -5528, -983, -7825, -1257, -818,
+   -4670, -2239, -3223, -4027, -225, -1040, -1679, -2633, 654, -4262, -1515, 1876,
+   -2019, 1119, 870, -3503, 2614, -1382, -1165, 2421, -881, -296, -223, -2204,
+   -953, -983, -137, -4281, -2562, 54, -4392, 1727, -4333, -2941, 3606, -2887,
+   4082, 4683, 313, 7217, 2272, 3645, 5878, 3000, 4528, 4944, 6556, 4887,
+   4897, 6920, 3960, 6104, 3456, 662, 3309, -2012, -5160, 1713, -4432, -4766,
+   -4780, -11378, -5402, -6542, -7934, -7824, -10472, -9844, -9867, -6059, -7705, -5965,
+   -766, -6912, -266, 46, -3233, 4620, 655, 2453, 8055, 4710, 6427, 8770,
+   8438, 8013, 11372, 13121, 9849, 9210, 6777, 6734, 8171, 2668, 2667, 7325,
+   -1561, 1638, -129, -5941, -1160, -5352, -4540, -5138, -9689, -9556, -7870, -8830,
+   -9913, -5885, -5469, -9101, -5334, -6951, -7684, -1754, -5263, -3471, 1348, -2908,
+   2987, 4604, 1871, 4724, 6099, 4248, 4045, 3819, 2753, 3002, 5221, 3611,
+   3937, 3811, 456, 4677, 3348, 1048, 5295, -609, -1190, 1571, -3826, -1719,
+   54, -1068, -682, -456, -1670, -2758, -88, 722, -1875, 298, -3329, -121,
+   2830, -2371, 2707, 3153, -1483, 513, -3445, -2436, -1370, -3790, -2636, -1555,
+   -3081, -3655, -3055, -1795, -5750, -2803, -3817, -7573, -1654, -8969, -5116, -1482,
+   -5744, 2591, -657, 204, 5680, 3065, 4074, 5806, 5554, 6249, 4982, 7786,
+   4699, 5397, 8696, 4799, 10901, 7659, 3697, 6550, 1814, 2706, 2887, -2543,
+   -191, -1595, -3284, -5782, -6168, -6387, -8751, -7044, -8861, -10178, -7751, -13401,
+   -8320, -5068, -10216, -4164, -4888, -6020, -1670, -5000, -1553, 2366, 1449, 3737,
+   4399, 5560, 5177, 7035, 8609, 9121, 11419, 9144, 7028, 11565, 5485, 7344,
+   8716, 1433, 3354, 4348, 188, 2003, -1444, -1634, -2375, -4159, -4723, -5629,
+   -6179, -8101, -5223, -6483, -10056, -3189, -4423, -7262, -1411, -8417, -5252, -1739,
+   -4371, -1151, 747, -384, 1702, 2404, 3882, 1671, 3757, 1042, 3682, 5205,
+   191, 2568, 5770, -1785, 4985, 2472, -1149, 3670, -777, 1714, 1531, 688,
+   2279, 2209, 597, -1992, 644, 1843, -1651, 2856, -661, -1789, 3981, -1350,
+   2293, 3085, -1267, 5497, 3228, 1171, 4286, -189, 1639, -864, -455, -2252,
+   -3832, -2741, -7385, -1373, -3172, -8225, -1593, -5809, -7528, -2237, -8295, -7482,
+   -4382, -8627, -4014, -3923, -3892, 1436, 1957, 578, 1063, 4735, 6203, 5520,
+   10325, 5741, 9106, 10957, 6336, 9752, 7935, 9501, 10134, 4917, 5990, 6462,
+   2376, 1016, 426, -267, -2169, -1179, -2164, -6060, -2514, -6852, -10076, -6909,
+   -11471, -9563, -10519, -15545, -7292, -9750, -8292, -5852, -7471, -4453, -2405, -3268,
+   -1083, 460, 4282, -1598, 3534, 5284, 2176, 11219, 7137, 6336, 10911, 4786,
+   8749, 8013, 3769, 7772, 5929, 4399, 5457, 3177, 2821, -371, 578, -3266,
+   -3651, -1609, -8598, -3852, -4547, -8019, -2445, -5202, -6055, -2621, -3704, -4194,
+   -721, -3636, -3419, -3866, -2701, -2932, 1261, 228, -132, 3423, -929, 1392,
+   3341, -3386, 1170, 2366, -1732, 2139, 220, -1230, 2616, -794, -1877, -1021,
+   -1015, -1530, -1613, 1024, -2376, 3134, 2558, -1569, 4809, -101, 1225, 6164,
+   -1721, 2630, 5150, 669, 5924, 4916, 2495, 6258, 4439, 4077, 2657, 4074,
+   -89, -651, 2366, -4290, -2023, -4769, -8547, -4005, -7277, -9999, -4610, -9799,
+   -6742, -5172, -7852, -6890, -6771, -6067, -5959, -2477, -2396, -4852, 2501, -615,
+   685, 5562, 759, 7809, 6831, 4419, 10579, 7650, 11609, 11478, 8291, 9408,
+   8710, 7083, 6510, 4962, 6650, 496, 3101, 3517, -2648, 132, -4500, -7874,
+   -3424, -10604, -5785, -7210, -11659, -8539, -10322, -7596, -9214, -6730, -6274, -8884,
+   -3505, -5452, -4064, 292, -4173, 3097, 3733, 1222, 7966, 4415, 5597, 9396,
+   4552, 5576, 5943, 5801, 4359, 4850, 4828, 2563, 6252, 4067, 2164, 5055,
+   564, 2153, 2203, -4660, -2181, -2208, -4991, 256, -3858, -3559, 75, -3426,
+   -2430, 525, -1841, -2295, -335, -1357, -4152, 725, -3257, -3381, 2968, -3942,
+   -1391, 2516, -4491, 644, -57, -1835, 800, -3122, -2502, -3099, -494, -1457,
+   -3940, -909, -4052, -3280, -682, -5790, 2360, 1543, -2829, 3289, -1412, 2047,
+   6484, 3787, 4530, 5733, 4457, 7151, 6206, 5386, 2210, 7913, 6492, 4443,
+   10241, 1457,
+};
+
+static const int16_t golden_downsampler_16000_2[] = {
+   -905, -7780, 3308, -5968, -1178, -2300, 5555, -3125, 2461, 197, 6986, 4462,
+   9515, -2195, 6440, 2698, 14170, 5826, 8921, 1099, 11203, 5205, 11452, 7501,
+   6460, 6124, 12813, 10056, 5688, 9262, 3461, 5727, 6807, 16417, 1266, 11849,
+   3719, 6543, -2419, 12825, -2986, 7365, 516, 3776, -5065, 8808, -2473, 4021,
+   -4248, 5125, -12485, 8222, -7391, 1574, -10646, -850, -11590, 1601, -9461, -2732,
+   -12128, -2019, -5207, 3899, -12308, -5047, -5826, -4776, -3293, 513, -7394, -8917,
+   1228, -3909, 974, -4332, -494, -12356, 5856, -10253, 905, -8964, 6856, -13149,
+   6371, -11709, 8157, -8696, 13478, -13758, 7274, -5822, 12699, -7639, 11994, -10598,
+   10457, -1554, 10400, -5539, 5585, -6643, 10723, -1738, 4814, -3543, 3056, -2193,
+   4047, 4526, -3047, -1277, 2341, 1653, -597, 5935, -7058, 3025, 7, 3680,
+   -9494, 7906, -5441, 3555, -7702, 8552, -10713, 11063, -8026, 9873, -16146, 7910,
+   -10926, 15264, -9755, 10638, -10305, 13191, -3150, 15275, -7264, 5769, -4366, 10942,
+   -1309, 11173, -3473, 2587, 4103, 8721, 1401, 7495, -1566, 621, 6864, 3438,
+   1860, 2070, 11317, -2485, 8206, 4612, 5729, 1055, 12969, -4245, 9240, 2399,
+   14927, -4633, 9403, -9067, 7345, -2006, 10663, -10045, 2959, -9134, 5810, -7110,
+   2864, -12988, -1006, -10718, 4724, -7805, -1591, -13689, -1968, -11434, -424, -4242,
+   -6766, -13201, -5934, -8499, -9800, -2177, -5985, -9398, -7319, -4938, -16395, -2990,
+   -9456, -6416, -9750, 3065, -8268, 1359, -6231, -2871, -11226, 3024, -3443, 1496,
+   -1100, 2162, -2220, 7555, 2068, 4745, -4231, 5714, 4681, 9497, 1639, 7789,
+   132, 8844, 6755, 14370, 4147, 9266, 8406, 8372, 7893, 13612, 8727, 7052,
+   14479, 8988, 6896, 10456, 9742, 4518, 10260, 5740, 4708, 7651, 7839, 1712,
+   1163, 3046, -301, 4806, 1494, -390, -2650, 2411, 325, 1516, -4392, -4664,
+   -6344, -1936, -3362, -465, -10436, -9545, -8395, -4706, -13478, -4403, -12056, -9963,
+   -9807, -3111, -15357, -11562, -4164, -13475, -11210, -10562, -6746, -13752, -4575, -12198,
+   -8432, -5509, 235, -11297, -2862, -10084, -2511, -4556, 4390, -7682, 660, -4305,
+   7382, 703, 5234, -5284, 4709, -4016, 13441, 876, 5162, -2955, 10950, 131,
+   9052, 6264, 9985, -462, 16249, 3349, 8465, 8435, 7995, 3602, 10684, 9332,
+   3996, 8120, 5071, 3322, -2077, 12987, 3533, 7457, -184, 5449, -3529, 14428,
+   596, 8070, -6079, 9116, -8698, 12599, -4259, 9118, -12381, 6884, -6163, 7979,
+   -12057, 4738, -12561, 1504, -5757, 3791, -14931, -719, -4610, 2095, -5724, 4088,
+   -7262, -2078, -1555, -2923, -8875, 2428, -2170, -5885, 3083, -3534, 1201, -3281,
+   7642, -11000, 209, -5475, 5257, -3949, 6281, -14805, 6651, -9681, 15109, -11358,
+   9353, -13392, 11590, -9353, 10690, -8949, 6416, -13424, 9710, -4483, 2685, -5449,
+   5837, -8168, 6616, -1774, 1898, -3660, 5193, -5785, -672, 227, -2918, -1491,
+   916, -2822, -6223, 4256, -2210, 1936, -8997, 434, -10771, 5645, -3810, 3918,
+   -13188, 4403, -7208, 10660, -11245, 2579, -13960, 8078, -6156, 13368, -11037, 5263,
+   -2993, 11157, -4497, 13862, -5832, 6457, 421, 14013, -6288, 10831, 560, 6730,
+   2983, 8773, -1842, 7841, 6381, 2675, 1930, 7957, 9338, 3774, 11321, -1548,
+   3854, 5939, 14324, -485, 10420, -2500, 10329, 1878, 10984, -4072, 7633, -6310,
+   8490, -1871, 2279, -6304, 1248, -11568, 7750, -4325, -212, -8653, 2209, -11743,
+   -3263, -6298, -8735, -14021, -1236, -9568, -7668, -5416, -3056, -12813, -8836, -6812,
+   -13338, -7606, -9303, -10386, -16106, -3628, -8919, -3199, -8275, -7135, -9792, -2138,
+   -2440, 906, -8560, -5265, -4181, 3648, -45, 135, -4349, -2118, 4090, 5149,
+   -2185, 3495, 2507, 2399, 7392, 8716, 2379, 7042, 7977, 4878, 4556, 12984,
+   8270, 8605, 8999, 7027, 8783, 13962, 17593, 8648, 9360, 10338, 4893, 13527,
+   9280, 4273, 4271, 9196, 6583, 9759, 2681, 2655, 1430, 3903, 6292, 8357,
+   -3745, 622, 2, 3274, -2027, 1768, -8041, -3843, -4532, 2212, -11932, 1227,
+   -4779, -4301, -9018, -1258, -17295, -2085, -9480, -9633, -11645, -4096, -8883, -8777,
+   -5823, -14003, -7745, -4026, -2467, -8473, -5053, -13149, -3755, -6914, -1258, -12645,
+   -4252, -11117, 2692, -6200, -275, -10252, 1739, -8681, 5307, -2612, 3808, -9624,
+   11032, -5059, 8677, 531, 8006, -4264, 11815, -2367, 7542, 4654, 11956, -3460,
+   7123, 965, 4007, 3631, 6410, -904, 2208, 3794, 6461, 3979, 3166, 4055,
+   -2224, 10097, 1899, 5723, -6556, 7468, -3087, 12439, -3794, 10489, -7397, 9492,
+   -3269, 13858, -9376, 8157, -9842, 7462, -10696, 13836, -14339, 6687, -6979, 3541,
+   -9452, 9559, -6006, 3869, -4122, 2758, -6479, 5565, -884, -2457, -5870, 354,
+   -1625, 1447, 5423, -3980, -2354, -1396, 4185, -3588, -258, -6402, 1716, -1959,
+   9990, -4330, 5882, -10623, 12128, -6714, 11806, -5501, 8667, -11633, 11065, -10039,
+   4783, -11674, 8471, -13343, 7626, -10366, 2076, -9656, 5877, -11149, -827, -2283,
+   -743, -5419, 841, -8150, -5131, -979, -539, -3052, -4109, -7391, -4461, -1145,
+   -4639, -2995, -12896, -2252, -7318, 4010, -13677, -4262, -10954, 722, -10280, 7315,
+   -12975, 1487, -2767, 7950, -10200, 8886, -6127, 6533, 183, 11177, -8048, 14178,
+   947, 7200, -1658, 13270, -628, 11735, 5212, 7286, -1060, 11024, 5956, 9615,
+   4314, 5084, 4385, 6409, 10837, 6555, 7406, 2191, 13787, 8015, 11704, 3613,
+   7987, -595, 11619, 1481, 6072, -2445, 6219, -809, 3984, 1789, 174, -5262,
+   4000, -4381, -658, -2534, 1656, -8224, -788, -10776, -6848, -5488, -2184, -10591,
+   -6416, -11088, -6714, -7375, -4737, -12985, -13518, -6840, -7441, -8060, -13608, -13195,
+   -10955, -5685, -5694, -4442, -10449, -9984, -4224, -4104, -5915, -3862, -5350, -6690,
+   -1816, -1525, -6638, -3362, 2058, -5164, 1045, 3687, 929, 1968, 7387, 87,
+   2733, 6064, 9339, 1780, 8999, 1355, 3807, 10263, 12304, 4915, 9600, 8640,
+   11036, 11800, 10649, 7639, 5559, 8496, 10107, 13022, 3466, 7504, 3929, 10757,
+   5937, 11495, -1206, 4073, 657, 6051, -1994, 10689, -2077, 2451, -2202, 6207,
+   -9742, 6853, -1151, -2118, -7139, 2389, -10608, 2289, -7124, -2324, -14706, 3449,
+   -9844, -2514, -10410, -5793, -10861, 413, -6610, -6357, -9786, -10327, -4918, -1461,
+   -2282, -6565, -4426, -10098, 2614, -5438, -3778, -13057, 3214, -13718, 3221, -6699,
+   3196, -11938, 8654, -10956, 4747, -3253, 8075, -8843, 11821, -8418, 8260, -3451,
+   14017, -6253, 7304, -3963, 8564, -1050, 9871, -7787, 5070, 2294, 8651, 1759,
+   138, 244, 1815, 3321, 3769, 7771, -2347, -1223, 1954, 8015, -4002, 8945,
+   -4455, 2155, -3148, 10488, -11901, 10345, -4481, 7907, -9726, 12788, -11308, 12682,
+   -5945, 10502, -11086, 15505, -6841, 8034, -8999, 5015, -8921, 10209, -1034, 4718,
+   -7519, 4216, -302, 6013, -2411, 1088, -3992, 414, 4482, 3479, -2183, -517,
+   5328, -743, 6149, 21, 4291, -6825, 11955, -961, 7474, -1019, 10628, -8287,
+   12550, -3978, 5980, -6358, 13628, -10350, 5627, -7356, 6368, -7279, 9687, -14191,
+   1313, -8978, 4888, -10371, 76, -14847, 1634, -4380, 2517, -8862, -5169, -11281,
+   1685, -4871, -5347, -6271, -5782, -9275, -4081, -393, -11230, -5360, -10722, -4242,
+   -12816, 4052, -15191, -2063, -8145, 116, -12780, 4934, -8357, 572, -2500, 5372,
+   -5508, 9420, -1269, 2426, -5509, 7635, -1687, 11156, 4855, 7550, 1425, 9615,
+   5617, 15033, 2643, 8839, 6564, 11647, 8509, 13405, 4970, 7702, 11165, 8338,
+   7587, 8283, 13382, 5619, 12224, 8044, 4305, 5528, 9501, 2479, 5849, 7075,
+   2492, 2260, 3428, -1396, -1595, 2447, 2633, -3168, -1276, -3062, -4048, 1689,
+   2514, -6843, -5945, -6176, -2125, -2903, -4148, -9557, -10044, -10108, -8637, -5182,
+   -11830, -11111, -7994, -11133, -10820, -10219, -15684, -15408, -5818, -8767, -11460, -8041,
+   -7167, -9417, -2508, -9196, -7497, -7446, -25, -8881, -1864, -2946, -2359, -4177,
+   2088, -4255, -1338, 2258, 7794, 770, -198, -2997, 6381, 686, 9744, 824,
+   4967, -617, 14493, 7946, 10338, 3936, 8973, 3698, 12045, 9777, 4658, 4914,
+   10082, 7416, 4564, 11461, -195, 7732, 4274, 11269, -3081, 14938, 2014, 6782,
+   -244, 11158, -5205, 11558, 507, 5135, -9384, 8642, -7218, 8373, -8188, 1657,
+   -13387, 6085, -8732, 5513, -15752, -1444, -11498, 3794, -7867, -1228, -10899, -5138,
+   -4456, -434, -8637, -1766, -4673, -7438, -1406, -3838, -2471, -4938, 2603, -10991,
+   2262, -3704, 2225, -9497, 5316, -12155, 897, -8630, 10659, -16062, 5190, -11055,
+   6759, -4236, 14190, -13735, 9371, -9636, 10806, -3961, 8796, -10656, 8403, -5619,
+   10258, -3577, 1493, -8264, 4824, -2484, 3621, 1111, 983, -4448, 4715, -438,
+   -2062, 2502, -2448, -12, -1530, 6763, -7501, 5912, -2708, -1046, -10932, 8889,
+   -8659, 6630, -8395, 5334, -14707, 11480, -8184, 10232, -12506, 7754, -10483, 16751,
+   -4795, 9911, -10359, 7221, -4103, 13720, -4496, 4294, -3693, 6142, 1779, 10548,
+   -4901, 1458, 1344, 3915, 1980, 8319, 989, 349, 8816, 3031, 3645, 6187,
+   9204, -4214, 11841, 676, 8442, 437, 15312, -7157, 8041, -2728, 10798, -2651,
+   11635, -11813, 3466, -4768, 9444, -4712, 2972, -11552, 3337, -7384, 2843, -12381,
+   -4756, -12337, 2586, -10596, -2806, -11747, -6523, -13476, -2413, -6807, -7976, -11622,
+   -3855, -9629, -9346, -999, -9094, -6610, -9734, -4047, -14514, 973, -8506, -3628,
+   -10756, -1163, -9579, 4624, -2203, -2589, -9483, -222, -539, 5540, -2566, 1335,
+   -1516, 2886, 4237, 6888, -2778, 4296, 5740, 9878, 5774, 7888, 3541, 5298,
+   9117, 12041, 6114, 9186, 13121, 10095, 9612, 13343, 9068, 7512, 12243, 6572,
+   5996, 11424, 7206, 6959, 8321, 4699, 867, 9056, 7149, 6150, 402, 589,
+   -40, 6243, 4494, 2539, -2552, -2745, -461, 726, -4026, -4975, -7192, -8556,
+   -4526, -2323, -11369, -9839, -6763, -4807, -10989, -3432, -14651, -8667, -6789, -10290,
+   -11329, -9315, -3732, -11460, -9835, -8593, -5206, -8255, -182, -12365, -6417, -11352,
+   -593, -6418, -659, -10245, -3013, -5115, 6040, -5457, 590, -8935, 8187, -1993,
+   9166, -1701, 7702, -5259, 14645, 1286, 7894, 935, 11987, -794, 13236, 5555,
+   5657, 3446, 10938, 215, 4203, 7683, 5751, 5851, 5019, 3699, -345, 10045,
+   4838, 4818, -732, 5857, -2189, 14693, 802, 7333, -5106, 9434, -2437, 12548,
+   -6785, 7912, -7771, 12076, -4995, 9401, -12747, 3426, -9577, 5214, -10128, 5712,
+   -11439, 1457, -3337, 3848, -10499, 2782, -3252, -3867, -4423, 4573, -7282, 430,
+   586, -5446, -1765, 2814, 1130, -4812, 1935, -6526, 1552, -2222, 7662, -10377,
+   1722, -10028, 6224, -4774, 6404, -12919, 5375, -12137, 14223, -8287, 9618, -17504,
+   8826, -11609, 10668, -5637, 515, -9498, 10215, -8927, 5268, -5383, 4444, -8114,
+   5601, -4001, -3245, -2998, 2090, -7095, -4008, -2191, -1020, 32, -1827, -1087,
+   -11113, 3233, -4742, 2923, -7043, -1062, -11567, 5005, -6685, 5320, -15876, 4295,
+   -7452, 12173, -6542, 9627, -10495, 4837, -3879, 10456, -10374, 7550, -5394, 9488,
+   -1714, 14682, -3148, 10722, 2171, 6890, -12, 11478, 3702, 5211, 7005, 7296,
+   71, 12339, 8965, 1807, 3435, 984, 7989, 7837, 14509, -1525, 7406, 1479,
+   17135, 3346, 7004, -4090,
+};
+
+static const int16_t golden_downsampler_16000_1_nomix[] = {
+   -2718, 1620, -1286, 6605, 2107, 7503, 11851, 4822, 10985, 9201, 10658, 13175,
+   3603, 9213, 5687, 4701, 6574, 255, 5672, -448, -1968, 1339, -8199, -2065,
+   -5130, -8713, -7969, -11726, -11060, -11844, -14346, -6101, -7984, -4624, -1214, -6552,
+   2179, -4837, 18, 2803, 879, 9342, 4839, 8234, 9796, 5357, 13281, 9275,
+   8762, 9992, 4999, 7449, 3527, 3124, 5642, -2802, 2507, 1567, -5132, -3239,
+   -10025, -4351, -6352, -12952, -8890, -16906, -9612, -7961, -11105, -4058, -5424, -4231,
+   -1107, -4778, -401, 822, 2088, 6893, 1573, 8063, 7698, 8495, 16036, 10836,
+   11597, 8534, 6777, 10192, 2480, 5598, 4334, -25, 4374, -3699, -1025, 212,
+   -6374, -3465, -7578, -8174, -9838, -13496, -9571, -10995, -7326, -3850, -11431, -1290,
+   -5139, -3054, 3974, -3762, 2689, 2478, 4986, 8877, 3157, 10565, 9050, 8574,
+   13828, 10903, 11405, 7597, 3200, 9268, 3358, 2077, 2073, -2925, 1342, -5677,
+   -2008, -2989, -10089, -3024, -9385, -11092, -8785, -17957, -8284, -8093, -7246, -4313,
+   -6660, 1223, -1038, -534, 4780, -1602, 6190, 5142, 4270, 12529, 6308, 11522,
+   13417, 10088, 15552, 8194, 6948, 6140, 1689, 5697, 1341, 592, 3170, -3888,
+   2269, -4932, -6382, -2536, -11111, -7037, -11121, -9568, -6903, -10446, -7007, -8486,
+   -5166, -598, -5938, 994, -1032, 1470, 2984, 1425, 6001, 5738, 6028, 12438,
+   9732, 11343, 15869, 5820, 11354, 2218, 7886, 8759, -328, 3875, -4675, -4871,
+   2216, -6690, -552, -7516, -7562, -7276, -17271, -9030, -12215, -14245, -3660, -7437,
+   -3077, -4656, -6873, 1133, -4868, -600, 247, 857, 9283, 5593, 9472, 8467,
+   7364, 14391, 8924, 10972, 11743, 4187, 8375, 4152, 2605, 5152, -3773, 2585,
+   -786, -4510, -3188, -10661, -5031, -9053, -12368, -6789, -14358, -10169, -9109, -11455,
+   -4760, -7798, -3080, -1324, -4317, 3443, -2885, 3164, 5466, 593, 6525, 3542,
+   9636, 13034, 6837, 15379, 9582, 4756, 11432, 3123, 5737, -260, 658, 6312,
+   -4577, -1569, -7256, -8558, -2449, -11898, -6618, -8982, -13573, -6916, -13857, -11239,
+   -4508, -7817, -5515, -7246, -3419, 1483, -3034, 2505, 1313, 4950, 7186, 3689,
+   9058, 8816, 8404, 13240, 8089, 13508, 8452, 7108, 11219, 1854, 6586, 2015,
+   -3178, 3733, -5125, -1527, -3790, -8565, -5241, -13080, -8232, -11917, -13675, -3634,
+   -11663, -6721, -1189, -6739, 421, -2145, -134, 4568, 1892, 4911, 257, 5220,
+   7957, 4228, 13549, 9564, 7583, 9903, 7525, 11037, 4122, 2029, 8065, 0,
+   1562, -471, -3224, 2322, -6748, -3590, -5072, -11785, -6676, -10442, -13454, -7968,
+   -13761, -5433, -10504, -8528, -731, -2991, 759, -1430, 1582, 5593, -1548, 6180,
+   5794, 5131, 9393, 7510, 15638, 11691, 9539, 12775, 4499, 6195, 6956, -498,
+   5093, 552, -2486, -1029, -8046, 699, -7482, -7340, -5168, -11360, -6874, -16398,
+   -11568, -6015, -12059, -5186, -6551, -4954, -923, -4537, 3390, 1687, 420, 8407,
+   2775, 11160, 7914, 7179, 13716, 8702, 10495, 12292, 4021, 10699, 3416, 4767,
+   5718, -399, 2274, -3736, -6105, -1738, -5774, -2750, -7699, -9869, -7191, -13332,
+   -6290, -14081, -12004, -3971, -8537, -3655, -3047, -4936, 2235, -3025, 5032, 2882,
+   374, 9485, 5744, 8376, 10683, 7905, 13720, 8500, 11802, 6505, 3223, 7294,
+   2365, 610, 3969, -3620, 2384, -3046, -4008, -3229, -11901, -4733, -10838, -10864,
+   -10505, -11915, -6830, -9352, -9615, -651, -7813, 185, -1483, -4995, 4425, -768,
+   2130, 3816, 2235, 13322, 8944, 11833, 11003, 8805, 11533, 5495, 5452, 5704,
+   637, 8871, 2677, 332, 3650, -3619, -1580, -5193, -8193, -6531, -13814, -7965,
+   -11614, -12833, -7781, -11360, -4385, -5968, -7555, -20, -3681, 1329, 1612, -1402,
+   3874, 5499, 4938, 8695, 5614, 11843, 9512, 11233, 13626, 5779, 10125, 6544,
+   6399, 7771, -659, 5641, 891, -5680, 353, -5652, -1312, -8255, -10941, -7673,
+   -14255, -9398, -8869, -11370, -5205, -9642, -6091, -5008, -7292, -376, -921, 857,
+   4692, -533, 5938, 5606, 5075, 11335, 7529, 14777, 13678, 8060, 9087, 6378,
+   9099, 2295, 650, 4506, -2182, -732, -627, -6026, 1476, -6267, -6132, -8854,
+   -11659, -9128, -16382, -9610, -7542, -12013, -3155, -9533, -4626, -2334, -3778, 5018,
+   635, 2422, 7261, 1828, 9418, 6664, 6651, 11775, 9140, 12809, 7635, 5586,
+   11007, 751, 5047, 3012, -1605, 2941, -4477, -566, -3095, -7248, -2351, -8788,
+   -7983, -8514, -16865, -9773, -11239, -8265, -3425, -11591, -3166, -4638, -5236, -129,
+   -3114, 1789, 1916, 2825, 7381, 2852, 11796, 9908, 9335, 15693, 4866, 9795,
+   7044, 5389, 7858, 1176, 2267, 3468, -1369, 1662, -3730, -2825, -3870, -8862,
+   -5186, -10022, -12019, -6221, -14673, -7104, -9790, -7763, -3825, -5952, 1186, -1701,
+   -2064, 4026, 390, 4966, 4469, 1928, 9803, 5282, 9308, 12445, 10285, 13661,
+   7369, 6890, 6456, -1027, 3902, 41, 806, -54, -3128, 124, -7693, -3846,
+   -4902, -12776, -4378, -10840, -12099, -8564, -13610, -7010, -9182, -7943, -94, -6389,
+   -197, -339, -3061, 5983, -594, 6456, 7628, 6016, 11032, 7855, 11282, 12860,
+   7311, 8384, 7087, 5729, 6466, 210, 2325, -2064, -1532, -302, -7694, -3883,
+   -8644, -8994, -7513, -16482, -10961, -10867, -12544, -7642, -11090, -3724, -3455, -3108,
+   -466, -5683, 2030, 4823, 1119, 9202, 3933, 6549, 10142, 6550, 13510, 10296,
+   7716, 12782, 3727, 8562, 5105, 1307, 4117, -2112, 2398, -1864, -6593, -3057,
+   -8214, -4764, -8109, -9999, -6056, -13542, -9933, -7907, -8944, -4601, -9805, -3564,
+   -2926, -3990, 2854, -28, 1890, 4191, 2134, 8210, 4928, 9186, 12690, 7457,
+   15360, 10395,
+};
+
+static const int16_t golden_downsampler_22050_1[] = {
+   -6568, -7075, -7105, -2845, 49, -5052, -3222, -1426, -2110, -648, 1609, 447,
+   4338, 5239, 4693, 2050, 8518, 9682, 4840, 6691, 9216, 9470, 6424, 8245,
+   12202, 7717, 3452, 8179, 11584, 7456, 4625, 5569, 5545, 1879, 2749, 1725,
+   1802, 1756, -261, 984, -1991, -2993, -3004, -6129, -5597, -4405, -6959, -7831,
+   -1338, -2903, -9057, -7438, -288, -3984, -8018, -3627, 337, -2691, -6998, -3206,
+   -2382, -4169, -3611, -2416, -2767, 110, -2, -367, 1365, 2496, 1236, 1262,
+   4907, 3438, -187, 106, 5212, 1635, -297, 1059, 4219, 1121, -3132, 2688,
+   4226, -1608, -620, 1273, 677, -1546, -1049, 1163, -860, 1535, 208, -2845,
+   -2921, 4020, 248, -598, 4935, 5167, 373, -178, 5363, 4848, -140, 2040,
+   7230, 5410, -640, 1775, 5024, 3115, 1576, 6065, 6787, 2976, 4614, 3790,
+   6031, 6110, 3388, -406, 2647, 2151, -1129, -2733, -1811, -801, -6634, -6038,
+   -2346, -2925, -7673, -8508, -2602, -3942, -9458, -9627, -5099, -6218, -8822, -4953,
+   -8019, -9546, -8439, -6331, -2054, -3748, -4511, -4191, -4205, -1377, 276, 880,
+   2394, 4537, 980, 1548, 7055, 6333, 3235, 5391, 9642, 9669, 5719, 8068,
+   12098, 7809, 9110, 11166, 10603, 7348, 7214, 8155, 6940, 6188, 4164, 3521,
+   1361, 2007, 2108, -2458, 2588, -459, -3122, -5193, -3645, -1157, -8026, -10252,
+   -5667, -7893, -12402, -8550, -6484, -12560, -12337, -7601, -11286, -11153, -8754, -8695,
+   -7222, -5504, -6171, -6239, -4579, -2080, -1634, -2382, 2528, 3791, -589, -1162,
+   5888, 5801, 1418, 2736, 9082, 5972, 5210, 7584, 10660, 7864, 5708, 8063,
+   9978, 6379, 3161, 6088, 4308, 6629, 3237, 2431, 6815, 3831, 3321, 1151,
+   1379, 3906, -630, -2600, 714, -822, -5530, -5670, -510, -4343, -8519, -528,
+   -151, -3020, -4054, -3547, -1093, -4804, -3848, -387, -949, -508, -2316, -2024,
+   -2120, 1261, -3634, -4684, 1180, 1440, -1488, -834, 1164, 1990, -3471, -1756,
+   3300, -592, -2780, 536, 2297, 60, -1214, -93, 173, -1992, -1831, -910,
+   -1049, -312, -743, -4142, -4355, 178, -1017, -4009, -1334, 2167, -5258, -5174,
+   3135, 1395, -1935, 179, 7023, 3724, -741, 5756, 6045, 2704, 1699, 6614,
+   4613, 3398, 3778, 4741, 5380, 5875, 6643, 3842, 4971, 7372, 4997, 4274,
+   5843, 5271, 1524, 781, 3332, 1229, -3975, -5241, 416, 652, -5955, -5283,
+   -2643, -8468, -10821, -7053, -4135, -8239, -7372, -7736, -9018, -10545, -10029, -9872,
+   -9008, -5965, -6506, -9011, -3403, -1018, -5177, -6175, 1485, 414, -3423, -749,
+   4363, 2911, -1261, 4780, 8523, 4649, 5871, 6076, 8780, 9225, 7445, 8653,
+   9917, 13258, 12501, 10084, 9155, 8829, 6306, 6381, 8368, 6893, 2844, 1140,
+   6312, 5833, 59, -2617, 4893, -2163, -5856, -2680, -1805, -5391, -5183, -3869,
+   -6306, -8597, -11196, -7888, -8350, -8430, -9527, -9725, -5791, -4557, -7647, -9030,
+   -5465, -5603, -8308, -6882, -3497, -1470, -6857, -3707, 1653, -1016, -2638, 2162,
+   4926, 3769, 1695, 3835, 6100, 5778, 4219, 4085, 4060, 3576, 3266, 2005,
+   4282, 4659, 4780, 2683, 4609, 4047, 917, 1467, 5150, 4006, 1200, 1868,
+   5742, 1255, -2483, -228, 1791, -1892, -4379, -962, -224, -409, -1118, -885,
+   -98, -1009, -2035, -2409, -2025, 1335, 469, -2033, -305, -363, -2971, -2486,
+   2713, 2276, -2518, 330, 3608, 3694, -1915, 35, 66, -3458, -3303, -1410,
+   -1621, -3569, -3545, -2036, -1495, -2740, -3597, -3434, -3550, -1337, -3378, -5717,
+   -3893, -1433, -6237, -7076, -3139, -3051, -10619, -5812, -312, -4480, -5026, 1166,
+   2642, -2543, 1095, 4005, 5790, 2312, 3715, 6022, 5090, 6056, 6068, 5473,
+   5472, 7500, 6633, 3249, 6139, 9681, 4792, 6569, 11245, 8863, 4927, 3797,
+   6897, 3643, 618, 3650, 3210, -655, -2580, -126, -510, -3378, -2792, -6336,
+   -6099, -5836, -6883, -8300, -8389, -6512, -9261, -10378, -8656, -8198, -13208, -11796,
+   -4902, -6038, -9632, -7895, -2902, -4725, -7273, -3062, -2032, -4892, -3602, 426,
+   2324, 1801, 1837, 4862, 3830, 5528, 5412, 5468, 6126, 9185, 7905, 9473,
+   11432, 10273, 8949, 6157, 11030, 10364, 4117, 7072, 9587, 6336, 1564, 1853,
+   5276, 3546, -437, 2252, 798, -1888, -1389, -2251, -2208, -5222, -3470, -5968,
+   -5653, -5207, -9198, -5918, -6213, -4802, -10022, -8420, -3815, -1802, -8298, -5484,
+   -1842, -4994, -9839, -3887, -1950, -3387, -3933, -1487, 1051, 50, -523, 2014,
+   1670, 3227, 3907, 1816, 2469, 3991, 809, 1942, 6182, 3499, 1901, -700,
+   5297, 5589, -1118, 575, 5861, 3499, -2569, 1998, 3349, -594, 306, 2335,
+   1207, 1031, 772, 3295, 1288, 2432, -1634, -1019, -956, 2947, 591, -2220,
+   2587, 1714, -1061, -2840, 3111, 3009, -2283, 1704, 3858, 1958, -1975, 4174,
+   5700, 2473, 584, 4060, 3103, -552, 1248, 1218, -1789, -301, -858, -4234,
+   -3118, -2543, -5950, -6859, -432, -2107, -6688, -7822, -1035, -3843, -8028, -6666,
+   -2656, -4612, -10092, -7008, -4022, -6858, -8539, -3919, -3497, -4488, -3514, 721,
+   2612, 1192, 816, 416, 2820, 4954, 7037, 4393, 7582, 10801, 5788, 6893,
+   10218, 11501, 6472, 7687, 9994, 8207, 7891, 11177, 9129, 6381, 4103, 6886,
+   6873, 2751, 2112, 720, 50, 1104, -2043, -1233, -2247, -567, -3191, -6596,
+   -3010, -3381, -7727, -10364, -7693, -7821, -11296, -11355, -7659, -12475, -16225, -9107,
+   -7297, -10325, -8623, -6367, -6410, -6980, -6349, -2064, -2840, -3761, -1019, -1399,
+   1152, 4357, 1150, -1741, 3430, 6910, 1787, 3948, 10331, 10475, 4505, 7504,
+   10438, 8298, 4024, 8966, 9840, 4380, 5149, 6357, 8367, 4229, 4343, 6339,
+   3212, 3948, 2253, 764, -336, 112, -1667, -6066, -933, -2530, -7301, -7559,
+   -2711, -4102, -8383, -5927, -1690, -5347, -5774, -5807, -1893, -3542, -4337, -3811,
+   -498, -2296, -4717, -2429, -4661, -2704, -3089, -2503, -528, 2515, -768, -779,
+   3735, 1400, -539, 4, 3914, 1990, -3975, -433, 3104, 1426, -1492, 104,
+   2899, -245, -1967, 1682, 1875, -193, -2598, -1060, -904, -1597, -221, -2937,
+   -614, 261, -136, -2375, 2599, 5244, -1545, -165, 4008, 2930, -1074, 766,
+   7453, 1555, -1734, 2086, 5723, 3223, 507, 5159, 6730, 3564, 1970, 6500,
+   5091, 4496, 4183, 2793, 3166, 4149, 619, -1472, 524, 2505, -2601, -4532,
+   -1880, -2890, -10321, -5458, -4407, -6756, -8654, -9982, -4292, -6951, -11960, -4218,
+   -5142, -8231, -6310, -7812, -6618, -6060, -6409, -6010, -3450, -1768, -2916, -4840,
+   -1257, 3845, -1285, -1259, 5464, 3674, 1551, 4323, 9616, 6429, 2643, 10048,
+   9288, 7863, 10504, 12404, 10842, 8308, 8819, 9561, 8740, 6733, 7407, 5760,
+   4700, 7191, 3878, 246, 2047, 5803, -174, -1816, -1121, -447, -6774, -8191,
+   -3242, -6385, -11033, -6503, -4614, -10111, -11511, -8571, -9704, -10042, -7359, -8791,
+   -8967, -5943, -6151, -8429, -7720, -3372, -4096, -6859, -1986, 298, -3425, -2368,
+   3959, 4759, 547, 3157, 8573, 5013, 4157, 6436, 9718, 6324, 3643, 6356,
+   5823, 5656, 6002, 3850, 4766, 5338, 4117, 2906, 4170, 7350, 2880, 2182,
+   4248, 4162, 1017, 184, 4472, 235, -3780, -4230, -938, -2570, -5238, -2294,
+   613, -4065, -4800, -1021, -414, -2837, -3760, -1259, 1113, -2030, -1919, -2167,
+   -663, 275, -3837, -3449, 270, -624, -4686, -3391, 2944, -15, -4447, -2572,
+   3842, -1055, -4314, -427, 1642, -1175, -2414, 1629, -1631, -3037, -2697, -2788,
+   -2783, 157, -1261, -3141, -3732, -408, -3234, -4599, -2813, 266, -5196, -4026,
+   3219, 2758, -2354, -1402, 3085, 934, -2674, 4296, 6123, 4654, 4009, 4199,
+   6085, 4854, 4760, 6972, 7317, 5056, 5704, 2094, 4435, 10039, 5309, 4064,
+   8039, 9520, 1671, 1768, 6862, 2852, -2939, 1586, 2677,
+};
+
+static const int16_t golden_downsampler_22050_2[] = {
+   -8074, -5063, -8451, -5701, -5066, -9143, -1006, -4685, -908, 1006, -5014, -5090,
+   1147, -7591, 3673, -6525, -846, -3376, 902, -2199, 5830, -2613, 3248, -2354,
+   3254, 5421, 8660, 1817, 10585, -1199, 4609, -510, 11039, 5996, 13884, 5480,
+   9405, 275, 9293, 4088, 12473, 5958, 11313, 7625, 6292, 6557, 9559, 6931,
+   13086, 11318, 5688, 9746, 2383, 4520, 6027, 10330, 6241, 16926, 1533, 13379,
+   2522, 6727, 3133, 8004, -2742, 13831, -4559, 8317, 605, 4893, -826, 4274,
+   -5009, 8612, -3539, 7051, -2178, 1655, -4802, 6769, -12385, 8402, -10272, 4285,
+   -6615, 608, -10834, -1426, -12941, 1746, -8944, 133, -10350, -3570, -12944, -2719,
+   -6170, 3495, -7106, 1299, -12756, -5358, -7850, -7027, -1611, 1035, -5648, -2321,
+   -7437, -8601, -609, -6646, 2152, -1479, 608, -5990, -1219, -12779, 4183, -10595,
+   5413, -10176, 106, -8444, 5451, -12674, 8775, -13607, 4840, -10376, 8169, -7951,
+   14022, -14027, 9967, -10701, 7815, -5085, 11624, -6634, 14018, -11546, 10150, -7627,
+   10896, -1082, 11060, -4184, 7241, -7616, 5945, -5733, 11142, -718, 7403, -4134,
+   2015, -2609, 4344, -2227, 3880, 4558, -203, 2445, -2848, -3415, 2242, 3133,
+   2713, 5738, -7082, 3865, -5231, 3991, 665, 1881, -7131, 8484, -9426, 6333,
+   -4728, 2628, -6526, 8851, -11494, 9773, -8616, 11687, -8923, 9339, -13633, 7943,
+   -16618, 10777, -8151, 16190, -10328, 10823, -11366, 10169, -6867, 16736, -3612, 13945,
+   -5631, 6377, -8293, 7936, -1115, 11840, -2515, 12210, -2876, 2594, -1052, 5133,
+   5399, 9060, 1817, 9003, -2393, 1114, 1709, 1841, 7065, 2983, 2643, 3587,
+   4817, -1665, 13796, -1666, 8314, 5260, 2947, 3005, 11929, -2702, 11174, -3595,
+   10036, 2025, 12312, -93, 15131, -8355, 8207, -9019, 7008, -1714, 10007, -5705,
+   9410, -11668, 3016, -8483, 3882, -7505, 6907, -8510, 1231, -14500, -1560, -10517,
+   3559, -8251, 3615, -9465, -2298, -13048, -2230, -14787, -641, -4563, -1279, -6605,
+   -6643, -12273, -6957, -12297, -6111, -4087, -10508, -1929, -7366, -10278, -3372, -6534,
+   -11928, -4111, -16441, -2652, -10468, -6410, -9281, -3382, -9605, 5495, -8628, 1131,
+   -6105, -2917, -7873, -509, -11620, 3210, -4856, 2102, -96, 648, -2412, 4171,
+   -2403, 7190, 2535, 6538, -1168, 3127, -4359, 7454, 4964, 9146, 4053, 8612,
+   -856, 7325, 984, 9797, 6279, 13004, 5483, 13856, 4536, 6902, 8213, 7922,
+   9420, 14775, 6020, 9597, 10895, 7324, 13913, 8418, 10580, 10624, 5522, 9173,
+   10614, 3813, 11574, 4735, 5485, 8394, 6394, 5981, 6432, 1896, 5322, 1720,
+   -2561, 5282, 1046, 2968, 2174, 2042, -2680, -2236, -889, 6064, -380, -539,
+   -2585, -3660, -6833, -3555, -5552, -1738, -2860, 547, -8632, -7420, -10768, -9736,
+   -7971, -3363, -12620, -3167, -14970, -9835, -8997, -8104, -10951, -2017, -14678, -10442,
+   -11202, -13474, -2495, -12707, -11535, -11039, -10668, -11639, -2436, -15073, -5997, -11393,
+   -9608, -4836, -1710, -9299, -762, -11580, -2111, -10367, -4186, -4972, 1376, -5536,
+   4638, -7906, 551, -5316, 3997, 1059, 9250, -1668, 4266, -5444, 2768, -5093,
+   12103, -327, 11470, 131, 5105, -2270, 8692, -3220, 12269, 5895, 7801, 4142,
+   9065, 1356, 16203, -1035, 13448, 7873, 8617, 7110, 6550, 4865, 11043, 5083,
+   9073, 10882, 4142, 8616, 4285, 2037, 3838, 8337, -4171, 12787, 4064, 9194,
+   3199, 3275, -4209, 9071, -1540, 15169, -1075, 8736, -909, 7550, -8142, 10444,
+   -9555, 12313, -3296, 11107, -8036, 6776, -12918, 7718, -5964, 7391, -8695, 7050,
+   -14005, 2944, -12653, 1311, -4970, 3950, -10851, 2164, -14751, -2288, -4793, 3736,
+   -2903, 2600, -9349, 3309, -5282, -2826, -2054, -5040, -5553, 3365, -8799, -809,
+   -2234, -5463, 4303, -5077, 97, -1996, 3275, -4292, 7152, -11785, 3539, -7588,
+   -697, -3544, 6894, -4372, 6856, -14124, 4326, -13695, 9721, -7361, 15621, -12743,
+   10191, -13167, 9685, -11354, 12166, -9838, 10916, -6936, 7443, -14386, 6889, -10402,
+   10321, -3722, 3549, -4732, 2391, -7952, 8158, -7087, 6141, -1547, 2228, -2108,
+   3868, -6295, 4053, -4240, 1489, -1143, -5160, 1176, -32, -3630, 849, -2669,
+   -6278, 4180, -3737, 3112, -3095, 1608, -8199, -87, -12960, 4249, -6238, 6594,
+   -4259, 2225, -13053, 5035, -10536, 7867, -6266, 10599, -11498, 981, -16178, 5829,
+   -7540, 13810, -7882, 10672, -10198, 6328, -6867, 7224, -966, 15011, -5134, 12582,
+   -8131, 6650, 1346, 10165, -3162, 15251, -4985, 10393, -2833, 6231, 4405, 8823,
+   1661, 7565, -2779, 9574, 4886, 2669, 5278, 4204, 2177, 8582, 6674, 5076,
+   14418, -1132, 7422, 263, 3787, 6156, 12482, 2261, 14158, -4166, 8977, -428,
+   10607, 1079, 11242, -701, 9808, -6760, 7184, -5622, 9085, -2421, 5398, -2940,
+   861, -8811, 1011, -11492, 7246, -6414, 5297, -3993, -1648, -10263, 2300, -12867,
+   869, -6156, -8036, -8900, -7139, -14503, -3168, -10939, -2392, -5879, -9681, -6798,
+   -1915, -12828, -5570, -9902, -13855, -4181, -11691, -9399, -9207, -10851, -14196, -5550,
+   -14994, -3023, -8540, -3390, -6863, -6149, -11340, -6682, -7097, 290, -3428, 1392,
+   -5091, -5264, -10200, -2151, -1863, 4832, 345, 482, -4325, -2521, -1616, 116,
+   3889, 4836, 232, 5590, -3166, 643, 5487, 4071, 7976, 9069, 1988, 7309,
+   5142, 6600, 8003, 4148, 4619, 12941, 6220, 12229, 9235, 5655, 9164, 8143,
+   7473, 12362, 13405, 13111, 17930, 7071, 9838, 10330, 4403, 13906, 7227, 10430,
+   9026, 3584, 4976, 7785, 4731, 12004, 6875, 6912, 2717, 2971, -369, 2648,
+   5973, 6651, 3893, 7773, -1556, 1673, -4839, -394, 3493, 6293, -4223, -104,
+   -7928, -3786, -4939, -421, -6425, 2815, -11791, 1008, -7784, -2583, -3033, -4705,
+   -12256, -358, -16685, -510, -13002, -9390, -8615, -7162, -11737, -4963, -11030, -5831,
+   -4754, -14300, -7675, -11776, -7263, -4319, -3890, -5225, -2692, -12603, -5511, -12551,
+   -4312, -6619, -1227, -9979, -2465, -14152, -4128, -9636, 1058, -8052, 3016, -5956,
+   -1234, -12481, 665, -8080, 7134, -3828, 1966, -4000, 6097, -11373, 9374, -5050,
+   11117, -1267, 7675, -136, 7225, -3835, 13025, -5355, 8646, 3554, 8101, 3454,
+   12073, -3634, 9496, -1326, 4693, 3427, 4408, 2743, 6307, 225, 4146, -137,
+   2602, 5962, 5703, 3614, 7033, 2527, -2821, 8186, -450, 9667, 2225, 5869,
+   -4295, 6128, -6367, 9300, -2752, 13050, -2740, 10751, -7025, 9424, -6300, 10035,
+   -3389, 14873, -6771, 9282, -12002, 7034, -7999, 7542, -11602, 15184, -12852, 9067,
+   -13590, 4830, -5365, 3441, -9447, 8998, -8948, 8130, -4074, 1837, -4376, 2605,
+   -6721, 6525, -3838, 1819, -1168, -2904, -4653, -164, -6200, 2148, 2840, -171,
+   5494, -4557, -2258, -1809, 698, -1307, 4665, -5391, -261, -5682, -712, -4261,
+   6147, -721, 10406, -5855, 5415, -10451, 9232, -8572, 13364, -6150, 11791, -4403,
+   8149, -11979, 10766, -10696, 10007, -9875, 5066, -11983, 6073, -12679, 10199, -13019,
+   6712, -9955, 1617, -8756, 5158, -12247, 4617, -8690, -993, -1998, -1825, -3656,
+   1268, -8464, -150, -6719, -5330, -1770, -2316, -359, -325, -6431, -4919, -6517,
+   -5200, -2588, -2462, -405, -7987, -4487, -12019, -2134, -10113, 3835, -6889, 785,
+   -16342, -4896, -10943, -682, -8181, 7556, -13689, 4727, -11798, 1745, -3731, 6064,
+   -5446, 10729, -11777, 6690, -5663, 7852, -98, 8107, -3057, 14638, -8513, 13136,
+   158, 7271, 1914, 10130, -4587, 14766, 932, 11178, 5115, 7020, 1518, 9428,
+   -506, 11450, 5796, 9203, 6312, 6952, 2226, 4273, 5711, 6567, 10874, 8487,
+   8386, 1199, 8400, 4737, 14379, 8111, 13081, 4645, 8468, 1386, 8822, -1228,
+   11672, 2122, 8296, -1011, 4595, -3360, 7089, 211, 4278, 2141, 981, -2293,
+   1113, -6273, 3877, -4130, 1209, -2229, -1892, -4865, 3707, -9292, -1363, -11308,
+   -5615, -6582, -5268, -6405, -2858, -10907, -3839, -12762, -9999, -6780, -3674, -9351,
+   -5348, -13174, -12333, -8424, -11351, -5962, -7370, -9026, -12471, -13946, -15152, -8439,
+   -6112, -3692, -6866, -5211, -10158, -9108, -7224, -8567, -4009, -1796, -5121, -4330,
+   -7626, -6922, -1791, -4332, -2901, -1164, -6735, -3050, -1880, -5323, 4230, -3378,
+   -508, 5155, 1115, 2486, 3997, -324, 7968, 1755, 2081, 5578, 6454, 4601,
+   11982, -1158, 7465, 3470, 2977, 9274, 9921, 8448, 12195, 3615, 9509, 9437,
+   10157, 12705, 12180, 8365, 9159, 8738, 5451, 6862, 8792, 13267, 9312, 11415,
+   1767, 6466, 3612, 10531, 6673, 12500, 3423, 9249, -848, 3976, -685, 4390,
+   883, 9669, -2867, 9959, -3093, 2219, 775, 3730, -7385, 8981, -8551, 4775,
+   -2832, 53, -1948, -2554, -10152, 5736, -11117, 672, -5525, -1415, -11978, 41,
+   -14317, 3011, -10178, -237, -9496, -8902, -11117, -721, -11025, -1402, -6104, -3502,
+   -8919, -11127, -8860, -7982, -5800, -1830, -671, -2933, -5161, -11435, -2927, -8040,
+   2314, -5999, -714, -9274, -4315, -15364, 5222, -12997, 3490, -7391, 1533, -8307,
+   5434, -13300, 8403, -11377, 5898, -3797, 5240, -5140, 8360, -9406, 13351, -9324,
+   7597, -4258, 10692, -4239, 13725, -5913, 9436, -5804, 5442, -505, 10660, -2679,
+   9660, -8042, 5592, -1709, 6840, 5524, 7853, -855, 2120, 1682, -2166, 767,
+   5270, 5322, 2877, 8300, -2011, -225, -9, 1157, 1627, 10095, -3842, 10840,
+   -5472, 333, -2704, 6700, -4100, 10797, -11020, 9832, -9482, 10093, -2587, 7257,
+   -10719, 13133, -13023, 15084, -6670, 8214, -6972, 13562, -11641, 14217, -7383, 12246,
+   -7863, 4595, -8197, 6158, -10994, 9081, -3163, 9057, -1185, 2366, -9158, 4718,
+   -1423, 6595, 215, 3212, -3543, 1419, -4760, -920, 2510, 3711, 3656, 2362,
+   -3475, -1092, 4122, -714, 7779, -63, 4574, -659, 3879, -7829, 11274, -2926,
+   10240, 1160, 7576, -2631, 9212, -8044, 14322, -6203, 9289, -3082, 6207, -7311,
+   12239, -9744, 12167, -9731, 2294, -5873, 7502, -8103, 9724, -11440, 6255, -14723,
+   1021, -7258, 4120, -9207, 3981, -15882, -2427, -11293, 3067, -3932, 3260, -7474,
+   -2124, -11252, -5079, -10565, 2464, -4534, -2570, -5117, -7669, -8389, -4639, -8693,
+   -3813, -1498, -8355, -870, -12038, -8146, -10592, -3424, -11642, 3597, -15226, 1510,
+   -14081, -2997, -8210, 371, -10363, 3368, -13736, 4759, -6599, -430, -2647, 4089,
+   -4663, 9887, -4742, 7125, -986, 2619, -4317, 5149, -5526, 11166, -108, 10016,
+   5670, 8404, 1474, 7313, 2737, 12428, 6300, 15301, 2235, 9340, 4556, 9229,
+   7407, 13027, 9204, 13797, 4546, 8396, 7627, 7747, 11588, 8398, 7815, 8598,
+   9481, 6301, 16277, 6077, 10459, 7800, 5245, 7517, 6515, 1691, 9614, 4157,
+   6707, 7038, 1398, 4103, 4219, 5, 2975, -1536, -2618, 2719, 2279, -72,
+   1276, -5363, -625, -1843, -5404, 910, -49, -1086, 2575, -8958, -6974, -6219,
+   -3839, -2181, -623, -6140, -6225, -9229, -8912, -11815, -9920, -5465, -8725, -6918,
+   -12159, -10432, -9420, -13290, -7044, -8274, -13017, -11934, -16517, -15933, -7685, -10530,
+   -6803, -7791, -12268, -8384, -8397, -8848, -2598, -10136, -4494, -8328, -6757, -7202,
+   -3296, -9402, 2254, -6383, -3710, -1970, -3183, -4340, 2937, -4975, -563, -2235,
+   -872, 3175, 7602, 1112, 4100, -1800, -1023, -2461, 6713, 146, 11212, 2606,
+   5458, -1885, 6903, 993, 13046, 7616, 14513, 6437, 6808, 2201, 10655, 4353,
+   11619, 9257, 8404, 8192, 4496, 3551, 9845, 8086, 8791, 10889, -1178, 9938,
+   1964, 8334, 3774, 8939, -124, 16858, -3042, 11500, 2416, 6270, 1904, 10773,
+   -5229, 11653, -3402, 11298, 472, 4034, -5896, 7424, -11019, 10346, -6126, 6348,
+   -6904, 3569, -13562, 1430, -11291, 9424, -8838, 3777, -14405, -197, -15430, 311,
+   -9698, 4276, -7449, -755, -11119, -5647, -8729, -3125, -3494, 113, -8921, -1774,
+   -7123, -4425, -3018, -8598, -964, -2824, -3456, -3629, 397, -9072, 2908, -10531,
+   2298, -3295, 2017, -6610, 2896, -12332, 6472, -11330, -438, -8885, 6470, -11879,
+   11331, -17510, 5199, -10205, 3405, -4461, 13225, -8195, 12557, -14093, 10186, -11744,
+   9847, -2378, 10626, -7827, 8784, -9863, 7576, -7568, 10459, -2632, 9203, -5223,
+   -23, -7926, 4605, -5471, 4979, 1228, 2645, 206, 1475, -4460, 2781, -2574,
+   4364, 1434, -2738, 2248, -4227, 291, 900, 2463, -4155, 7904, -7814, 7427,
+   -2609, -2589, -6176, 4054, -10722, 8913, -10892, 7698, -4909, 4466, -12691, 6817,
+   -13904, 12676, -9489, 10012, -9200, 8928, -13195, 8444, -11486, 16683, -4285, 14772,
+   -7510, 4420, -10430, 10101, -4638, 12653, -3488, 9348, -4923, 2773, -4174, 5705,
+   2447, 12459, -1835, 4944, -4793, 1325, 750, 3422, 3649, 7795, -80, 6526,
+   1603, -591, 9111, 1206, 5424, 8037, 4661, 2465, 7950, -4011, 14533, -1533,
+   7427, 2754, 10302, -1310, 15436, -7070, 10609, -5024, 7480, -1150, 11433, -3135,
+   12677, -11439, 6389, -9334, 3686, -2639, 9824, -4814, 5792, -10994, 729, -9793,
+   3844, -7606, 5517, -11296, -6164, -14478, -828, -10087, 2461, -11276, -1993, -11520,
+   -4914, -12395, -6478, -13487, -2534, -6051, -4779, -9124, -9961, -13959, -1071, -7365,
+   -9491, -792, -11718, -4744, -5591, -7029, -12693, -2933, -12560, -677, -12859, 738,
+   -7683, -5135, -9900, -2120, -13020, 6119, -3843, 307, -3655, -2178, -8464, -1217,
+   -6146, 3633, 2170, 5520, -3851, 1282, -3022, 504, 3416, 7511, 2356, 4993,
+   -1949, 5050, 1116, 7529, 8671, 10560, 5281, 7578, 1356, 3930, 9666, 10429,
+   7066, 11509, 6117, 9607, 12528, 8478, 11747, 13060, 9429, 12255, 8157, 8459,
+   12544, 5093, 10058, 9064, 6041, 11439, 5479, 7987, 10434, 4379, 5268, 6251,
+   1260, 8140, 5051, 9329, 6689, 1067, -1650, 2142, -986, 5081, 5449, 6157,
+   1145, -1494, -2274, -1358, -1057, -1184, -1502, 607, -5033, -8515, -8370, -8012,
+   -3147, -3338, -8390, -4381, -10867, -11201, -8009, -4997, -6858, -2372, -14294, -5928,
+   -15047, -7974, -5815, -11328, -10526, -8883, -10063, -10022, -3349, -11369, -7671, -9912,
+   -10427, -7508, -3318, -8568, 262, -12565, -4912, -11946, -5173, -10268, -984, -5759,
+   1400, -9591, -4203, -9516, -1000, -2973, 6324, -5729, 2314, -9164, 1308, -6045,
+   10116, -2197, 9467, 52, 6818, -5725, 9811, -3498, 15502, 1643, 8570, 1455,
+   8786, -473, 13031, -158, 14136, 5299, 6843, 5803, 6858, 427, 11595, 1117,
+   5157, 6488, 3151, 8160, 7532, 4471, 4705, 2995, -471, 10003, 2582, 8093,
+   4222, 4012, 552, 5258, -3968, 12308, 504, 14195, -201, 5961, -3826, 8190,
+   -4652, 13148, -2628, 10951, -5494, 7527, -11191, 11559, -2650, 11594, -7994, 8464,
+   -11398, 3839, -11702, 3241, -9130, 7254, -9394, 4254, -13629, 3153, -5490, 902,
+   -4180, 5405, -10764, 2633, -6449, -3150, -849, -1195, -6045, 5217, -8116, 2441,
+   -1156, -6364, -308, -2211, -777, 3003, -1161, -2899, 3618, -7455, 980, -5314,
+   594, -1921, 7955, -7405, 4950, -12624, 1600, -8499, 5616, -5076, 7347, -8595,
+   5471, -14842, 5085, -11869, 13175, -7288, 13474, -13505, 8041, -16936, 8753, -13898,
+   11513, -3830, 6927, -9037, -249, -8378, 9025, -9878, 10257, -6973, 2235, -4585,
+   4554, -9383, 8127, -4870, -884, -2379, -2305, -3769, 2146, -7541, -1653, -3925,
+   -4772, -793, 306, 7, -1394, -1129, -7011, 729, -11684, 4220, -4042, 3225,
+   -5014, -1455, -10716, 1516, -11359, 5732, -5087, 5617, -14070, 3677, -14615, 6563,
+   -6338, 12776, -5669, 11185, -9983, 5275, -9193, 6388, -3662, 9830, -7932, 9801,
+   -11360, 6011, -2494, 11085, -2660, 14907, -2739, 12047, -1894, 9910, 2619, 5779,
+   523, 11648, 330, 9378, 5925, 3595, 6779, 7163, 1707, 12926, 1960, 8151,
+   10126, 1281, 4909, -721, 1956, 6912, 13737, 6341, 13579, -2962, 7334, 793,
+   12667, 3411, 16525, 2513, 8073, -4732, 5057, -1522, 13309, 414, 7968, -2265,
+   16, -5894, 5935, -2763, 8097, -2742,
+};
+
+static const int16_t golden_downsampler_22050_1_nomix[] = {
+   -4170, -7721, -3365, 151, -4419, -8347, -764, 2800, -3057, 3008, 5445, 4283,
+   1946, 10712, 12142, 5269, 7146, 11420, 9664, 8847, 12487, 13365, 4397, 5005,
+   11093, 4376, 4901, 6059, 5491, 1800, 993, 7689, -1959, -3600, 2509, -984,
+   -8753, -3493, -2252, -5908, -8338, -8613, -8028, -12513, -11166, -10846, -12443, -15026,
+   -8654, -5251, -8719, -5645, -1174, -2553, -7410, 971, 526, -5912, -1204, 4890,
+   -465, 2320, 8291, 7578, 4768, 7348, 12126, 5267, 7734, 10954, 14068, 5782,
+   10219, 10440, 6459, 5677, 7073, 5523, 1788, 4087, 5832, 692, -3170, 2785,
+   4155, -4247, -4076, -3056, -8683, -8777, -3909, -4634, -12085, -12081, -7882, -16440,
+   -14956, -7361, -8357, -10526, -9535, -2837, -5322, -5830, -2523, -1324, -4031, -3669,
+   233, 1778, -570, 5671, 6066, 2417, 3669, 9856, 7578, 6516, 13184, 15666,
+   11363, 10572, 11672, 8187, 5794, 10082, 8427, 2939, 3269, 7212, 3412, -1364,
+   5026, 1029, -2562, -4153, 2932, -2458, -6167, -4065, -4662, -7782, -8868, -7693,
+   -12007, -13281, -10381, -9647, -11287, -7484, -3761, -6316, -12373, -2010, -1352, -7244,
+   -2760, 4553, -224, -4014, 3154, 2497, 2971, 5098, 9621, 5089, 3959, 10361,
+   11632, 5785, 10885, 13308, 12079, 10654, 11855, 7973, 5111, 3424, 9490, 6673,
+   -74, 3341, 3119, -3400, -218, 321, -3546, -6165, -90, -2777, -9891, -6965,
+   -3461, -7234, -13391, -8608, -8808, -17772, -13964, -7016, -7352, -9485, -4551, -4341,
+   -8316, -312, -54, 797, -3778, 4596, 3351, -1573, 2779, 8057, 4199, 3277,
+   9941, 11867, 6306, 8568, 14944, 12441, 8731, 15854, 12961, 7706, 7119, 6677,
+   5252, 1658, 3962, 5950, 27, -736, 5184, -693, -3549, 1484, 122, -7194,
+   -6271, -2535, -5470, -12224, -7076, -8217, -12774, -9022, -5935, -10214, -9157, -7556,
+   -7710, -7921, -5069, 846, -5229, -4504, 1330, 24, -1489, 2957, 3108, 953,
+   3005, 7070, 4615, 6747, 6433, 12867, 11802, 7668, 13211, 17384, 6975, 7751,
+   11561, 3315, 3047, 10471, 8981, 214, 1744, 3591, -4080, -6663, -1942, 2885,
+   -6140, -4771, 625, -8194, -9365, -4535, -9743, -16560, -13443, -7356, -13135, -15551,
+   -8070, -3407, -7272, -5768, -976, -6578, -6989, -1620, 606, -5071, -2981, 2334,
+   -1043, -52, 8684, 7587, 5672, 9105, 9505, 7692, 7135, 13353, 13251, 7782,
+   10179, 14388, 6736, 5924, 5752, 9441, 536, 3952, 5007, 1692, -4898, 2910,
+   1817, -3598, -4210, -2423, -7969, -9770, -6372, -4344, -14766, -9864, -6949, -11882,
+   -13943, -10315, -7740, -11831, -10341, -3917, -7793, -6030, -3341, 723, -5998, -701,
+   2547, -205, -3414, 6352, 5729, -54, 3958, 5917, 4284, 5397, 12484, 12834,
+   7325, 9878, 16504, 10334, 3739, 8097, 11637, 3461, 4146, 5546, -550, -1447,
+   5289, 5047, -4332, -3481, -1521, -8225, -10179, -2938, -4657, -11915, -9081, -4978,
+   -11051, -13683, -8888, -7781, -14577, -13157, -5967, -5186, -7832, -6235, -5661, -7588,
+   -4088, 552, 734, -3815, 1671, 2985, 694, 4975, 7901, 4822, 4407, 7925,
+   10260, 7901, 7981, 13848, 10183, 8489, 13206, 11901, 5212, 8513, 11385, 5924,
+   1358, 6869, 5152, -3543, -835, 2733, -502, -6843, -662, -1274, -9957, -5917,
+   -5413, -12224, -11088, -8499, -10345, -15926, -9410, -3378, -10122, -11831, -3398, -1264,
+   -6038, -4619, 1463, -1895, -2385, 2178, 5216, 859, 4730, 3614, 800, 2181,
+   8384, 7233, 3610, 9969, 14026, 9587, 6055, 10672, 8422, 7840, 10276, 9414,
+   3458, 582, 7308, 6272, -54, 142, 2486, -1844, -4180, 2398, -591, -7613,
+   -4298, -2404, -8383, -10473, -9821, -5318, -12075, -15380, -6378, -12004, -12619, -7175,
+   -6034, -12583, -8033, -2019, -1530, -2446, -435, 1355, -3142, 2943, 6022, 1034,
+   -546, 5301, 8273, 3338, 5754, 10826, 5536, 11282, 15036, 13681, 9162, 10088,
+   13792, 6380, 4096, 6366, 8499, 985, 886, 4403, 3940, -3903, -1121, -149,
+   -7864, -4993, 1347, -6296, -9348, -5721, -4592, -11663, -8601, -7692, -15685, -16108,
+   -6625, -7267, -11131, -9792, -3055, -7890, -5406, -2760, -1143, -4379, -1043, 6213,
+   -361, 490, 4528, 9114, 1340, 8841, 12507, 5649, 7371, 11642, 13205, 8275,
+   9284, 12963, 10891, 3210, 9097, 9647, 2289, 3179, 8571, 1995, 47, 2303,
+   -350, -4668, -6536, -2763, -2268, -6476, -3160, -3862, -9849, -10696, -4924, -12316,
+   -12152, -6001, -11064, -15298, -11438, -3570, -7043, -7734, -4391, -1112, -5798, -3990,
+   3070, -1996, -1780, 6601, 3288, 410, 2007, 9662, 7820, 4515, 9967, 11183,
+   7369, 10217, 13808, 9410, 9087, 12439, 6647, 2214, 6098, 6714, 3091, 525,
+   1575, 4073, -1767, -3370, 4624, -3300, -6307, -115, -6305, -9972, -9581, -3528,
+   -11570, -12765, -7769, -12863, -11610, -7740, -7742, -9169, -10688, -4415, -254, -8771,
+   -3246, 3542, -4363, -5731, 3186, 2244, 178, -223, 5396, 2187, 2104, 10864,
+   13544, 7212, 12315, 12119, 9446, 8890, 11933, 8269, 5456, 3826, 8641, 1144,
+   2001, 8052, 6860, 55, 337, 4595, -674, -3413, -2492, -1989, -8660, -7283,
+   -6019, -11643, -12727, -8739, -8013, -16152, -9983, -7925, -11436, -8537, -4651, -4217,
+   -9230, -4775, -420, -1834, -4127, 4313, 315, -117, -684, 4742, 5628, 4463,
+   6286, 8145, 7198, 6218, 13501, 10161, 7657, 15530, 11486, 7554, 6914, 10463,
+   7297, 3804, 10280, 4819, 1169, 1104, 7285, 68, -6676, -1174, -575, -5966,
+   -2508, -2193, -10111, -11043, -8096, -9275, -14442, -11462, -6858, -10544, -11469, -6620,
+   -5862, -10522, -6509, -4474, -5951, -7785, -1333, -87, -937, 122, 4762, 2766,
+   -568, 4301, 8144, 3497, 5586, 10458, 9896, 7692, 13973, 16397, 10451, 7761,
+   10095, 6436, 7144, 9687, 3819, 884, 714, 5095, 564, -3106, -801, 1343,
+   -5406, -4937, 2604, -4462, -7231, -5760, -8400, -11378, -10965, -8575, -15830, -14367,
+   -8275, -5873, -13889, -7371, -3107, -9165, -7975, -2556, -2381, -4732, 663, 5354,
+   1341, -553, 6147, 6999, 1228, 6364, 9637, 7143, 4611, 10634, 11067, 9326,
+   11415, 12395, 6900, 4527, 10090, 9038, 1088, 1769, 7755, 613, -2131, 3194,
+   -71, -3977, -2525, 818, -5962, -6776, -3522, -3611, -10322, -7827, -7208, -11122,
+   -17613, -11073, -9152, -11590, -9662, -1464, -8408, -10803, -4700, -1850, -6819, -4394,
+   -1060, -1107, -2997, 1142, 3603, 430, 3523, 8351, 3249, 4662, 12405, 10870,
+   8489, 10215, 16541, 8636, 3954, 11033, 8703, 3123, 8300, 6870, 3055, 828,
+   2270, 4709, -948, -182, 1200, -1736, -5676, -997, -4167, -8670, -6992, -5385,
+   -9295, -12643, -9828, -6485, -12257, -14551, -3599, -10628, -10926, -2494, -6466, -4893,
+   -2227, 1678, -1562, -4012, 2799, 2623, 1734, 1369, 7577, 3225, 1024, 7496,
+   9606, 4388, 8453, 11225, 12521, 9942, 12709, 12791, 6378, 6074, 8703, 3760,
+   -1370, 3131, 2950, -509, 237, 1796, -2241, -3224, 1047, -4531, -7907, -4039,
+   -2600, -9809, -12323, -4884, -6347, -14038, -11267, -8043, -12124, -12770, -6968, -7638,
+   -10568, -6398, -451, -3195, -6859, 696, 1377, -4481, -163, 5158, 2740, -1321,
+   9118, 7650, 5086, 8433, 10492, 9000, 8158, 12525, 13303, 8340, 7918, 7168,
+   9460, 3802, 7396, 6588, 395, 1644, 1784, -1750, -2498, -410, -423, -7127,
+   -6582, -3262, -8888, -10607, -6146, -9142, -16428, -13550, -9811, -10810, -13530, -9226,
+   -7776, -11774, -5946, -2016, -4164, -3636, -65, -2711, -4987, -1357, 6811, 2465,
+   1383, 6900, 8979, 2534, 6049, 9925, 8970, 6215, 12340, 13487, 8884, 7100,
+   12641, 9898, 3137, 7141, 9615, 1565, 1664, 4922, 305, -1730, 2153, 893,
+   -4720, -6797, -2587, -6067, -8252, -4738, -5925, -11015, -8884, -5506, -11452, -13130,
+   -10374, -6153, -10687, -7044, -4252, -9378, -7844, -2773, -2220, -5295, -1024, 2142,
+   2129, -1754, 4347, 3808, 1687, 5218, 7471, 6768, 4295, 13204, 11849, 7492,
+   11384, 15321, 11835, 4240, 8067, 7132, 2971, 3581, 6478,
+};
+
+static const GoldenVector goldenVectors[] = {
+    { "mixer_2_1", golden_mixer_2_1, sizeof(golden_mixer_2_1) / sizeof(int16_t) },
+    { "mixer_1_2", golden_mixer_1_2, sizeof(golden_mixer_1_2) / sizeof(int16_t) },
+    { "mixer_2_2", golden_mixer_2_2, sizeof(golden_mixer_2_2) / sizeof(int16_t) },
+    { "mixer_4_2", golden_mixer_4_2, sizeof(golden_mixer_4_2) / sizeof(int16_t) },
+    { "mixer_2_1_loud", golden_mixer_2_1_loud, sizeof(golden_mixer_2_1_loud) / sizeof(int16_t) },
+    { "downsampler_8000_1", golden_downsampler_8000_1, sizeof(golden_downsampler_8000_1) / sizeof(int16_t) },
+    { "downsampler_8000_2", golden_downsampler_8000_2, sizeof(golden_downsampler_8000_2) / sizeof(int16_t) },
+    { "downsampler_8000_1_nomix", golden_downsampler_8000_1_nomix, sizeof(golden_downsampler_8000_1_nomix) / sizeof(int16_t) },
+    { "downsampler_11025_1", golden_downsampler_11025_1, sizeof(golden_downsampler_11025_1) / sizeof(int16_t) },
+    { "downsampler_11025_2", golden_downsampler_11025_2, sizeof(golden_downsampler_11025_2) / sizeof(int16_t) },
+    { "downsampler_11025_1_nomix", golden_downsampler_11025_1_nomix, sizeof(golden_downsampler_11025_1_nomix) / sizeof(int16_t) },
+    { "downsampler_16000_1", golden_downsampler_16000_1, sizeof(golden_downsampler_16000_1) / sizeof(int16_t) },
+    { "downsampler_16000_2", golden_downsampler_16000_2, sizeof(golden_downsampler_16000_2) / sizeof(int16_t) },
+    { "downsampler_16000_1_nomix", golden_downsampler_16000_1_nomix, sizeof(golden_downsampler_16000_1_nomix) / sizeof(int16_t) },
+    { "downsampler_22050_1", golden_downsampler_22050_1, sizeof(golden_downsampler_22050_1) / sizeof(int16_t) },
+    { "downsampler_22050_2", golden_downsampler_22050_2, sizeof(golden_downsampler_22050_2) / sizeof(int16_t) },
+    { "downsampler_22050_1_nomix", golden_downsampler_22050_1_nomix, sizeof(golden_downsampler_22050_1_nomix) / sizeof(int16_t) },
+};
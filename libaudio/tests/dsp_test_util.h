@@ -0,0 +1,183 @@
+/*
+** Copyright 2010, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_DSP_TEST_UTIL_H
+#define ANDROID_AUDIO_DSP_TEST_UTIL_H
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "AudioHardware.h"
+#include "AudioDsp.h"
+
+extern "C" {
+#include "alsa_audio.h"
+}
+
+namespace android {
+
+// Capture rates with a DSP conversion from the 44.1kHz stereo pcm, and the
+// channel counts an input can ask for
+static const uint32_t kTestRates[] = { 8000, 11025, 16000, 22050, 44100 };
+#define NUM_TEST_RATES (sizeof(kTestRates) / sizeof(kTestRates[0]))
+static const uint32_t kTestChannels[] = { 1, 2 };
+#define NUM_TEST_CHANNELS (sizeof(kTestChannels) / sizeof(kTestChannels[0]))
+
+struct ResponseBound {
+    uint32_t rate;
+    // -1 dB and -60 dB edges: highest passband frequency tested and lowest
+    // stopband one
+    uint32_t passband;
+    uint32_t stopband;
+};
+
+// edges of the filters documented with polyphaseConfigs in AudioDsp.cpp
+static const ResponseBound kResponseBounds[] = {
+    { 22050, 9200, 14700 },
+    { 16000, 7100,  9800 },
+    { 11025, 4800,  6900 },
+    {  8000, 3500,  4900 },
+};
+#define NUM_RESPONSE_BOUNDS (sizeof(kResponseBounds) / sizeof(kResponseBounds[0]))
+
+static inline int32_t test_triangle(uint32_t i, uint32_t period, int32_t amplitude)
+{
+    int32_t x = (int32_t)((int64_t)4 * amplitude * (i % period) / period);
+    return (x < 2 * amplitude) ? x - amplitude : 3 * amplitude - x;
+}
+
+static inline uint32_t test_random(uint32_t *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed >> 16;
+}
+
+/*
+ * Deterministic wide band test signal: two triangle waves per channel plus
+ * white noise. It is built with integer arithmetic only so that the golden
+ * vectors do not depend on the host libm.
+ */
+static inline void test_signal(int16_t *out, uint32_t frames, uint32_t channels,
+                               uint32_t seed)
+{
+    for (uint32_t i = 0; i < frames; i++) {
+        for (uint32_t c = 0; c < channels; c++) {
+            int32_t s = test_triangle(i, 101 + 37 * c, 12000) +
+                        test_triangle(i, 7 + c, 4000) +
+                        (((int32_t)test_random(&seed) - 32768) >> 3);
+            *out++ = clip(s);
+        }
+    }
+}
+
+/*
+ * Provider of the frames of a buffer, at most chunk frames at a time like
+ * the pcm periods of the capture source. With loop set the buffer is played
+ * again and again, otherwise getNextBuffer() fails once it is all read.
+ */
+class TestSource : public AudioHardware::BufferProvider {
+public:
+    TestSource(const int16_t *data, uint32_t frames, uint32_t channels,
+               uint32_t chunk, bool loop = false)
+        : mData(data), mFrames(frames), mChannels(channels), mChunk(chunk),
+          mLoop(loop), mPos(0) {}
+
+    virtual status_t getNextBuffer(Buffer* buffer) {
+        if (mLoop && mPos == mFrames) {
+            mPos = 0;
+        }
+        uint32_t count = mFrames - mPos;
+        if (count > mChunk) {
+            count = mChunk;
+        }
+        if (count > buffer->frameCount) {
+            count = buffer->frameCount;
+        }
+        if (count == 0) {
+            buffer->raw = NULL;
+            buffer->frameCount = 0;
+            return NOT_ENOUGH_DATA;
+        }
+        buffer->i16 = (short *)(mData + mPos * mChannels);
+        buffer->frameCount = count;
+        return NO_ERROR;
+    }
+
+    virtual void releaseBuffer(Buffer* buffer) {
+        mPos += buffer->frameCount;
+    }
+
+protected:
+    const int16_t *mData;
+    uint32_t mFrames;
+    uint32_t mChannels;
+    uint32_t mChunk;
+    bool mLoop;
+    uint32_t mPos;
+};
+
+/*
+ * The conversion stages AudioStreamInALSA::set() builds for an input at rate
+ * with channels channels, on a 44.1kHz stereo pcm read from source. Neither
+ * stage is built for a 44.1kHz stereo input.
+ */
+class TestCaptureChain {
+public:
+    TestCaptureChain(uint32_t rate, uint32_t channels,
+                     AudioHardware::BufferProvider *source)
+        : mMixer(NULL), mDownSampler(NULL) {
+        if (channels != 2) {
+            mMixer = new AudioHardware::ChannelMixer(channels, 2,
+                                                     AUDIO_HW_IN_PERIOD_SZ, source);
+        }
+        if (rate != AUDIO_HW_IN_SAMPLERATE) {
+            mDownSampler = new AudioHardware::DownSampler(rate, channels,
+                                                          AUDIO_HW_IN_PERIOD_SZ,
+                                                          source, mMixer);
+        }
+    }
+
+    ~TestCaptureChain() {
+        delete mDownSampler;
+        delete mMixer;
+    }
+
+    bool isPassthrough() { return mMixer == NULL && mDownSampler == NULL; }
+
+    int read(int16_t *out, size_t *frames) {
+        if (mDownSampler) {
+            return mDownSampler->resample(out, frames);
+        }
+        return mMixer->mix(out, frames);
+    }
+
+private:
+    AudioHardware::ChannelMixer *mMixer;
+    AudioHardware::DownSampler *mDownSampler;
+};
+
+// CPU time of the calling thread
+static inline nsecs_t test_cpu_time()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (nsecs_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+}; // namespace android
+
+#endif // ANDROID_AUDIO_DSP_TEST_UTIL_H
@@ -0,0 +1,394 @@
+/*
+** Copyright 2010, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef ANDROID_AUDIO_LEGACY_DOWNSAMPLER_H
+#define ANDROID_AUDIO_LEGACY_DOWNSAMPLER_H
+
+/*
+ * The capture downsampling chain the polyphase filter bank of AudioDsp.cpp
+ * replaced, kept as a reference for audio_dsp_bench: 2:1 halving stages
+ * (resample_2_1) and a 441:320 stage of linear interpolation after a low
+ * pass filter (resample_441_320), on deinterleaved channels. The code is the
+ * one of the HAL before "Replace the capture downsampling chain with a
+ * polyphase filter bank", with a legacy_ prefix.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "dsp_test_util.h"
+
+namespace android {
+
+/*
+ * 2.30 fixed point FIR filter coefficients for conversion 44100 -> 22050.
+ * (Works equivalently for 22010 -> 11025 or any other halving, of course.)
+ *
+ * Transition band from about 18 kHz, passband ripple < 0.1 dB,
+ * stopband ripple at about -55 dB, linear phase.
+ */
+static const int32_t legacy_filter_22khz_coeff[] = {
+    2089257, 2898328, -5820678, -10484531,
+    19038724, 30542725, -50469415, -81505260,
+    152544464, 478517512, 478517512, 152544464,
+    -81505260, -50469415, 30542725, 19038724,
+    -10484531, -5820678, 2898328, 2089257,
+};
+#define LEGACY_NUM_COEFF_22KHZ \
+    (sizeof(legacy_filter_22khz_coeff) / sizeof(legacy_filter_22khz_coeff[0]))
+#define LEGACY_OVERLAP_22KHZ (LEGACY_NUM_COEFF_22KHZ - 2)
+
+/*
+ * Convolution of signals A and reverse(B), A in 0.16 fixed-point and B in
+ * 2.30 fixed-point. The answer is in 16.16 fixed-point, unclipped.
+ */
+static inline int32_t legacy_fir_convolve(const int16_t* a, const int32_t* b, int num_samples)
+{
+    int32_t sum = 1 << 13;
+    for (int i = 0; i < num_samples; ++i) {
+        sum += a[i] * (b[i] >> 16);
+    }
+    return sum >> 14;
+}
+
+/*
+ * Convert a chunk from 44 kHz to 22 kHz. Will update num_samples_in and
+ * num_samples_out accordingly, since it may leave input samples in the
+ * buffer due to overlap.
+ */
+static inline void legacy_resample_2_1(int16_t* input, int16_t* output,
+                                       int* num_samples_in, int* num_samples_out)
+{
+    if (*num_samples_in < (int)LEGACY_NUM_COEFF_22KHZ) {
+        *num_samples_out = 0;
+        return;
+    }
+
+    int odd_smp = *num_samples_in & 0x1;
+    int num_samples = *num_samples_in - odd_smp - LEGACY_OVERLAP_22KHZ;
+
+    for (int i = 0; i < num_samples; i += 2) {
+        output[i / 2] = clip(legacy_fir_convolve(input + i, legacy_filter_22khz_coeff,
+                                                 LEGACY_NUM_COEFF_22KHZ));
+    }
+
+    memmove(input, input + num_samples, (LEGACY_OVERLAP_22KHZ + odd_smp) * sizeof(*input));
+    *num_samples_out = num_samples / 2;
+    *num_samples_in = LEGACY_OVERLAP_22KHZ + odd_smp;
+}
+
+/*
+ * 2.30 fixed point FIR filter coefficients for conversion 22050 -> 16000,
+ * or 11025 -> 8000.
+ *
+ * Transition band from about 14 kHz, passband ripple < 0.1 dB,
+ * stopband ripple at about -50 dB, linear phase.
+ */
+static const int32_t legacy_filter_16khz_coeff[] = {
+    2057290, -2973608, 1880478, 4362037,
+    -14639744, 18523609, -1609189, -38502470,
+    78073125, -68353935, -59103896, 617555440,
+    617555440, -59103896, -68353935, 78073125,
+    -38502470, -1609189, 18523609, -14639744,
+    4362037, 1880478, -2973608, 2057290,
+};
+#define LEGACY_NUM_COEFF_16KHZ \
+    (sizeof(legacy_filter_16khz_coeff) / sizeof(legacy_filter_16khz_coeff[0]))
+#define LEGACY_OVERLAP_16KHZ (LEGACY_NUM_COEFF_16KHZ - 1)
+
+#define LEGACY_RESAMPLE_16KHZ_SAMPLES_IN 441
+#define LEGACY_RESAMPLE_16KHZ_SAMPLES_OUT 320
+
+/*
+ * Convert a chunk from 22 kHz to 16 kHz: low pass filter the data into a
+ * temporary buffer, then convert chunks of 441 input samples at a time into
+ * 320 output samples by linear interpolation.
+ */
+static inline void legacy_resample_441_320(int16_t* input, int16_t* output,
+                                           int* num_samples_in, int* num_samples_out)
+{
+    const int num_blocks = (*num_samples_in - LEGACY_OVERLAP_16KHZ) /
+            LEGACY_RESAMPLE_16KHZ_SAMPLES_IN;
+    if (num_blocks < 1) {
+        *num_samples_out = 0;
+        return;
+    }
+
+    for (int i = 0; i < num_blocks; ++i) {
+        uint32_t tmp[LEGACY_RESAMPLE_16KHZ_SAMPLES_IN];
+        for (int j = 0; j < LEGACY_RESAMPLE_16KHZ_SAMPLES_IN; ++j) {
+            tmp[j] = legacy_fir_convolve(input + i * LEGACY_RESAMPLE_16KHZ_SAMPLES_IN + j,
+                                         legacy_filter_16khz_coeff,
+                                         LEGACY_NUM_COEFF_16KHZ);
+        }
+
+        const float step_float = (float)LEGACY_RESAMPLE_16KHZ_SAMPLES_IN /
+                (float)LEGACY_RESAMPLE_16KHZ_SAMPLES_OUT;
+        const uint32_t step = (uint32_t)(step_float * 32768.0f + 0.5f);  // 17.15 fixed point
+
+        uint32_t in_sample_num = 0;   // 17.15 fixed point
+        for (int j = 0; j < LEGACY_RESAMPLE_16KHZ_SAMPLES_OUT; ++j, in_sample_num += step) {
+            const uint32_t whole = in_sample_num >> 15;
+            const uint32_t frac = (in_sample_num & 0x7fff);  // 0.15 fixed point
+            const int32_t s1 = tmp[whole];
+            const int32_t s2 = tmp[whole + 1];
+            *output++ = clip(s1 + (((s2 - s1) * (int32_t)frac) >> 15));
+        }
+    }
+
+    const int samples_consumed = num_blocks * LEGACY_RESAMPLE_16KHZ_SAMPLES_IN;
+    memmove(input, input + samples_consumed,
+            (*num_samples_in - samples_consumed) * sizeof(*input));
+    *num_samples_in -= samples_consumed;
+    *num_samples_out = LEGACY_RESAMPLE_16KHZ_SAMPLES_OUT * num_blocks;
+}
+
+/*
+ * The DownSampler of the chain: 44.1kHz frames of channelCount channels
+ * from provider, converted to outSampleRate.
+ */
+class LegacyDownSampler {
+public:
+    LegacyDownSampler(uint32_t outSampleRate, uint32_t channelCount, uint32_t frameCount,
+                      AudioHardware::BufferProvider* provider)
+        : mProvider(provider), mSampleRate(outSampleRate), mChannelCount(channelCount),
+          mFrameCount(frameCount), mInInBuf(0), mInTmpBuf(0), mInTmp2Buf(0),
+          mOutBufPos(0), mInOutBuf(0) {
+        mInLeft = new int16_t[mFrameCount];
+        mInRight = new int16_t[mFrameCount];
+        mTmpLeft = new int16_t[mFrameCount];
+        mTmpRight = new int16_t[mFrameCount];
+        mTmp2Left = new int16_t[mFrameCount];
+        mTmp2Right = new int16_t[mFrameCount];
+        mOutLeft = new int16_t[mFrameCount];
+        mOutRight = new int16_t[mFrameCount];
+    }
+
+    ~LegacyDownSampler() {
+        delete[] mInLeft;
+        delete[] mInRight;
+        delete[] mTmpLeft;
+        delete[] mTmpRight;
+        delete[] mTmp2Left;
+        delete[] mTmp2Right;
+        delete[] mOutLeft;
+        delete[] mOutRight;
+    }
+
+    int resample(int16_t* out, size_t *outFrameCount) {
+        int16_t *outLeft = mTmp2Left;
+        int16_t *outRight = mTmp2Right;
+        if (mSampleRate == 22050) {
+            outLeft = mTmpLeft;
+            outRight = mTmpRight;
+        } else if (mSampleRate == 8000) {
+            outLeft = mOutLeft;
+            outRight = mOutRight;
+        }
+
+        int outFrames = 0;
+        int remaingFrames = *outFrameCount;
+
+        if (mInOutBuf) {
+            int frames = (remaingFrames > mInOutBuf) ? mInOutBuf : remaingFrames;
+
+            for (int i = 0; i < frames; ++i) {
+                out[i] = outLeft[mOutBufPos + i];
+            }
+            if (mChannelCount == 2) {
+                for (int i = 0; i < frames; ++i) {
+                    out[i * 2] = outLeft[mOutBufPos + i];
+                    out[i * 2 + 1] = outRight[mOutBufPos + i];
+                }
+            }
+            remaingFrames -= frames;
+            mInOutBuf -= frames;
+            mOutBufPos += frames;
+            outFrames += frames;
+        }
+
+        while (remaingFrames) {
+            AudioHardware::BufferProvider::Buffer buf;
+            buf.frameCount = mFrameCount - mInInBuf;
+            int ret = mProvider->getNextBuffer(&buf);
+            if (buf.raw == NULL) {
+                *outFrameCount = outFrames;
+                return ret;
+            }
+
+            for (size_t i = 0; i < buf.frameCount; ++i) {
+                mInLeft[i + mInInBuf] = buf.i16[i];
+            }
+            if (mChannelCount == 2) {
+                for (size_t i = 0; i < buf.frameCount; ++i) {
+                    mInLeft[i + mInInBuf] = buf.i16[i * 2];
+                    mInRight[i + mInInBuf] = buf.i16[i * 2 + 1];
+                }
+            }
+            mInInBuf += buf.frameCount;
+            mProvider->releaseBuffer(&buf);
+
+            /* 44010 -> 22050 */
+            {
+                int samples_in_left = mInInBuf;
+                int samples_out_left;
+                legacy_resample_2_1(mInLeft, mTmpLeft + mInTmpBuf, &samples_in_left,
+                                    &samples_out_left);
+
+                if (mChannelCount == 2) {
+                    int samples_in_right = mInInBuf;
+                    int samples_out_right;
+                    legacy_resample_2_1(mInRight, mTmpRight + mInTmpBuf, &samples_in_right,
+                                        &samples_out_right);
+                }
+
+                mInInBuf = samples_in_left;
+                mInTmpBuf += samples_out_left;
+                mInOutBuf = samples_out_left;
+            }
+
+            if (mSampleRate == 11025 || mSampleRate == 8000) {
+                /* 22050 - > 11025 */
+                int samples_in_left = mInTmpBuf;
+                int samples_out_left;
+                legacy_resample_2_1(mTmpLeft, mTmp2Left + mInTmp2Buf, &samples_in_left,
+                                    &samples_out_left);
+
+                if (mChannelCount == 2) {
+                    int samples_in_right = mInTmpBuf;
+                    int samples_out_right;
+                    legacy_resample_2_1(mTmpRight, mTmp2Right + mInTmp2Buf, &samples_in_right,
+                                        &samples_out_right);
+                }
+
+                mInTmpBuf = samples_in_left;
+                mInTmp2Buf += samples_out_left;
+                mInOutBuf = samples_out_left;
+
+                if (mSampleRate == 8000) {
+                    /* 11025 -> 8000*/
+                    int samples_in_left = mInTmp2Buf;
+                    int samples_out_left;
+                    legacy_resample_441_320(mTmp2Left, mOutLeft, &samples_in_left,
+                                            &samples_out_left);
+
+                    if (mChannelCount == 2) {
+                        int samples_in_right = mInTmp2Buf;
+                        int samples_out_right;
+                        legacy_resample_441_320(mTmp2Right, mOutRight, &samples_in_right,
+                                                &samples_out_right);
+                    }
+
+                    mInTmp2Buf = samples_in_left;
+                    mInOutBuf = samples_out_left;
+                } else {
+                    mInTmp2Buf = 0;
+                }
+
+            } else if (mSampleRate == 16000) {
+                /* 22050 -> 16000*/
+                int samples_in_left = mInTmpBuf;
+                int samples_out_left;
+                legacy_resample_441_320(mTmpLeft, mTmp2Left, &samples_in_left,
+                                        &samples_out_left);
+
+                if (mChannelCount == 2) {
+                    int samples_in_right = mInTmpBuf;
+                    int samples_out_right;
+                    legacy_resample_441_320(mTmpRight, mTmp2Right, &samples_in_right,
+                                            &samples_out_right);
+                }
+
+                mInTmpBuf = samples_in_left;
+                mInOutBuf = samples_out_left;
+            } else {
+                mInTmpBuf = 0;
+            }
+
+            int frames = (remaingFrames > mInOutBuf) ? mInOutBuf : remaingFrames;
+
+            for (int i = 0; i < frames; ++i) {
+                out[outFrames + i] = outLeft[i];
+            }
+            if (mChannelCount == 2) {
+                for (int i = 0; i < frames; ++i) {
+                    out[(outFrames + i) * 2] = outLeft[i];
+                    out[(outFrames + i) * 2 + 1] = outRight[i];
+                }
+            }
+            remaingFrames -= frames;
+            outFrames += frames;
+            mOutBufPos = frames;
+            mInOutBuf -= frames;
+        }
+
+        return 0;
+    }
+
+private:
+    AudioHardware::BufferProvider* mProvider;
+    uint32_t mSampleRate;
+    uint32_t mChannelCount;
+    uint32_t mFrameCount;
+    int16_t *mInLeft;
+    int16_t *mInRight;
+    int16_t *mTmpLeft;
+    int16_t *mTmpRight;
+    int16_t *mTmp2Left;
+    int16_t *mTmp2Right;
+    int16_t *mOutLeft;
+    int16_t *mOutRight;
+    int mInInBuf;
+    int mInTmpBuf;
+    int mInTmp2Buf;
+    int mOutBufPos;
+    int mInOutBuf;
+};
+
+/*
+ * The stages the input stream built with the legacy chain: the channel
+ * mixer feeding the DownSampler for a mono input.
+ */
+class LegacyCaptureChain {
+public:
+    LegacyCaptureChain(uint32_t rate, uint32_t channels,
+                       AudioHardware::BufferProvider *source)
+        : mMixer(NULL) {
+        if (channels != 2) {
+            mMixer = new AudioHardware::ChannelMixer(channels, 2,
+                                                     AUDIO_HW_IN_PERIOD_SZ, source);
+            source = mMixer;
+        }
+        mDownSampler = new LegacyDownSampler(rate, channels, AUDIO_HW_IN_PERIOD_SZ, source);
+    }
+
+    ~LegacyCaptureChain() {
+        delete mDownSampler;
+        delete mMixer;
+    }
+
+    int read(int16_t *out, size_t *frames) {
+        return mDownSampler->resample(out, frames);
+    }
+
+private:
+    AudioHardware::ChannelMixer *mMixer;
+    LegacyDownSampler *mDownSampler;
+};
+
+}; // namespace android
+
+#endif // ANDROID_AUDIO_LEGACY_DOWNSAMPLER_H